@@ -50,6 +50,7 @@ SOFTWARE.
 #include <algorithm/evaluation/ReprojError.h>
 
 #include <userinput/ClickSkelNode.h>
+#include <userinput/AutoSkelNode.h>
 #include <fileio/CameraFile.h>
 #include <fileio/BoundaryFile.h>
 #include <fileio/RecSkelFile.h>
@@ -63,7 +64,9 @@ void ReconstructionEvals(algorithm::matchskeletons::OptionsMatch &optionsmatch,
 						 const skeleton::ReconstructionSkeleton::Ptr recskel,
 						 const std::vector<camera::Camera::Ptr> &veccam,
 						 const std::vector<shape::DiscreteShape<2>::Ptr> &vecshape,
-						 const double lambda)
+						 const double lambda,
+						 const double fittol,
+						 const double fitsizetol)
 {
 	std::vector<typename skeleton::CompGraphProjSkel::Ptr> vec_comppr = algorithm::graphoperation::GetComposed(recskel,vec_prskel);
 	
@@ -71,7 +74,10 @@ void ReconstructionEvals(algorithm::matchskeletons::OptionsMatch &optionsmatch,
 	
 	for(unsigned int i = 0; i < vec_comppr.size(); i++)
 	{
-		vec_compcontpr[i] = algorithm::fitbspline::Graph2Bspline(vec_comppr[i]);
+		if(fittol > 0.0)
+			vec_compcontpr[i] = algorithm::fitbspline::Graph2BsplineAdaptive(vec_comppr[i],fittol,fitsizetol > 0.0 ? fitsizetol : fittol);
+		else
+			vec_compcontpr[i] = algorithm::fitbspline::Graph2Bspline(vec_comppr[i]);
 	}
 
 	algorithm::matchskeletons::OptionsMatch2 optionsmatch2;
@@ -146,7 +152,10 @@ int main(int argc, char** argv)
 	std::string extskelfile;
 	double sat;
 	double lambda;
+	double fittol;
+	double fitsizetol;
 	unsigned int nbimg;
+	bool autoext;
 	
 	boost::program_options::options_description desc("OPTIONS");
 	
@@ -158,8 +167,11 @@ int main(int argc, char** argv)
 		("camfile", boost::program_options::value<std::string>(&camfile)->default_value("cam"), "Camera file (*.xml)")
 		("recskelfile", boost::program_options::value<std::string>(&recskelfile)->default_value("recskel.txt"), "Reconstruction Skeleton file")
 		("extskelfile", boost::program_options::value<std::string>(&extskelfile)->default_value("extskel.txt"), "Extremities Skeleton file")
+		("autoext", boost::program_options::bool_switch(&autoext), "Associate extremities automatically, instead of clicking them")
 		("sat", boost::program_options::value<double>(&sat)->default_value(1.2), "Scale Axis Transform parameter")
 		("lambda", boost::program_options::value<double>(&lambda)->default_value(0.2), "Lambda parameter")
+		("fittol", boost::program_options::value<double>(&fittol)->default_value(0.0), "Center tolerance of the adaptive bspline fitting (0: fixed proportion of control points)")
+		("fitsizetol", boost::program_options::value<double>(&fitsizetol)->default_value(0.0), "Size tolerance of the adaptive bspline fitting (0: same as fittol)")
 		;
 	
 	boost::program_options::variables_map vm;
@@ -224,7 +236,11 @@ int main(int argc, char** argv)
 	std::cout << "~ Clicked skeleton reconstruction ~" << std::endl;
 	skeleton::ReconstructionSkeleton::Ptr recskelclick = fileio::ReadRecSkel(recskelfile);
 
-	if(!recskelclick)
+	if(!recskelclick && autoext)
+	{
+		std::cout << "No clicked skeleton, skipped" << std::endl;
+	}
+	else if(!recskelclick)
 	{
 		for(unsigned int i = 0; i < nbimg; i++)
 		{
@@ -265,7 +281,8 @@ int main(int argc, char** argv)
 		fileio::WriteRecSkel(recskelclick,recskelfile);
 	}
 	
-	ReconstructionEvals(optionsmatch,vecprskel,recskelclick,veccam,vecshape,lambda);
+	if(recskelclick)
+		ReconstructionEvals(optionsmatch,vecprskel,recskelclick,veccam,vecshape,lambda,fittol,fitsizetol);
 	std::cout << "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~" << std::endl;
 
 	/********************************************************************************************
@@ -275,6 +292,13 @@ int main(int argc, char** argv)
 	std::cout << std::endl << "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~" << std::endl;
 	std::cout << "~       Topologic matching        ~" << std::endl;
 
+	if(assoc_ext.size() == 0 && autoext)
+	{
+		assoc_ext = userinput::AutoSkelExtremities(vecprskel,extskelfile);
+		if(assoc_ext.size() == 0)
+			return -1;
+	}
+	
 	if(assoc_ext.size() == 0)
 	{
 		for(unsigned int i = 0; i < nbimg; i++)
@@ -302,7 +326,7 @@ int main(int argc, char** argv)
 	
 	skeleton::ReconstructionSkeleton::Ptr recskeltopo = algorithm::graphoperation::TopoMatch(vecprskel,assoc_ext);
 	
-	ReconstructionEvals(optionsmatch,vecprskel,recskeltopo,veccam,vecshape,lambda);
+	ReconstructionEvals(optionsmatch,vecprskel,recskeltopo,veccam,vecshape,lambda,fittol,fitsizetol);
 	std::cout << "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~" << std::endl;
 
 	return 0;
@@ -66,3 +66,20 @@ Eigen::Matrix<double,1,Eigen::Dynamic> algorithm::fitbspline::ComputeNodeVec(con
 	return vec_nod;
 }
 
+Eigen::Matrix<double,1,Eigen::Dynamic> algorithm::fitbspline::ComputeNodeVec(const std::vector<double> &knots, double first, double last, unsigned int degree)
+{
+	Eigen::Matrix<double,1,Eigen::Dynamic> vec_nod(1,knots.size() + 2*degree);
+
+	for(unsigned int i=0; i<degree; i++)
+	{
+		vec_nod(0,i) = first;
+		vec_nod(0,vec_nod.cols()-1-i) = last;
+	}
+
+	for(unsigned int i = 0; i<knots.size(); i++)
+	{
+		vec_nod(0,degree+i) = knots[i];
+	}
+
+	return vec_nod;
+}
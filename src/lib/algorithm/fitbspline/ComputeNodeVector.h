@@ -108,6 +108,18 @@ namespace algorithm
 		 *  \return node vector associated to control points
 		 */
 		Eigen::Matrix<double,1,Eigen::Dynamic> ComputeNodeVec(const Eigen::Matrix<double,1,Eigen::Dynamic> &vec_approxnod, const unsigned int &degree, const unsigned int &nb_ctr_pt);
+
+		/**
+		 *  \brief Computes node vector from interior knots
+		 *
+		 *  \param knots  sorted interior knots
+		 *  \param first  first parameter
+		 *  \param last   last parameter
+		 *  \param degree bspline degree
+		 *
+		 *  \return node vector, with first and last parameters repeated degree times
+		 */
+		Eigen::Matrix<double,1,Eigen::Dynamic> ComputeNodeVec(const std::vector<double> &knots, double first, double last, unsigned int degree);
 	}
 }
 
@@ -32,10 +32,14 @@ SOFTWARE.
 
 #include <Eigen/Dense>
 #include <vector>
+#include <algorithm>
+#include <cmath>
 
 #include <mathtools/application/Bspline.h>
 #include <mathtools/application/BsplineUtils.h>
 
+#include "ComputeNodeVector.h"
+
 /**
  *  \brief Lots of algorithms
  */
@@ -46,6 +50,115 @@ namespace algorithm
 	 */
 	namespace fitbspline
 	{
+		/**
+		 *  \brief Least squares solution of a banded system, by Givens rotations
+		 *
+		 *  \tparam Dim : Right hand side dimension
+		 *
+		 *  \param band_mat  : Band of the system: row i holds the coefficients of columns first_col[i] to first_col[i]+band_mat.cols()-1
+		 *  \param first_col : First column of the band of each row
+		 *  \param rhs       : Right hand sides
+		 *  \param nb_cols   : Number of unknowns
+		 *
+		 *  \return Least squares solution
+		 *
+		 *  \details Rows are accumulated in a banded triangular matrix by increasing first column,
+		 *           which costs O(rows * width^2) time and O((rows + cols) * width) memory.
+		 *           A rank deficient system (a null pivot) is solved by a dense column pivoting QR instead.
+		 */
+		template<unsigned int Dim>
+		Eigen::Matrix<double,Eigen::Dynamic,Dim> BandedLeastSquares(const Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> &band_mat,
+				const std::vector<unsigned int> &first_col,
+				const Eigen::Matrix<double,Eigen::Dynamic,Dim> &rhs,
+				unsigned int nb_cols)
+		{
+			unsigned int nb_rows = band_mat.rows();
+			unsigned int width = band_mat.cols();
+
+			// rows sorted by first column (counting sort), so that rotations do not fill the band
+			std::vector<unsigned int> offset(nb_cols+2,0);
+			for(unsigned int i = 0; i < nb_rows; i++)
+				offset[std::min(first_col[i],nb_cols)+1]++;
+			for(unsigned int j = 0; j <= nb_cols; j++)
+				offset[j+1] += offset[j];
+			std::vector<unsigned int> order(nb_rows);
+			for(unsigned int i = 0; i < nb_rows; i++)
+				order[offset[std::min(first_col[i],nb_cols)]++] = i;
+
+			// triangular band: r_mat(j,l) is the coefficient of column j+l in row j
+			Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> r_mat = Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic>::Zero(nb_cols,width);
+			Eigen::Matrix<double,Eigen::Dynamic,Dim> r_rhs = Eigen::Matrix<double,Eigen::Dynamic,Dim>::Zero(nb_cols,Dim);
+
+			Eigen::Matrix<double,1,Eigen::Dynamic> row(1,width);
+			Eigen::Matrix<double,1,Dim> row_rhs;
+			for(unsigned int k = 0; k < nb_rows; k++)
+			{
+				unsigned int i = order[k];
+				row = band_mat.row(i);
+				row_rhs = rhs.row(i);
+
+				for(unsigned int j = first_col[i]; j < nb_cols && !row.isZero(0.0); j++)
+				{
+					if(row(0,0) != 0.0)
+					{
+						if(r_mat(j,0) == 0.0)
+						{
+							// empty row of the triangular matrix
+							r_mat.row(j) = row;
+							r_rhs.row(j) = row_rhs;
+							break;
+						}
+
+						double rad = std::hypot(r_mat(j,0),row(0,0));
+						double c = r_mat(j,0)/rad;
+						double s = row(0,0)/rad;
+
+						Eigen::Matrix<double,1,Eigen::Dynamic> r_row = r_mat.row(j);
+						r_mat.row(j) = c*r_row + s*row;
+						row = c*row - s*r_row;
+
+						Eigen::Matrix<double,1,Dim> r_row_rhs = r_rhs.row(j);
+						r_rhs.row(j) = c*r_row_rhs + s*row_rhs;
+						row_rhs = c*row_rhs - s*r_row_rhs;
+					}
+
+					// the row now starts at column j+1
+					for(unsigned int l = 0; l+1 < width; l++)
+						row(0,l) = row(0,l+1);
+					row(0,width-1) = 0.0;
+				}
+			}
+
+			// a column without any row (no vector in the support of its basis function) leaves a null pivot:
+			// the rank deficient system is solved by the dense column pivoting QR, which keeps the solution finite
+			double tol = 1e-12;
+			if(r_mat.size() != 0)
+				tol *= std::max(r_mat.cwiseAbs().maxCoeff(),1.0);
+			for(unsigned int j = 0; j < nb_cols; j++)
+			{
+				if(std::abs(r_mat(j,0)) <= tol)
+				{
+					Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> dense_mat = Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic>::Zero(nb_rows,nb_cols);
+					for(unsigned int i = 0; i < nb_rows; i++)
+						for(unsigned int l = 0; l < width && first_col[i]+l < nb_cols; l++)
+							dense_mat(i,first_col[i]+l) = band_mat(i,l);
+					return dense_mat.colPivHouseholderQr().solve(rhs);
+				}
+			}
+
+			// back substitution
+			Eigen::Matrix<double,Eigen::Dynamic,Dim> sol(nb_cols,Dim);
+			for(unsigned int j = nb_cols; j-- > 0;)
+			{
+				sol.row(j) = r_rhs.row(j);
+				for(unsigned int l = 1; l < width && j+l < nb_cols; l++)
+					sol.row(j) -= r_mat(j,l)*sol.row(j+l);
+				sol.row(j) /= r_mat(j,0);
+			}
+
+			return sol;
+		}
+
 		/**
 		 *  \brief Fits Bspline from a set of vectors
 		 *  
@@ -57,6 +170,9 @@ namespace algorithm
 		 *  \param degree     : Bspline degree
 		 * 
 		 *  \return Fitted Bspline
+		 *
+		 *  \details The basis matrix is banded (degree+1 non null basis functions per parameter):
+		 *           only its band is assembled, and the fit costs linear time and memory in the number of vectors.
 		 */
 		template<unsigned int Dim>
 		mathtools::application::Bspline<Dim> FitBspline(const std::vector<Eigen::Matrix<double,Dim,1> > &approx_vec, 
@@ -66,33 +182,226 @@ namespace algorithm
 		{
 			unsigned int nb_approx = approx_vec.size();
 			unsigned int nb_nodes = nod_vec.cols()-degree+1;
-			Eigen::Matrix<double,Eigen::Dynamic,Dim> approx_mat(nb_approx,Dim);
-			Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> approx_param(nb_approx,nb_nodes);
 
+			// first and last control points are the first and last vectors, the others are fitted
+			Eigen::Matrix<double,Eigen::Dynamic,Dim> res_mat(nb_approx,Dim);
+			Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> band_mat = Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic>::Zero(nb_approx,degree+1);
+			std::vector<unsigned int> first_col(nb_approx);
+
+			Eigen::Matrix<double,1,Eigen::Dynamic> basis(1,degree+1);
 			for(unsigned int i = 0; i < nb_approx; i++)
 			{
-				approx_mat.template block<1,Dim>(i,0) = approx_vec[i].transpose();
-				for(unsigned int j = 0; j < nb_nodes; j++)
+				int first = (int)mathtools::application::BsplineBasisSpan(approx_nod(0,i),degree,nod_vec,basis) - (int)degree;
+				int beg = std::max(first,1);
+				first_col[i] = beg-1;
+
+				res_mat.template block<1,Dim>(i,0) = approx_vec[i].transpose();
+				for(unsigned int r = 0; r <= degree; r++)
 				{
-					approx_param(i,j) = mathtools::application::BsplineBasis(approx_nod(0,i),degree,j,nod_vec);
+					int ind = first + (int)r;
+					if(ind == 0)
+						res_mat.template block<1,Dim>(i,0) -= basis(0,r)*approx_vec[0].transpose();
+					else if(ind == (int)nb_nodes-1)
+						res_mat.template block<1,Dim>(i,0) -= basis(0,r)*approx_vec[nb_approx-1].transpose();
+					else if(ind > 0 && ind < (int)nb_nodes-1)
+						band_mat(i,ind-beg) = basis(0,r);
 				}
 			}
-			Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> approx_param_block = approx_param.block(0,1,nb_approx,nb_nodes-2);
-			Eigen::Matrix<double,Eigen::Dynamic,Dim> res_mat = approx_mat - approx_param.block(0,0,nb_approx,1)*approx_mat.template block<1,Dim>(0,0)
-				- approx_param.block(0,nb_nodes-1,nb_approx,1)*approx_mat.template block<1,Dim>(nb_approx-1,0);
 
-			Eigen::Matrix<double,Eigen::Dynamic,Dim> ctrl_mat = approx_param_block.householderQr().solve(res_mat);
+			Eigen::Matrix<double,Eigen::Dynamic,Dim> ctrl_mat = BandedLeastSquares<Dim>(band_mat,first_col,res_mat,nb_nodes-2);
 
 			Eigen::Matrix<double,Dim,Eigen::Dynamic> ctrl_vec(Dim,nb_nodes);
-			ctrl_vec.template block<Dim,1>(0,0) = approx_mat.template block<1,Dim>(0,0).transpose();
+			ctrl_vec.template block<Dim,1>(0,0) = approx_vec[0];
 			for(unsigned int i=0;i<nb_nodes-2;i++)
 			{
 				ctrl_vec.template block<Dim,1>(0,i+1) = ctrl_mat.template block<1,Dim>(i,0).transpose();
 			}
-			ctrl_vec.template block<Dim,1>(0,nb_nodes-1) = approx_mat.template block<1,Dim>(nb_approx-1,0).transpose();
+			ctrl_vec.template block<Dim,1>(0,nb_nodes-1) = approx_vec[nb_approx-1];
 
 			return mathtools::application::Bspline<Dim>(ctrl_vec,nod_vec,degree);
 		}
+
+		/**
+		 *  \brief Computes the fitting residuals of a Bspline
+		 *
+		 *  \tparam Dim : Space dimension
+		 *
+		 *  \param bspline    : Fitted Bspline
+		 *  \param approx_vec : Approximated vectors
+		 *  \param approx_nod : Param associated to each vector
+		 *
+		 *  \return distance between each vector and the Bspline at its param
+		 */
+		template<unsigned int Dim>
+		std::vector<double> FitResiduals(const mathtools::application::Bspline<Dim> &bspline,
+				const std::vector<Eigen::Matrix<double,Dim,1> > &approx_vec,
+				const Eigen::Matrix<double,1,Eigen::Dynamic> &approx_nod)
+		{
+			std::vector<double> vec_t(approx_nod.data(),approx_nod.data()+approx_nod.cols());
+			Eigen::Matrix<double,Dim,Eigen::Dynamic> val;
+			bspline.evaluate(vec_t,val);
+
+			std::vector<double> residuals(approx_vec.size());
+			for(unsigned int i = 0; i < approx_vec.size(); i++)
+				residuals[i] = (val.template block<Dim,1>(0,i) - approx_vec[i]).norm();
+
+			return residuals;
+		}
+
+		/**
+		 *  \brief Computes the fitting residuals of a Bspline, relative to position and size tolerances
+		 *
+		 *  \tparam Dim : Space dimension
+		 *
+		 *  \param bspline       : Fitted Bspline
+		 *  \param approx_vec    : Approximated vectors
+		 *  \param approx_nod    : Param associated to each vector
+		 *  \param tolerance     : Tolerance on the distance between the vectors and the Bspline
+		 *  \param sizetolerance : Tolerance on the last coordinate (size), non positive to include it in the distance
+		 *
+		 *  \return residual of each vector, under 1 if it is within the tolerances
+		 */
+		template<unsigned int Dim>
+		std::vector<double> FitRelativeResiduals(const mathtools::application::Bspline<Dim> &bspline,
+				const std::vector<Eigen::Matrix<double,Dim,1> > &approx_vec,
+				const Eigen::Matrix<double,1,Eigen::Dynamic> &approx_nod,
+				double tolerance,
+				double sizetolerance)
+		{
+			std::vector<double> vec_t(approx_nod.data(),approx_nod.data()+approx_nod.cols());
+			Eigen::Matrix<double,Dim,Eigen::Dynamic> val;
+			bspline.evaluate(vec_t,val);
+
+			std::vector<double> residuals(approx_vec.size());
+			for(unsigned int i = 0; i < approx_vec.size(); i++)
+			{
+				Eigen::Matrix<double,Dim,1> diff = val.template block<Dim,1>(0,i) - approx_vec[i];
+				if(sizetolerance > 0.0)
+					residuals[i] = std::max(diff.template block<Dim-1,1>(0,0).norm()/tolerance, fabs(diff(Dim-1))/sizetolerance);
+				else
+					residuals[i] = diff.norm()/tolerance;
+			}
+
+			return residuals;
+		}
+
+		/**
+		 *  \brief Fits Bspline from a set of vectors, with adaptive knot placement
+		 *
+		 *  \tparam Dim : Space dimension
+		 *
+		 *  \param approx_vec    : Vectors to approximate
+		 *  \param approx_nod    : Param associated to each vector (sorted)
+		 *  \param degree        : Bspline degree
+		 *  \param tolerance     : Maximal distance between the vectors and the Bspline
+		 *  \param sizetolerance : Maximal difference on the last coordinate (size of the skeleton nodes),
+		 *                         non positive to include it in the distance
+		 *
+		 *  \return Fitted Bspline
+		 *
+		 *  \details The fit starts without interior knot. Knot spans where the residual exceeds the tolerances
+		 *           are split at their median param, as long as both halves keep degree+1 vectors.
+		 *           Then, knots are removed while the residual stays under the tolerances: each removal is
+		 *           tried on the vectors of the degree+1 spans around the knot only, so that the whole vectors
+		 *           are fitted once after the coarsening, and refined again where this fit exceeds the tolerances.
+		 *           The window fits pin the end vectors of the window as control points, unlike the global fit,
+		 *           so the removals are approximate, and only the final refinement guarantees the tolerances.
+		 */
+		template<unsigned int Dim>
+		mathtools::application::Bspline<Dim> FitBsplineAdaptive(const std::vector<Eigen::Matrix<double,Dim,1> > &approx_vec,
+				const Eigen::Matrix<double,1,Eigen::Dynamic> &approx_nod,
+				unsigned int degree,
+				double tolerance,
+				double sizetolerance = 0.0)
+		{
+			unsigned int nb_approx = approx_vec.size();
+			double first = approx_nod(0,0);
+			double last = approx_nod(0,nb_approx-1);
+
+			std::vector<double> knots(0);
+			mathtools::application::Bspline<Dim> bspline = FitBspline<Dim>(approx_vec,approx_nod,ComputeNodeVec(knots,first,last,degree),degree);
+
+			// refinement, then coarsening, then refinement of the coarsened knots where the tolerances are exceeded
+			bool coarsened = false;
+			while(true)
+			{
+				double maxres;
+				while(true)
+				{
+					std::vector<double> residuals = FitRelativeResiduals<Dim>(bspline,approx_vec,approx_nod,tolerance,sizetolerance);
+					maxres = 0.0;
+
+					std::vector<double> newknots(0);
+					unsigned int beg = 0;
+					for(unsigned int j = 0; j <= knots.size(); j++)
+					{
+						// vectors whose param is in span j
+						unsigned int end = beg;
+						double spanres = 0.0;
+						while(end < nb_approx && (j == knots.size() || approx_nod(0,end) < knots[j]))
+						{
+							spanres = std::max(spanres,residuals[end]);
+							end++;
+						}
+						maxres = std::max(maxres,spanres);
+
+						unsigned int mid = (beg+end)/2;
+						if(spanres > 1.0 && mid-beg >= degree+1 && end-mid >= degree+1 && approx_nod(0,mid-1) < approx_nod(0,mid))
+							newknots.push_back(0.5*(approx_nod(0,mid-1) + approx_nod(0,mid)));
+
+						beg = end;
+					}
+
+					if(newknots.size() == 0)
+						break;
+
+					knots.insert(knots.end(),newknots.begin(),newknots.end());
+					std::sort(knots.begin(),knots.end());
+					bspline = FitBspline<Dim>(approx_vec,approx_nod,ComputeNodeVec(knots,first,last,degree),degree);
+				}
+
+				if(coarsened || maxres > 1.0 || knots.size() == 0)
+					break;
+
+				// coarsening, each removal being tried on the vectors of the degree+1 spans around the knot
+				unsigned int nb_knots = knots.size();
+				const double *nod_beg = approx_nod.data();
+				const double *nod_end = approx_nod.data()+nb_approx;
+				for(unsigned int j = 0; j < knots.size();)
+				{
+					bool firstspan = j <= degree;
+					bool lastspan = j+degree+1 >= knots.size();
+					unsigned int beg = firstspan ? 0 : std::lower_bound(nod_beg,nod_end,knots[j-degree-1]) - nod_beg;
+					unsigned int end = lastspan ? nb_approx : std::lower_bound(nod_beg,nod_end,knots[j+degree+1]) - nod_beg;
+
+					std::vector<double> trial(0);
+					for(unsigned int k = firstspan ? 0 : j-degree; k < (lastspan ? knots.size() : j+degree+1); k++)
+						if(k != j)
+							trial.push_back(knots[k]);
+
+					// approximation: the window fit passes through the first and last vectors of the window, while the global
+					// fit does not, so a removal is judged on a slightly different problem than the one finally solved
+					// (the refinement after the coarsening puts back knots where the global fit exceeds the tolerances)
+					std::vector<Eigen::Matrix<double,Dim,1> > win_vec(approx_vec.begin()+beg,approx_vec.begin()+end);
+					Eigen::Matrix<double,1,Eigen::Dynamic> win_nod = approx_nod.block(0,beg,1,end-beg);
+					mathtools::application::Bspline<Dim> trialfit = FitBspline<Dim>(win_vec,win_nod,ComputeNodeVec(trial,win_nod(0,0),win_nod(0,end-beg-1),degree),degree);
+					std::vector<double> residuals = FitRelativeResiduals<Dim>(trialfit,win_vec,win_nod,tolerance,sizetolerance);
+
+					if(*std::max_element(residuals.begin(),residuals.end()) <= 1.0)
+						knots.erase(knots.begin()+j);
+					else
+						j++;
+				}
+
+				if(knots.size() == nb_knots)
+					break;
+
+				coarsened = true;
+				bspline = FitBspline<Dim>(approx_vec,approx_nod,ComputeNodeVec(knots,first,last,degree),degree);
+			}
+
+			return bspline;
+		}
 	}
 }
 
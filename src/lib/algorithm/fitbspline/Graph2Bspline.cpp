@@ -33,8 +33,13 @@ SOFTWARE.
 #include "ComputeNodeVector.h"
 
 
+/*
+ *  A positive tolerance selects the adaptive fitting, propctrl is then unused
+ *  (the centers and the sizes of the nodes have their own tolerance)
+ *  The fitted branch is frozen, so that skinning and matching evaluate its piecewise polynomial form
+ */
 template<typename Model>
-typename skeleton::ContinuousBranch<Model>::Ptr Graph2Bspline_helper(const typename skeleton::GraphBranch<Model>::Ptr grskel, unsigned int degree, double propctrl)
+typename skeleton::ContinuousBranch<Model>::Ptr Graph2Bspline_helper(const typename skeleton::GraphBranch<Model>::Ptr grskel, unsigned int degree, double propctrl, double tolerance, double sizetolerance)
 {
 	typename mathtools::application::Application<typename Model::Stor,double>::Ptr bspline;
 	std::vector<typename Model::Stor> nodes(0);
@@ -58,30 +63,42 @@ typename skeleton::ContinuousBranch<Model>::Ptr Graph2Bspline_helper(const typen
 	{
 		Eigen::Matrix<double,1,Eigen::Dynamic> vec_approx_nod = algorithm::fitbspline::ComputeApproxNodeVec<skeleton::model::meta<Model>::stordim>(nodes);
 
-		unsigned int nb_ctrl = propctrl*nodes.size();
-
 		unsigned int curv_degree = algorithm::fitbspline::MaxDegree(nodes.size());
 		curv_degree = curv_degree<degree?curv_degree:degree;
 
-		unsigned int max_nbctrl = algorithm::fitbspline::MaxCtrlPts(nodes.size(),curv_degree);
-		nb_ctrl = max_nbctrl<nb_ctrl?max_nbctrl:nb_ctrl;
+		if(tolerance > 0.0)
+		{
+			bspline = typename mathtools::application::Application<typename Model::Stor,double>::Ptr(
+					new mathtools::application::Bspline<skeleton::model::meta<Model>::stordim>(
+						algorithm::fitbspline::FitBsplineAdaptive<skeleton::model::meta<Model>::stordim>(nodes,vec_approx_nod,curv_degree,tolerance,sizetolerance)));
+		}
+		else
+		{
+			unsigned int nb_ctrl = propctrl*nodes.size();
 
-		unsigned int min_nbctrl = algorithm::fitbspline::MinCtrlPts(curv_degree);
-		nb_ctrl = min_nbctrl>nb_ctrl?min_nbctrl:nb_ctrl;
+			unsigned int max_nbctrl = algorithm::fitbspline::MaxCtrlPts(nodes.size(),curv_degree);
+			nb_ctrl = max_nbctrl<nb_ctrl?max_nbctrl:nb_ctrl;
 
-		Eigen::Matrix<double,1,Eigen::Dynamic> vec_nod = algorithm::fitbspline::ComputeNodeVec(vec_approx_nod,curv_degree,nb_ctrl);
+			unsigned int min_nbctrl = algorithm::fitbspline::MinCtrlPts(curv_degree);
+			nb_ctrl = min_nbctrl>nb_ctrl?min_nbctrl:nb_ctrl;
 
-		bspline = typename mathtools::application::Application<typename Model::Stor,double>::Ptr(
-				new mathtools::application::Bspline<skeleton::model::meta<Model>::stordim>(
-					algorithm::fitbspline::FitBspline<skeleton::model::meta<Model>::stordim>(nodes,vec_approx_nod,vec_nod,curv_degree)));
+			Eigen::Matrix<double,1,Eigen::Dynamic> vec_nod = algorithm::fitbspline::ComputeNodeVec(vec_approx_nod,curv_degree,nb_ctrl);
+
+			bspline = typename mathtools::application::Application<typename Model::Stor,double>::Ptr(
+					new mathtools::application::Bspline<skeleton::model::meta<Model>::stordim>(
+						algorithm::fitbspline::FitBspline<skeleton::model::meta<Model>::stordim>(nodes,vec_approx_nod,vec_nod,curv_degree)));
+		}
 	}
 
-	return typename skeleton::ContinuousBranch<Model>::Ptr(new skeleton::ContinuousBranch<Model>(grskel->getModel(),bspline));
+	typename skeleton::ContinuousBranch<Model>::Ptr contbr(new skeleton::ContinuousBranch<Model>(grskel->getModel(),bspline));
+	contbr->freeze();
+
+	return contbr;
 }
 
 template<typename Model>
 typename skeleton::ComposedCurveSkeleton<skeleton::ContinuousBranch<Model> >::Ptr Graph2Bspline_helper(
-		const typename skeleton::ComposedCurveSkeleton<skeleton::GraphBranch<Model> >::Ptr grskel, unsigned int degree, double propctrl)
+		const typename skeleton::ComposedCurveSkeleton<skeleton::GraphBranch<Model> >::Ptr grskel, unsigned int degree, double propctrl, double tolerance, double sizetolerance)
 {
 	typename skeleton::ComposedCurveSkeleton<skeleton::ContinuousBranch<Model> >::Ptr 
 		contskl(new typename skeleton::ComposedCurveSkeleton<skeleton::ContinuousBranch<Model> >());
@@ -99,7 +116,7 @@ typename skeleton::ComposedCurveSkeleton<skeleton::ContinuousBranch<Model> >::Pt
 	{
 		std::pair<unsigned int,unsigned int> ext = grskel->getExtremities(edge[i]);
 
-		typename skeleton::ContinuousBranch<Model>::Ptr br = Graph2Bspline_helper<Model>(grskel->getBranch(ext.first,ext.second),degree,propctrl);
+		typename skeleton::ContinuousBranch<Model>::Ptr br = Graph2Bspline_helper<Model>(grskel->getBranch(ext.first,ext.second),degree,propctrl,tolerance,sizetolerance);
 		
 		contskl->addEdge(ext.first,ext.second,br);
 	}
@@ -109,32 +126,62 @@ typename skeleton::ComposedCurveSkeleton<skeleton::ContinuousBranch<Model> >::Pt
 
 skeleton::BranchContSkel2d::Ptr algorithm::fitbspline::Graph2Bspline(const skeleton::BranchGraphSkel2d::Ptr grskel, unsigned int degree, double propctrl)
 {
-	return Graph2Bspline_helper<skeleton::model::Classic<2> >(grskel,degree,propctrl);
+	return Graph2Bspline_helper<skeleton::model::Classic<2> >(grskel,degree,propctrl,0.0,0.0);
 }
 
 skeleton::CompContSkel2d::Ptr algorithm::fitbspline::Graph2Bspline(const skeleton::CompGraphSkel2d::Ptr grskel, unsigned int degree, double propctrl)
 {
-	return Graph2Bspline_helper<skeleton::model::Classic<2> >(grskel,degree,propctrl);
+	return Graph2Bspline_helper<skeleton::model::Classic<2> >(grskel,degree,propctrl,0.0,0.0);
 }
 
 
 skeleton::BranchContSkel3d::Ptr algorithm::fitbspline::Graph2Bspline(const skeleton::BranchGraphSkel3d::Ptr grskel, unsigned int degree, double propctrl)
 {
-	return Graph2Bspline_helper<skeleton::model::Classic<3> >(grskel,degree,propctrl);
+	return Graph2Bspline_helper<skeleton::model::Classic<3> >(grskel,degree,propctrl,0.0,0.0);
 }
 
 skeleton::CompContSkel3d::Ptr algorithm::fitbspline::Graph2Bspline(const skeleton::CompGraphSkel3d::Ptr grskel, unsigned int degree, double propctrl)
 {
-	return Graph2Bspline_helper<skeleton::model::Classic<3> >(grskel,degree,propctrl);
+	return Graph2Bspline_helper<skeleton::model::Classic<3> >(grskel,degree,propctrl,0.0,0.0);
 }
 
 
 skeleton::BranchContProjSkel::Ptr algorithm::fitbspline::Graph2Bspline(const skeleton::BranchGraphProjSkel::Ptr grskel, unsigned int degree, double propctrl)
 {
-	return Graph2Bspline_helper<skeleton::model::Projective>(grskel,degree,propctrl);
+	return Graph2Bspline_helper<skeleton::model::Projective>(grskel,degree,propctrl,0.0,0.0);
 }
 
 skeleton::CompContProjSkel::Ptr algorithm::fitbspline::Graph2Bspline(const skeleton::CompGraphProjSkel::Ptr grskel, unsigned int degree, double propctrl)
 {
-	return Graph2Bspline_helper<skeleton::model::Projective>(grskel,degree,propctrl);
+	return Graph2Bspline_helper<skeleton::model::Projective>(grskel,degree,propctrl,0.0,0.0);
+}
+
+skeleton::BranchContSkel2d::Ptr algorithm::fitbspline::Graph2BsplineAdaptive(const skeleton::BranchGraphSkel2d::Ptr grskel, double tolerance, double sizetolerance, unsigned int degree)
+{
+	return Graph2Bspline_helper<skeleton::model::Classic<2> >(grskel,degree,0.0,tolerance,sizetolerance);
+}
+
+skeleton::CompContSkel2d::Ptr algorithm::fitbspline::Graph2BsplineAdaptive(const skeleton::CompGraphSkel2d::Ptr grskel, double tolerance, double sizetolerance, unsigned int degree)
+{
+	return Graph2Bspline_helper<skeleton::model::Classic<2> >(grskel,degree,0.0,tolerance,sizetolerance);
+}
+
+skeleton::BranchContSkel3d::Ptr algorithm::fitbspline::Graph2BsplineAdaptive(const skeleton::BranchGraphSkel3d::Ptr grskel, double tolerance, double sizetolerance, unsigned int degree)
+{
+	return Graph2Bspline_helper<skeleton::model::Classic<3> >(grskel,degree,0.0,tolerance,sizetolerance);
+}
+
+skeleton::CompContSkel3d::Ptr algorithm::fitbspline::Graph2BsplineAdaptive(const skeleton::CompGraphSkel3d::Ptr grskel, double tolerance, double sizetolerance, unsigned int degree)
+{
+	return Graph2Bspline_helper<skeleton::model::Classic<3> >(grskel,degree,0.0,tolerance,sizetolerance);
+}
+
+skeleton::BranchContProjSkel::Ptr algorithm::fitbspline::Graph2BsplineAdaptive(const skeleton::BranchGraphProjSkel::Ptr grskel, double tolerance, double sizetolerance, unsigned int degree)
+{
+	return Graph2Bspline_helper<skeleton::model::Projective>(grskel,degree,0.0,tolerance,sizetolerance);
+}
+
+skeleton::CompContProjSkel::Ptr algorithm::fitbspline::Graph2BsplineAdaptive(const skeleton::CompGraphProjSkel::Ptr grskel, double tolerance, double sizetolerance, unsigned int degree)
+{
+	return Graph2Bspline_helper<skeleton::model::Projective>(grskel,degree,0.0,tolerance,sizetolerance);
 }
@@ -45,7 +45,7 @@ namespace algorithm
 		/**
 		 *  \brief Converts a graph branch to a bspline continuous branch
 		 *
-		 *  \param grbr     graph branch to convert
+		 *  \param grskel   graph branch to convert
 		 *  \param degree   bspline degree
 		 *  \param propctrl control points proportion to keep
 		 *
@@ -68,7 +68,7 @@ namespace algorithm
 		/**
 		 *  \brief Converts a graph branch to a bspline continuous branch
 		 *
-		 *  \param grbr     graph branch to convert
+		 *  \param grskel   graph branch to convert
 		 *  \param degree   bspline degree
 		 *  \param propctrl control points proportion to keep
 		 *
@@ -91,7 +91,7 @@ namespace algorithm
 		/**
 		 *  \brief Converts a graph branch to a bspline continuous branch
 		 *
-		 *  \param grbr     graph branch to convert
+		 *  \param grskel   graph branch to convert
 		 *  \param degree   bspline degree
 		 *  \param propctrl control points proportion to keep
 		 *
@@ -109,6 +109,78 @@ namespace algorithm
 		 *  \return pointer to bspline continuous skeleton
 		 */
 		skeleton::CompContProjSkel::Ptr Graph2Bspline(const skeleton::CompGraphProjSkel::Ptr grskel, unsigned int degree = 3, double propctrl = 0.1);
+
+		/**
+		 *  \brief Converts a graph branch to a bspline continuous branch, with adaptive knot placement
+		 *
+		 *  \param grskel        graph branch to convert
+		 *  \param tolerance     maximal distance between the branch node centers and the bspline
+		 *  \param sizetolerance maximal difference between the branch node sizes and the bspline
+		 *  \param degree        bspline degree
+		 *
+		 *  \return pointer to bspline continuous branch
+		 */
+		skeleton::BranchContSkel2d::Ptr Graph2BsplineAdaptive(const skeleton::BranchGraphSkel2d::Ptr grskel, double tolerance, double sizetolerance, unsigned int degree = 3);
+
+		/**
+		 *  \brief Converts a graph skeleton to a bspline continuous skeleton, with adaptive knot placement
+		 *
+		 *  \param grskel        graph skeleton to convert
+		 *  \param tolerance     maximal distance between the branch node centers and the bsplines
+		 *  \param sizetolerance maximal difference between the branch node sizes and the bsplines
+		 *  \param degree        bspline degree
+		 *
+		 *  \return pointer to bspline continuous skeleton
+		 */
+		skeleton::CompContSkel2d::Ptr Graph2BsplineAdaptive(const skeleton::CompGraphSkel2d::Ptr grskel, double tolerance, double sizetolerance, unsigned int degree = 3);
+
+		/**
+		 *  \brief Converts a graph branch to a bspline continuous branch, with adaptive knot placement
+		 *
+		 *  \param grskel        graph branch to convert
+		 *  \param tolerance     maximal distance between the branch node centers and the bspline
+		 *  \param sizetolerance maximal difference between the branch node sizes and the bspline
+		 *  \param degree        bspline degree
+		 *
+		 *  \return pointer to bspline continuous branch
+		 */
+		skeleton::BranchContSkel3d::Ptr Graph2BsplineAdaptive(const skeleton::BranchGraphSkel3d::Ptr grskel, double tolerance, double sizetolerance, unsigned int degree = 3);
+
+		/**
+		 *  \brief Converts a graph skeleton to a bspline continuous skeleton, with adaptive knot placement
+		 *
+		 *  \param grskel        graph skeleton to convert
+		 *  \param tolerance     maximal distance between the branch node centers and the bsplines
+		 *  \param sizetolerance maximal difference between the branch node sizes and the bsplines
+		 *  \param degree        bspline degree
+		 *
+		 *  \return pointer to bspline continuous skeleton
+		 */
+		skeleton::CompContSkel3d::Ptr Graph2BsplineAdaptive(const skeleton::CompGraphSkel3d::Ptr grskel, double tolerance, double sizetolerance, unsigned int degree = 3);
+
+		/**
+		 *  \brief Converts a graph branch to a bspline continuous branch, with adaptive knot placement
+		 *
+		 *  \param grskel        graph branch to convert
+		 *  \param tolerance     maximal distance between the branch node centers and the bspline
+		 *  \param sizetolerance maximal difference between the branch node sizes and the bspline
+		 *  \param degree        bspline degree
+		 *
+		 *  \return pointer to bspline continuous branch
+		 */
+		skeleton::BranchContProjSkel::Ptr Graph2BsplineAdaptive(const skeleton::BranchGraphProjSkel::Ptr grskel, double tolerance, double sizetolerance, unsigned int degree = 3);
+
+		/**
+		 *  \brief Converts a graph skeleton to a bspline continuous skeleton, with adaptive knot placement
+		 *
+		 *  \param grskel        graph skeleton to convert
+		 *  \param tolerance     maximal distance between the branch node centers and the bsplines
+		 *  \param sizetolerance maximal difference between the branch node sizes and the bsplines
+		 *  \param degree        bspline degree
+		 *
+		 *  \return pointer to bspline continuous skeleton
+		 */
+		skeleton::CompContProjSkel::Ptr Graph2BsplineAdaptive(const skeleton::CompGraphProjSkel::Ptr grskel, double tolerance, double sizetolerance, unsigned int degree = 3);
 	}
 }
 
@@ -0,0 +1,319 @@
+/*
+Copyright (c) 2016 Bastien Durix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/**
+ *  \file AssociateExtremities.cpp
+ *  \brief Defines automatic association of skeleton extremities across views
+ *  \author Bastien Durix
+ */
+
+#include "AssociateExtremities.h"
+#include "AssociateSkeletons.h"
+#include "EdgeSignature.h"
+#include <mathtools/geometry/euclidian/Line.h>
+#include <unordered_set>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+/**
+ *  \brief Distance between the 3d lines of two skeleton nodes
+ *
+ *  \details Lines are infinite: with a perspective camera, points behind the camera are not excluded
+ */
+double LineDistance(const mathtools::geometry::euclidian::Line<4> &line1, const mathtools::geometry::euclidian::Line<4> &line2)
+{
+	Eigen::Vector3d ori1 = line1.getOrigin().getCoords().block<3,1>(0,0);
+	Eigen::Vector3d dir1 = line1.getVecDir().block<3,1>(0,0);
+	Eigen::Vector3d ori2 = line2.getOrigin().getCoords().block<3,1>(0,0);
+	Eigen::Vector3d dir2 = line2.getVecDir().block<3,1>(0,0);
+
+	Eigen::Vector3d w0 = ori1 - ori2;
+	double a = dir1.dot(dir1), b = dir1.dot(dir2), c = dir2.dot(dir2),
+		   d = dir1.dot(w0), e = dir2.dot(w0);
+	double den = a*c - b*b;
+
+	double t1 = 0.0, t2 = 0.0;
+	if(den > std::numeric_limits<double>::epsilon()*a*c)
+	{
+		t1 = (b*e - c*d)/den;
+		t2 = (a*e - b*d)/den;
+	}
+	else // parallel lines
+	{
+		t2 = e/c;
+	}
+
+	return ((ori1 + t1*dir1) - (ori2 + t2*dir2)).norm();
+}
+
+/**
+ *  \brief Minimal cost assignment of the rows to distinct columns (Hungarian method, rows <= cols)
+ */
+std::vector<unsigned int> MinAssignment(const Eigen::MatrixXd &cost)
+{
+	unsigned int n = cost.rows(), m = cost.cols();
+	double inf = std::numeric_limits<double>::infinity();
+
+	// potentials, and row matched to each column (indices start at 1, 0 is a virtual column)
+	std::vector<double> u(n+1,0.0), v(m+1,0.0);
+	std::vector<unsigned int> p(m+1,0), way(m+1,0);
+
+	for(unsigned int i = 1; i <= n; i++)
+	{
+		p[0] = i;
+		unsigned int j0 = 0;
+		std::vector<double> minv(m+1,inf);
+		std::vector<bool> used(m+1,false);
+		do
+		{
+			used[j0] = true;
+			unsigned int i0 = p[j0], j1 = 0;
+			double delta = inf;
+			for(unsigned int j = 1; j <= m; j++)
+			{
+				if(!used[j])
+				{
+					double cur = cost(i0-1,j-1) - u[i0] - v[j];
+					if(cur < minv[j])
+					{
+						minv[j] = cur;
+						way[j] = j0;
+					}
+					if(minv[j] < delta)
+					{
+						delta = minv[j];
+						j1 = j;
+					}
+				}
+			}
+			for(unsigned int j = 0; j <= m; j++)
+			{
+				if(used[j])
+				{
+					u[p[j]] += delta;
+					v[j] -= delta;
+				}
+				else
+				{
+					minv[j] -= delta;
+				}
+			}
+			j0 = j1;
+		}while(p[j0] != 0);
+
+		// augmenting path
+		do
+		{
+			unsigned int j1 = way[j0];
+			p[j0] = p[j1];
+			j0 = j1;
+		}while(j0 != 0);
+	}
+
+	std::vector<unsigned int> assign(n,0);
+	for(unsigned int j = 1; j <= m; j++)
+	{
+		if(p[j] != 0)
+			assign[p[j]-1] = j-1;
+	}
+	return assign;
+}
+
+/**
+ *  \brief Number of edges whose signature is not in the reference signatures
+ */
+unsigned int TopoMismatch(const skeleton::GraphProjSkel::Ptr skel, const std::vector<unsigned int> &assoc_ext,
+						  const std::unordered_set<algorithm::graphoperation::EdgeSignature,algorithm::graphoperation::EdgeSignature::Hash> &setref)
+{
+	std::vector<algorithm::graphoperation::EdgeSignature> vecsign = algorithm::graphoperation::TopoSignatures(skel,assoc_ext);
+
+	unsigned int nbmis = 0;
+	for(unsigned int i = 0; i < vecsign.size(); i++)
+	{
+		if(setref.find(vecsign[i]) == setref.end())
+			nbmis++;
+	}
+	return nbmis;
+}
+
+std::vector<std::vector<unsigned int> > algorithm::graphoperation::AssociateExtremities(const std::vector<skeleton::GraphProjSkel::Ptr> &vec_skel,
+																						 std::vector<std::vector<double> > &confidence,
+																						 const OptionsAssocExt &options)
+{
+	if(vec_skel.size() < 2)
+		throw std::logic_error("algorithm::graphoperation::AssociateExtremities : At least two skeletons are needed");
+
+	// extremities of each skeleton, and associated lines
+	std::vector<std::vector<unsigned int> > vec_leaves(vec_skel.size());
+	std::vector<std::vector<mathtools::geometry::euclidian::Line<4> > > vec_lines(vec_skel.size());
+	unsigned int ref = 0;
+	for(unsigned int i = 0; i < vec_skel.size(); i++)
+	{
+		vec_skel[i]->getNodesByDegree(1,vec_leaves[i]);
+
+		vec_lines[i].reserve(vec_leaves[i].size());
+		for(unsigned int j = 0; j < vec_leaves[i].size(); j++)
+		{
+			vec_lines[i].push_back(vec_skel[i]->getNode<mathtools::geometry::euclidian::Line<4> >(vec_leaves[i][j]));
+		}
+
+		if(vec_leaves[i].size() < vec_leaves[ref].size())
+			ref = i;
+	}
+
+	unsigned int nbext = (options.nbext == 0 ? vec_leaves[ref].size() : options.nbext);
+	if(nbext == 0 || nbext > vec_leaves[ref].size())
+		throw std::logic_error("algorithm::graphoperation::AssociateExtremities : Not enough extremities in skeleton");
+
+	// line distances between reference and other extremities, normalized by their median
+	std::vector<Eigen::MatrixXd> vec_cost(vec_skel.size());
+	for(unsigned int i = 0; i < vec_skel.size(); i++)
+	{
+		if(i == ref)
+			continue;
+
+		Eigen::MatrixXd cost(vec_leaves[ref].size(),vec_leaves[i].size());
+		for(unsigned int j = 0; j < vec_leaves[ref].size(); j++)
+		{
+			for(unsigned int k = 0; k < vec_leaves[i].size(); k++)
+			{
+				cost(j,k) = LineDistance(vec_lines[ref][j],vec_lines[i][k]);
+			}
+		}
+
+		std::vector<double> vec_dist(cost.data(),cost.data()+cost.size());
+		std::nth_element(vec_dist.begin(),vec_dist.begin()+vec_dist.size()/2,vec_dist.end());
+		double median = vec_dist[vec_dist.size()/2];
+		if(median > 0.0)
+			cost /= median;
+
+		vec_cost[i] = cost;
+	}
+
+	// keeps the reference extremities which are the best matched in the other skeletons
+	std::vector<unsigned int> indref(vec_leaves[ref].size());
+	std::iota(indref.begin(),indref.end(),0);
+	if(nbext < indref.size())
+	{
+		std::vector<std::pair<double,unsigned int> > score(indref.size());
+		for(unsigned int j = 0; j < indref.size(); j++)
+		{
+			score[j] = std::pair<double,unsigned int>(0.0,j);
+			for(unsigned int i = 0; i < vec_skel.size(); i++)
+			{
+				if(i != ref)
+					score[j].first += vec_cost[i].row(j).minCoeff();
+			}
+		}
+		std::sort(score.begin(),score.end());
+		for(unsigned int j = 0; j < nbext; j++)
+			indref[j] = score[j].second;
+		indref.resize(nbext);
+		std::sort(indref.begin(),indref.end());
+	}
+
+	std::vector<std::vector<unsigned int> > assoc_ext(vec_skel.size(),std::vector<unsigned int>(nbext));
+	confidence = std::vector<std::vector<double> >(vec_skel.size(),std::vector<double>(nbext,1.0));
+	for(unsigned int k = 0; k < nbext; k++)
+	{
+		assoc_ext[ref][k] = vec_leaves[ref][indref[k]];
+	}
+
+	std::vector<algorithm::graphoperation::EdgeSignature> vecsignref = TopoSignatures(vec_skel[ref],assoc_ext[ref]);
+	std::unordered_set<algorithm::graphoperation::EdgeSignature,algorithm::graphoperation::EdgeSignature::Hash> setref(vecsignref.begin(),vecsignref.end());
+
+	for(unsigned int i = 0; i < vec_skel.size(); i++)
+	{
+		if(i == ref)
+			continue;
+
+		Eigen::MatrixXd cost(nbext,vec_leaves[i].size());
+		for(unsigned int k = 0; k < nbext; k++)
+			cost.row(k) = vec_cost[i].row(indref[k]);
+
+		// geometric assignment
+		std::vector<unsigned int> col = MinAssignment(cost);
+		for(unsigned int k = 0; k < nbext; k++)
+			assoc_ext[i][k] = vec_leaves[i][col[k]];
+
+		/*
+		 *  Topological refinement: swaps two assignments while the number of edges not found
+		 *  in the reference skeleton decreases more than the geometric cost increases
+		 */
+		double curtopo = options.topoweight*TopoMismatch(vec_skel[i],assoc_ext[i],setref);
+		unsigned int nbswap = 0;
+		bool improved = true;
+		while(improved && curtopo > 0.0 && nbswap < options.maxswap)
+		{
+			improved = false;
+			for(unsigned int k1 = 0; k1 < nbext && nbswap < options.maxswap; k1++)
+			{
+				for(unsigned int k2 = k1+1; k2 < nbext && nbswap < options.maxswap; k2++)
+				{
+					double dgeo = cost(k1,col[k2]) + cost(k2,col[k1]) - cost(k1,col[k1]) - cost(k2,col[k2]);
+					if(dgeo >= curtopo)
+						continue;
+
+					std::swap(assoc_ext[i][k1],assoc_ext[i][k2]);
+					double newtopo = options.topoweight*TopoMismatch(vec_skel[i],assoc_ext[i],setref);
+					if(newtopo + dgeo < curtopo)
+					{
+						std::swap(col[k1],col[k2]);
+						curtopo = newtopo;
+						improved = true;
+						nbswap++;
+					}
+					else
+					{
+						std::swap(assoc_ext[i][k1],assoc_ext[i][k2]);
+					}
+				}
+			}
+		}
+
+		/*
+		 *  Confidence: margin between the assigned extremity and the closest other one,
+		 *  lowered by the assignment cost and by the remaining topological mismatch
+		 */
+		for(unsigned int k = 0; k < nbext; k++)
+		{
+			double cur = cost(k,col[k]);
+			double second = std::numeric_limits<double>::infinity();
+			for(unsigned int j = 0; j < cost.cols(); j++)
+			{
+				if(j != col[k] && cost(k,j) < second)
+					second = cost(k,j);
+			}
+
+			double margin = 1.0;
+			if(second != std::numeric_limits<double>::infinity())
+				margin = (second > 0.0 ? std::max(0.0,(second-cur)/second) : 0.0);
+
+			confidence[i][k] = margin/((1.0 + cur)*(1.0 + curtopo));
+			confidence[ref][k] = std::min(confidence[ref][k],confidence[i][k]);
+		}
+	}
+
+	return assoc_ext;
+}
@@ -0,0 +1,95 @@
+/*
+Copyright (c) 2016 Bastien Durix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/**
+ *  \file AssociateExtremities.h
+ *  \brief Defines automatic association of skeleton extremities across views
+ *  \author Bastien Durix
+ */
+
+#ifndef _ASSOCIATEEXTREMITIES_H_
+#define _ASSOCIATEEXTREMITIES_H_
+
+#include <skeleton/Skeletons.h>
+
+/**
+ *  \brief Lots of algorithms
+ */
+namespace algorithm
+{
+	/**
+	 *  \brief Operations on graphs
+	 */
+	namespace graphoperation
+	{
+		/**
+		 *  \brief Automatic extremities association options
+		 */
+		struct OptionsAssocExt
+		{
+			/**
+			 *  \brief Number of extremities to associate (0: smallest number of extremities among the skeletons)
+			 */
+			unsigned int nbext;
+
+			/**
+			 *  \brief Cost of an edge whose topological signature is not found in the reference skeleton
+			 */
+			double topoweight;
+
+			/**
+			 *  \brief Maximal number of swaps during the topological refinement, for each skeleton
+			 */
+			unsigned int maxswap;
+
+			/**
+			 *  \brief Default constructor
+			 */
+			OptionsAssocExt(unsigned int nbext_ = 0, double topoweight_ = 1.0, unsigned int maxswap_ = 100) :
+				nbext(nbext_), topoweight(topoweight_), maxswap(maxswap_) {}
+		};
+
+		/**
+		 *  \brief Associates the extremities of projective skeletons, without user input
+		 *
+		 *  \details The skeleton with the fewest extremities is taken as reference.
+		 *           Each extremity node defines a line in space (given by the camera of its skeleton).
+		 *           Extremities of the other skeletons are first assigned to the reference ones by minimizing the distance between lines,
+		 *           then pairs of assignments are swapped while it reduces the number of edges whose topological signature (see TopoMatch)
+		 *           is not found in the reference skeleton.
+		 *
+		 *  \param vec_skel   input projective skeletons
+		 *  \param confidence output confidence of each assignment, in [0,1] (same layout as the result)
+		 *  \param options    association options
+		 *
+		 *  \return associated extremities (first indice : skeleton number), to be used by TopoMatch
+		 *
+		 *  \throws std::logic_error if there are less than two skeletons, or not enough extremities in a skeleton
+		 */
+		std::vector<std::vector<unsigned int> > AssociateExtremities(const std::vector<skeleton::GraphProjSkel::Ptr> &vec_skel,
+																	 std::vector<std::vector<double> > &confidence,
+																	 const OptionsAssocExt &options = OptionsAssocExt());
+	}
+}
+
+#endif //_ASSOCIATEEXTREMITIES_H_
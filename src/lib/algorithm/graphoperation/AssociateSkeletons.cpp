@@ -28,9 +28,11 @@ SOFTWARE.
  */
 
 #include "AssociateSkeletons.h"
-#include "ConnectedComponents.h"
 #include "SeparateBranches.h"
+#include "TreePathIndex.h"
+#include "EdgeSignature.h"
 #include <set>
+#include <stdexcept>
 /**
  *  \brief Removes all degree 2 nodes
  */
@@ -69,83 +71,119 @@ skeleton::GraphProjSkel::Ptr SimplifySkeleton(const skeleton::GraphProjSkel::Ptr
 }
 
 /**
- *  \brief Encodes an edge, naming it by the extremities its separates
+ *  \brief Encodes all edges, naming them by the extremities they separate
+ *
+ *  \details One rooted traversal per connected component gives, for each node, the extremities of its subtree.
+ *           The edge between a node and its parent then separates the subtree of the node from the rest of the component.
  */
-void EncodeEdge(const skeleton::GraphProjSkel::Ptr skel, const std::pair<unsigned int, unsigned int> &edge, const std::vector<unsigned int> &assocext, std::set<std::set<unsigned int> > &set_edg)
+void EncodeEdges(const skeleton::GraphProjSkel::Ptr skel, const std::vector<unsigned int> &assocext, std::vector<std::pair<unsigned int, unsigned int> > &vecedges, std::vector<algorithm::graphoperation::EdgeSignature> &vecsign)
 {
-	skeleton::GraphProjSkel::Ptr skelcut(new skeleton::GraphProjSkel(*skel));
-	
-	skelcut->remEdge(edge.first,edge.second);
-	
-	std::list<skeleton::GraphProjSkel::Ptr> listcomp = algorithm::graphoperation::SeparateComponents(skelcut);
+	std::vector<unsigned int> nodes(0);
+	skel->getAllNodes(nodes);
 
-	set_edg = std::set<std::set<unsigned int> >();
-	for(std::list<skeleton::GraphProjSkel::Ptr>::iterator it = listcomp.begin(); it != listcomp.end(); it++)
+	std::map<unsigned int,unsigned int> pos;
+	for(unsigned int i = 0; i < nodes.size(); i++)
+		pos[nodes[i]] = i;
+
+	// extremities carried by each node
+	std::vector<algorithm::graphoperation::EdgeSignature::Bitset> subext(nodes.size(),algorithm::graphoperation::EdgeSignature::Bitset(assocext.size()));
+	for(unsigned int i = 0; i < assocext.size(); i++)
 	{
-		std::list<unsigned int> node_ext;
-		(*it)->getAllNodes(node_ext);
-		
-		std::set<unsigned int> set_ext;
-		for(std::list<unsigned int>::iterator itn = node_ext.begin(); itn != node_ext.end(); itn++)
+		std::map<unsigned int,unsigned int>::iterator it = pos.find(assocext[i]);
+		if(it != pos.end())
+			subext[it->second].set(i);
+	}
+
+	// rooted traversal of each component
+	std::vector<unsigned int> parent(nodes.size(),nodes.size());
+	std::vector<unsigned int> root(nodes.size(),nodes.size());
+	std::vector<unsigned int> order(0);
+	order.reserve(nodes.size());
+	for(unsigned int posr = 0; posr < nodes.size(); posr++)
+	{
+		if(parent[posr] != nodes.size())
+			continue;
+
+		parent[posr] = posr;
+		order.push_back(posr);
+
+		for(unsigned int cur = order.size()-1; cur < order.size(); cur++)
 		{
-			std::vector<unsigned int>::const_iterator its = std::find(assocext.begin(),assocext.end(),*itn);
-			while(its != assocext.end())
+			std::vector<unsigned int> neigh(0);
+			skel->getNeighbors(nodes[order[cur]],neigh);
+			for(unsigned int j = 0; j < neigh.size(); j++)
 			{
-				unsigned int ind = its-assocext.begin();
-				set_ext.insert(ind);
-				its = std::find(std::next(its),assocext.end(),*itn);
+				unsigned int posn = pos[neigh[j]];
+				if(parent[posn] == nodes.size())
+				{
+					parent[posn] = order[cur];
+					order.push_back(posn);
+				}
 			}
+			root[order[cur]] = posr;
 		}
-		set_edg.insert(set_ext);
+	}
+
+	// subtree extremities, from the leaves to the roots
+	for(unsigned int i = order.size(); i > 0; i--)
+	{
+		unsigned int cur = order[i-1];
+		if(parent[cur] != cur)
+			subext[parent[cur]] |= subext[cur];
+	}
+
+	vecedges.resize(0);
+	skel->getAllEdges(vecedges);
+	vecsign.resize(0);
+	vecsign.reserve(vecedges.size());
+
+	for(unsigned int i = 0; i < vecedges.size(); i++)
+	{
+		unsigned int pos1 = pos[vecedges[i].first];
+		unsigned int pos2 = pos[vecedges[i].second];
+		unsigned int child = (parent[pos2] == pos1 ? pos2 : pos1);
+
+		vecsign.push_back(algorithm::graphoperation::EdgeSignature(subext[child],subext[root[child]]));
 	}
 }
 
 /**
  *  \brief Asociate the first node to two sets representing an edge
  */
-template<typename SkelType>
-unsigned int AssociatedNode(const SkelType skel, const std::vector<unsigned int> &assocext, const std::set<unsigned int> &set_ext1, const std::set<unsigned int> &set_ext2)
+unsigned int AssociatedNode(const algorithm::graphoperation::TreePathIndex &pathind, const std::vector<unsigned int> &assocext, const algorithm::graphoperation::EdgeSignature::Bitset &side1, const algorithm::graphoperation::EdgeSignature::Bitset &side2)
 {
 	std::set<unsigned int> set_nod;
-	for(std::set<unsigned int>::const_iterator it = set_ext1.begin(); it != set_ext1.end(); it++)
+	for(algorithm::graphoperation::EdgeSignature::Bitset::size_type i = side1.find_first(); i != side1.npos; i = side1.find_next(i))
 	{
-		set_nod.insert(assocext[*it]);
+		set_nod.insert(assocext[i]);
 	}
 	
-	unsigned int opp_nod = assocext[*(set_ext2.begin())];
+	unsigned int opp_nod = assocext[side2.find_first()];
 	
-	std::list<std::vector<unsigned int> > paths = algorithm::graphoperation::GetNodes(skel,*(set_nod.begin()),opp_nod);
-
-	if(paths.size() < 1)
+	if(!pathind.areConnected(*(set_nod.begin()),opp_nod))
 	{
 		throw std::logic_error("Not able to find the path.");
 	}
 
-	std::vector<unsigned int> &path = *(paths.begin());
-
-	std::map<unsigned int, unsigned int> used;
+	std::vector<unsigned int> path = pathind.getPath(*(set_nod.begin()),opp_nod);
 
-	for(unsigned int i = 0; i < path.size(); i++)
-		used[path[i]] = 1;
+	// number of paths (from the nodes of set_nod to opp_nod) going through each node of path
+	std::vector<unsigned int> used(path.size(),1);
 
 	for(std::set<unsigned int>::iterator it = std::next(set_nod.begin()); it != set_nod.end(); it++)
 	{
-		std::list<std::vector<unsigned int> > paths2 = algorithm::graphoperation::GetNodes(skel,*it,opp_nod);
-		std::vector<unsigned int> &path2 = *(paths2.begin());
-
-		for(unsigned int i = 0; i < path2.size(); i++)
+		for(unsigned int i = 0; i < path.size(); i++)
 		{
-			std::map<unsigned int, unsigned int>::iterator itu = used.find(path2[i]);
-			if(itu!=used.end())
-				itu->second++;
+			if(pathind.isOnPath(*it,opp_nod,path[i]))
+				used[i]++;
 		}
 	}
 	
-	unsigned nbusedmax = used[path[path.size()-1]];
+	unsigned nbusedmax = used[path.size()-1];
 
 	unsigned int indexnode = 0;
 
-	while(used[path[indexnode]] != nbusedmax && indexnode != path.size()-1)
+	while(used[indexnode] != nbusedmax && indexnode != path.size()-1)
 		indexnode++;
 
 	return path[indexnode];
@@ -154,20 +192,20 @@ unsigned int AssociatedNode(const SkelType skel, const std::vector<unsigned int>
 /**
  *  \brief Decodes an edge, from the extremities its separates
  */
-template<typename SkelType>
-void DecodeEdge(const SkelType skel, const std::vector<unsigned int> &assocext, const std::set<std::set<unsigned int> > &set_edg, std::pair<unsigned int, unsigned int> &edge)
+void DecodeEdge(const algorithm::graphoperation::TreePathIndex &pathind, const std::vector<unsigned int> &assocext, const algorithm::graphoperation::EdgeSignature &sign, std::pair<unsigned int, unsigned int> &edge)
 {
-	edge.first  = AssociatedNode(skel,assocext,(*set_edg.begin()),(*set_edg.rbegin()));
-	edge.second = AssociatedNode(skel,assocext,(*set_edg.rbegin()),(*set_edg.begin()));
+	edge.first  = AssociatedNode(pathind,assocext,sign.getFirstSide(),sign.getSecondSide());
+	edge.second = AssociatedNode(pathind,assocext,sign.getSecondSide(),sign.getFirstSide());
 }
 
 /**
  *  \brief Contracts an edge, replacing it by the middle node
+ *
+ *  \return index of the middle node
  */
-void ContractEdge(skeleton::GraphProjSkel::Ptr skelsimp, const skeleton::GraphProjSkel::Ptr skelori, const std::pair<unsigned int,unsigned int> &edge)
+unsigned int ContractEdge(skeleton::GraphProjSkel::Ptr skelsimp, const skeleton::GraphProjSkel::Ptr skelori, const algorithm::graphoperation::TreePathIndex &pathori, const std::pair<unsigned int,unsigned int> &edge)
 {
-	std::list<std::vector<unsigned int> > listbr = algorithm::graphoperation::GetNodes(skelori, edge.first, edge.second);
-	std::vector<unsigned int> &br = *(listbr.begin());
+	std::vector<unsigned int> br = pathori.getPath(edge.first, edge.second);
 	
 	unsigned int node = br[br.size()/2];
 
@@ -187,82 +225,138 @@ void ContractEdge(skeleton::GraphProjSkel::Ptr skelsimp, const skeleton::GraphPr
 			skelsimp->addEdge(node,*it);
 		}
 	}
+
+	return node;
 }
 
 skeleton::ReconstructionSkeleton::Ptr algorithm::graphoperation::TopoMatch(const std::vector<skeleton::GraphProjSkel::Ptr> &vec_skel, const std::vector<std::vector<unsigned int> > &assoc_ext)
 {
 	std::vector<skeleton::GraphProjSkel::Ptr> vec_skelsimp(vec_skel.size());
+	std::vector<std::vector<std::pair<unsigned int,unsigned int> > > vec_edges(vec_skel.size());
+	std::vector<std::vector<algorithm::graphoperation::EdgeSignature> > vec_sign(vec_skel.size());
 	
-	std::map<std::set<std::set<unsigned int> >,unsigned int> cptedg;
+	// signatures of the edges, with the edges having it in each view
+	algorithm::graphoperation::EdgeSignatureIndex indsign;
 	
-	// converts edges into sets, an count number of occurences
+	// converts edges into signatures, and join them across views
 	for(unsigned int i = 0; i < vec_skel.size(); i++)
 	{
 		vec_skelsimp[i] = SimplifySkeleton(vec_skel[i],assoc_ext[i]);
 		
-		std::list<std::pair<unsigned int,unsigned int> > listedges;
-		vec_skelsimp[i]->getAllEdges(listedges);
-		for(std::list<std::pair<unsigned int,unsigned int> >::iterator it = listedges.begin(); it != listedges.end(); it++)
+		EncodeEdges(vec_skelsimp[i],assoc_ext[i],vec_edges[i],vec_sign[i]);
+		for(unsigned int j = 0; j < vec_sign[i].size(); j++)
 		{
-			std::set<std::set<unsigned int> > edgset;
-			EncodeEdge(vec_skelsimp[i],*it,assoc_ext[i],edgset);
-			
-			std::map<std::set<std::set<unsigned int> >,unsigned int>::iterator its = cptedg.find(edgset);
-			if(its == cptedg.end())
-			{
-				cptedg[edgset] = 1;
-			}
-			else
-			{
-				its->second++;
-			}
+			std::vector<std::vector<unsigned int> > &edgview = indsign[vec_sign[i][j]];
+			edgview.resize(vec_skel.size());
+			edgview[i].push_back(j);
 		}
 	}
 	
+	// signatures are sorted, so that the result does not depend on the hash
+	std::vector<algorithm::graphoperation::EdgeSignature> vecsign(0);
+	std::vector<unsigned int> cptedg(0);
+	vecsign.reserve(indsign.size());
+	for(algorithm::graphoperation::EdgeSignatureIndex::const_iterator it = indsign.begin(); it != indsign.end(); it++)
+	{
+		vecsign.push_back(it->first);
+	}
+	std::sort(vecsign.begin(),vecsign.end());
+	
+	// number of occurences of each signature
+	cptedg.reserve(vecsign.size());
+	for(unsigned int k = 0; k < vecsign.size(); k++)
+	{
+		const std::vector<std::vector<unsigned int> > &edgview = indsign[vecsign[k]];
+		unsigned int cpt = 0;
+		for(unsigned int i = 0; i < edgview.size(); i++)
+			cpt += edgview[i].size();
+		cptedg.push_back(cpt);
+	}
+	
 	// contracts edges which occurences is less than half the number of skeletons
 	for(unsigned int i = 0; i < vec_skelsimp.size(); i++)
 	{
-		std::vector<std::pair<unsigned int,unsigned int> > vecedges(0);
-		vec_skelsimp[i]->getAllEdges(vecedges);
+		algorithm::graphoperation::TreePathIndex pathori(vec_skel[i]);
 
-		std::vector<std::set<std::set<unsigned int> > > vecedgset(vecedges.size());
-
-		for(unsigned int j = 0; j < vecedges.size() ; j++)
-		{
-			EncodeEdge(vec_skelsimp[i],vecedges[j],assoc_ext[i],vecedgset[j]);
-		}
+		std::vector<std::pair<unsigned int,unsigned int> > &vecedges = vec_edges[i];
+		std::vector<algorithm::graphoperation::EdgeSignature> &vecedgsign = vec_sign[i];
+		
+		// position of each signature in the current edges of the view
+		algorithm::graphoperation::EdgeSignatureMap<unsigned int> posedg;
+		for(unsigned int j = 0; j < vecedgsign.size(); j++)
+			posedg.emplace(vecedgsign[j],j);
 		
-		for(std::map<std::set<std::set<unsigned int> >,unsigned int>::iterator it = cptedg.begin(); it != cptedg.end(); it++)
+		for(unsigned int k = 0; k < vecsign.size(); k++)
 		{
+			const algorithm::graphoperation::EdgeSignature &sign = vecsign[k];
+			
 			//if the edge is not kept, it is contracted
-			if(it->second <= vec_skel.size()/2 && it->first.begin()->size() != 1 && it->first.rbegin()->size() != 1)
+			if(cptedg[k] <= vec_skel.size()/2 && sign.getFirstSide().count() != 1 && sign.getSecondSide().count() != 1)
 			{
-				unsigned int ind = std::find(vecedgset.begin(),vecedgset.end(),it->first) - vecedgset.begin();
-				if(ind != vecedgset.size())
+				algorithm::graphoperation::EdgeSignatureMap<unsigned int>::const_iterator itp = posedg.find(sign);
+				if(itp != posedg.end())
 				{
-					ContractEdge(vec_skelsimp[i],vec_skel[i],vecedges[ind]);
+					unsigned int ind = itp->second;
+					std::pair<unsigned int,unsigned int> edge = vecedges[ind];
+					unsigned int node = ContractEdge(vec_skelsimp[i],vec_skel[i],pathori,edge);
+					
+					// the separation induced by the other edges is unchanged: only their extremities are renamed
+					std::map<std::pair<unsigned int,unsigned int>,unsigned int> prevind;
+					for(unsigned int j = 0; j < vecedges.size(); j++)
+					{
+						if(j == ind)
+							continue;
+						
+						std::pair<unsigned int,unsigned int> edgren = vecedges[j];
+						if(edgren.first == edge.first || edgren.first == edge.second)
+							edgren.first = node;
+						if(edgren.second == edge.first || edgren.second == edge.second)
+							edgren.second = node;
+						if(edgren.first > edgren.second)
+							std::swap(edgren.first,edgren.second);
+						prevind[edgren] = j;
+					}
+					
+					std::vector<algorithm::graphoperation::EdgeSignature> prevedgsign(0);
+					prevedgsign.swap(vecedgsign);
 					
 					vecedges.resize(0);
 					vec_skelsimp[i]->getAllEdges(vecedges);
-					vecedgset.resize(vecedges.size());
-
-					for(unsigned int j = 0; j < vecedges.size() ; j++)
+					vecedgsign.reserve(vecedges.size());
+					for(unsigned int j = 0; j < vecedges.size(); j++)
 					{
-						EncodeEdge(vec_skelsimp[i],vecedges[j],assoc_ext[i],vecedgset[j]);
+						std::pair<unsigned int,unsigned int> edgsort(std::min(vecedges[j].first,vecedges[j].second),
+						                                             std::max(vecedges[j].first,vecedges[j].second));
+						std::map<std::pair<unsigned int,unsigned int>,unsigned int>::const_iterator itprev = prevind.find(edgsort);
+						if(itprev == prevind.end())
+							throw std::logic_error("algorithm::graphoperation::TopoMatch : Contracted edge does not come from the previous skeleton");
+						vecedgsign.push_back(prevedgsign[itprev->second]);
 					}
+					
+					posedg.clear();
+					for(unsigned int j = 0; j < vecedgsign.size(); j++)
+						posedg.emplace(vecedgsign[j],j);
 				}
 			}
 		}
 	}
 
-	std::list<std::set<std::set<unsigned int> > > keptedg;
+	// path indices of the simplified skeletons, used to decode the edges
+	std::vector<algorithm::graphoperation::TreePathIndex> vec_pathsimp;
+	vec_pathsimp.reserve(vec_skelsimp.size());
+	for(unsigned int i = 0; i < vec_skelsimp.size(); i++)
+	{
+		vec_pathsimp.push_back(algorithm::graphoperation::TreePathIndex(vec_skelsimp[i]));
+	}
+
+	std::list<algorithm::graphoperation::EdgeSignature> keptedg;
 	
 	// get most present edges
-	for(std::map<std::set<std::set<unsigned int> >, unsigned int>::iterator it = cptedg.begin(); it != cptedg.end(); it++)
+	for(unsigned int k = 0; k < vecsign.size(); k++)
 	{
-		if(it->second > vec_skel.size()/2 || it->first.begin()->size() == 1 || it->first.rbegin()->size() == 1)
+		if(cptedg[k] > vec_skel.size()/2 || vecsign[k].getFirstSide().count() == 1 || vecsign[k].getSecondSide().count() == 1)
 		{
-			keptedg.push_back(it->first);
+			keptedg.push_back(vecsign[k]);
 		}
 	}
 	
@@ -272,18 +366,18 @@ skeleton::ReconstructionSkeleton::Ptr algorithm::graphoperation::TopoMatch(const
 	std::vector<unsigned int> assoc_med(nbext);
 	recskel->addNode(nbext);
 	// edges connected to extremities
-	for(std::list<std::set<std::set<unsigned int> > >::iterator it = keptedg.begin(); it != keptedg.end(); it++)
+	for(std::list<algorithm::graphoperation::EdgeSignature>::iterator it = keptedg.begin(); it != keptedg.end(); it++)
 	{
-		std::set<std::set<unsigned int> > &set_ext = *it;
-		const std::set<unsigned int> &set1 = *(set_ext.begin()),
-									  set2 = *(set_ext.rbegin());
-		if(set1.size() == 1 || set2.size() == 1)
+		const algorithm::graphoperation::EdgeSignature &set_ext = *it;
+		const algorithm::graphoperation::EdgeSignature::Bitset set1 = set_ext.getFirstSide(),
+															   set2 = set_ext.getSecondSide();
+		if(set1.count() == 1 || set2.count() == 1)
 		{
 			unsigned int indnod;
-			if(set1.size() == 1)
-				indnod = *(set1.begin());
+			if(set1.count() == 1)
+				indnod = set1.find_first();
 			else
-				indnod = *(set2.begin());
+				indnod = set2.find_first();
 
 			assoc_med[indnod] = indnod;
 
@@ -298,14 +392,14 @@ skeleton::ReconstructionSkeleton::Ptr algorithm::graphoperation::TopoMatch(const
 				indskel[j] = j;
 				
 				std::pair<unsigned int,unsigned int> edge;
-				DecodeEdge(vec_skelsimp[j],assoc_ext[j],set_ext,edge);
+				DecodeEdge(vec_pathsimp[j],assoc_ext[j],set_ext,edge);
 
 				firstext[j] = edge.first;
 				secondext[j] = edge.second;
 			}
 			skeleton::ReconstructionBranch::Ptr br(new skeleton::ReconstructionBranch(indskel,firstext,secondext));
 
-			if(set1.size() == 1)
+			if(set1.count() == 1)
 				recskel->addEdge(indnod,nbext,br);
 			else
 				recskel->addEdge(nbext,indnod,br);
@@ -313,15 +407,18 @@ skeleton::ReconstructionSkeleton::Ptr algorithm::graphoperation::TopoMatch(const
 	}
 	
 	// other edges
-	for(std::list<std::set<std::set<unsigned int> > >::iterator it = keptedg.begin(); it != keptedg.end(); it++)
+	for(std::list<algorithm::graphoperation::EdgeSignature>::iterator it = keptedg.begin(); it != keptedg.end(); it++)
 	{
-		std::set<std::set<unsigned int> > &set_ext = *it;
-		const std::set<unsigned int> &set1 = *(set_ext.begin()),
-									  set2 = *(set_ext.rbegin());
-		if(set1.size() != 1 && set2.size() != 1)
+		const algorithm::graphoperation::EdgeSignature &set_ext = *it;
+		const algorithm::graphoperation::EdgeSignature::Bitset set1 = set_ext.getFirstSide(),
+															   set2 = set_ext.getSecondSide();
+		if(set1.count() != 1 && set2.count() != 1)
 		{
+			// recskel is modified at each iteration, its index has to be rebuilt
+			algorithm::graphoperation::TreePathIndex pathrec(recskel);
+
 			std::pair<unsigned int,unsigned int> edge_med;
-			DecodeEdge(recskel,assoc_med,set_ext,edge_med);
+			DecodeEdge(pathrec,assoc_med,set_ext,edge_med);
 			
 			// branch creation
 			std::vector<unsigned int> indskel(assoc_ext.size());
@@ -332,7 +429,7 @@ skeleton::ReconstructionSkeleton::Ptr algorithm::graphoperation::TopoMatch(const
 				indskel[j] = j;
 				
 				std::pair<unsigned int,unsigned int> edge;
-				DecodeEdge(vec_skelsimp[j],assoc_ext[j],set_ext,edge);
+				DecodeEdge(vec_pathsimp[j],assoc_ext[j],set_ext,edge);
 				
 				firstext[j] = edge.first;
 				secondext[j] = edge.second;
@@ -342,10 +439,9 @@ skeleton::ReconstructionSkeleton::Ptr algorithm::graphoperation::TopoMatch(const
 			unsigned int added_node = recskel->addNode();
 			
 			std::set<unsigned int> add_set; // get nodes connected to prev_nod, on the path to the extremities
-			for(std::set<unsigned int>::const_iterator its = set2.begin(); its != set2.end(); its++)
+			for(algorithm::graphoperation::EdgeSignature::Bitset::size_type its = set2.find_first(); its != set2.npos; its = set2.find_next(its))
 			{
-				std::list<std::vector<unsigned int> > paths = algorithm::graphoperation::GetNodes(recskel,prev_nod,*its);
-				std::vector<unsigned int> &path = *(paths.begin());
+				std::vector<unsigned int> path = pathrec.getPath(prev_nod,its);
 				
 				add_set.insert(path[1]);
 			}
@@ -365,3 +461,13 @@ skeleton::ReconstructionSkeleton::Ptr algorithm::graphoperation::TopoMatch(const
 
 	return recskel;
 }
+
+std::vector<algorithm::graphoperation::EdgeSignature> algorithm::graphoperation::TopoSignatures(const skeleton::GraphProjSkel::Ptr skel, const std::vector<unsigned int> &assoc_ext)
+{
+	std::vector<std::pair<unsigned int,unsigned int> > vecedges(0);
+	std::vector<algorithm::graphoperation::EdgeSignature> vecsign(0);
+	
+	EncodeEdges(SimplifySkeleton(skel,assoc_ext),assoc_ext,vecedges,vecsign);
+	
+	return vecsign;
+}
@@ -31,6 +31,7 @@ SOFTWARE.
 #define _ASSOCIATESKELETONS_H_
 
 #include <skeleton/Skeletons.h>
+#include "EdgeSignature.h"
 
 /**
  *  \brief Lots of algorithms
@@ -49,8 +50,20 @@ namespace algorithm
 		 *  \param assoc_ext   input extremities (first indice : skeleton number)
 		 *
 		 *  \return output reconstruction skeleton
+		 *
+		 *  \throws std::logic_error if an edge of a contracted skeleton cannot be traced back to its edges before the contraction
 		 */
 		skeleton::ReconstructionSkeleton::Ptr TopoMatch(const std::vector<skeleton::GraphProjSkel::Ptr > &vec_skel, const std::vector<std::vector<unsigned int> > &assoc_ext);
+
+		/**
+		 *  \brief Computes the topological signatures of the edges of a skeleton, as used by TopoMatch
+		 *
+		 *  \param skel      input projective skeleton
+		 *  \param assoc_ext input extremities of the skeleton
+		 *
+		 *  \return signatures of the edges of the skeleton, once simplified
+		 */
+		std::vector<EdgeSignature> TopoSignatures(const skeleton::GraphProjSkel::Ptr skel, const std::vector<unsigned int> &assoc_ext);
 	}
 }
 
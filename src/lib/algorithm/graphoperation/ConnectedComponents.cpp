@@ -29,129 +29,164 @@ SOFTWARE.
 
 #include "ConnectedComponents.h"
 
+const unsigned int algorithm::graphoperation::ComponentLabels::NoLabel;
+
 /**
- *  \brief Separate skeleton into connected components
+ *  \brief Labels the connected components of a skeleton
  *
  *  \tparam GraphSkel skeleton type
- *  \param  grskel    skeleton to separate
+ *  \param  grskel    skeleton to label
  *
- *  \return list of connected components
+ *  \return components labelling
  */
 template<typename GraphSkel>
-std::list<typename GraphSkel::Ptr> SeparateComponents_helper(const typename GraphSkel::Ptr grskel)
+algorithm::graphoperation::ComponentLabels LabelComponents_helper(const typename GraphSkel::Ptr grskel)
 {
-	std::vector<unsigned int> nodekey(0); // all node keys
+	algorithm::graphoperation::ComponentLabels labels;
+
+	std::vector<unsigned int> &nodekey = labels.keys; // all node keys
 	grskel->getAllNodes(nodekey);
+	unsigned int nbnode = nodekey.size();
 
-	std::map<unsigned int, unsigned int> connect_comp; // connected component associated to each node
-	for(unsigned int i = 0; i < nodekey.size(); i++)
-		connect_comp[nodekey[i] ] = 0;
+	/*
+	 * Sort the keys in linear time, by radix sort on four 8 bits digits
+	 */
+	std::vector<unsigned int> sortedkey(nbnode);
+	for(unsigned int shift = 0; shift < 32; shift += 8)
+	{
+		std::vector<unsigned int> digitbeg(257,0);
+		for(unsigned int i = 0; i < nbnode; i++)
+			digitbeg[((nodekey[i] >> shift) & 0xFF) + 1]++;
+		for(unsigned int d = 0; d < 256; d++)
+			digitbeg[d+1] += digitbeg[d];
+		for(unsigned int i = 0; i < nbnode; i++)
+			sortedkey[digitbeg[(nodekey[i] >> shift) & 0xFF]++] = nodekey[i];
+		nodekey.swap(sortedkey);
+	}
+
+	std::vector<std::pair<unsigned int,unsigned int> > edges(0);
+	grskel->getAllEdges(edges);
+
+	/*
+	 * Positions of the nodes in the sorted keys
+	 */
+	std::unordered_map<unsigned int,unsigned int> &nodepos = labels.position;
+	nodepos.reserve(nbnode);
+	for(unsigned int i = 0; i < nbnode; i++)
+		nodepos[nodekey[i] ] = i;
+
+	/*
+	 * Adjacency, in compressed rows indexed by node positions
+	 */
+	std::vector<unsigned int> adjbeg(nbnode+1,0);
+	std::vector<std::pair<unsigned int,unsigned int> > edgepos(edges.size());
+	for(unsigned int i = 0; i < edges.size(); i++)
+	{
+		edgepos[i].first = nodepos[edges[i].first];
+		edgepos[i].second = nodepos[edges[i].second];
+		adjbeg[edgepos[i].first+1]++;
+		adjbeg[edgepos[i].second+1]++;
+	}
+	for(unsigned int i = 0; i < nbnode; i++)
+		adjbeg[i+1] += adjbeg[i];
+
+	std::vector<unsigned int> adj(adjbeg[nbnode]);
+	std::vector<unsigned int> adjpos(adjbeg.begin(),adjbeg.end()-1);
+	for(unsigned int i = 0; i < edgepos.size(); i++)
+	{
+		adj[adjpos[edgepos[i].first]++] = edgepos[i].second;
+		adj[adjpos[edgepos[i].second]++] = edgepos[i].first;
+	}
 
-	std::list<typename GraphSkel::Ptr> list_comp;
-	if(nodekey.size())
+	/*
+	 * Breadth first traversal from each unlabelled node, by increasing key:
+	 * the nodes vector is used as the queue (of positions, converted to keys afterwards),
+	 * so that components are contiguous
+	 */
+	labels.label.assign(nbnode,algorithm::graphoperation::ComponentLabels::NoLabel);
+	labels.nodes.reserve(nbnode);
+	labels.offset.push_back(0);
+	for(unsigned int root = 0; root < nbnode; root++)
 	{
-		/*
-		 * Identify connected components
-		 */
-		bool alllabelled = false;
-		unsigned int labelcomp = 1;
+		if(labels.label[root] != algorithm::graphoperation::ComponentLabels::NoLabel)
+			continue;
+
+		unsigned int labelcomp = labels.offset.size()-1;
+		labels.label[root] = labelcomp;
+		labels.nodes.push_back(root);
 
-		while(!alllabelled)
+		for(unsigned int cur = labels.offset.back(); cur < labels.nodes.size(); cur++)
 		{
-			unsigned int firstnotlabelled = 0;
-			alllabelled=true;
-			
-			/*
-			 * Get the first node not labelled
-			 */
-			for(std::map<unsigned int, unsigned int>::iterator it = connect_comp.begin(); it !=connect_comp.end() && alllabelled; it++)
-			{
-				if(it->second == 0)
-				{
-					firstnotlabelled = it->first;
-					alllabelled=false;
-				}
-			}
-			
-			if(!alllabelled)
+			unsigned int pos = labels.nodes[cur];
+			for(unsigned int j = adjbeg[pos]; j < adjbeg[pos+1]; j++)
 			{
-				std::list<unsigned int> tolabel;
-				tolabel.push_back(firstnotlabelled);
-				
-				/*
-				 * Label all the nodes connected to firstnotlabelled
-				 */
-				while(!tolabel.empty())
+				if(labels.label[adj[j] ] == algorithm::graphoperation::ComponentLabels::NoLabel)
 				{
-					unsigned int key = *(tolabel.begin());
-					tolabel.pop_front();
-					
-					/*
-					 * If the node key is not labelled,
-					 * add all its neighbors to the tolabel list
-					 */
-					if(connect_comp[key] == 0)
-					{
-						connect_comp[key]=labelcomp;
-						grskel->getNeighbors(key,tolabel);
-					}
+					labels.label[adj[j] ] = labelcomp;
+					labels.nodes.push_back(adj[j]);
 				}
-				
-				/*
-				 * Increment the label
-				 */
-				labelcomp++;
 			}
 		}
 
-		/*
-		 * Add components in skeletons
-		 */
-		for(unsigned int label = 1; label < labelcomp; label++)
+		labels.offset.push_back(labels.nodes.size());
+	}
+
+	for(unsigned int i = 0; i < labels.nodes.size(); i++)
+		labels.nodes[i] = nodekey[labels.nodes[i] ];
+
+	return labels;
+}
+
+/**
+ *  \brief Separate skeleton into connected components
+ *
+ *  \tparam GraphSkel skeleton type
+ *  \param  grskel    skeleton to separate
+ *
+ *  \return list of connected components
+ */
+template<typename GraphSkel>
+std::list<typename GraphSkel::Ptr> SeparateComponents_helper(const typename GraphSkel::Ptr grskel)
+{
+	algorithm::graphoperation::ComponentLabels labels = LabelComponents_helper<GraphSkel>(grskel);
+
+	std::vector<typename GraphSkel::Ptr> vec_comp(labels.getNbComponents());
+	for(unsigned int label = 0; label < vec_comp.size(); label++)
+	{
+		vec_comp[label] = typename GraphSkel::Ptr(new GraphSkel(grskel->getModel()));
+		for(unsigned int i = labels.offset[label]; i < labels.offset[label+1]; i++)
 		{
-			typename GraphSkel::Ptr grskl_comp(new GraphSkel(grskel->getModel()));
-			
-			/*
-			 * Add each labelled node to the current skeleton
-			 */
-			for(std::map<unsigned int, unsigned int>::iterator it = connect_comp.begin(); it !=connect_comp.end(); it++)
-			{
-				if(it->second == label)
-				{
-					/*
-					 * If node node i is labelled,
-					 * add the node nodekey[i]
-					 */
-					grskl_comp->addNode(it->first,grskel->getNode(it->first));
-				}
-			}
-			
-			for(std::map<unsigned int, unsigned int>::iterator it = connect_comp.begin(); it !=connect_comp.end(); it++)
-			{
-				if(it->second == label)
-				{
-					/*
-					 * If the node i is in the skeleton,
-					 * add its neighbors
-					 */
-					std::vector<unsigned int> neigh(0);
-					grskel->getNeighbors(it->first,neigh);
-
-					/*
-					 * As the nodes do have the sames indices,
-					 * we can add directly the edge
-					 */
-					for(unsigned int j = 0; j < neigh.size(); j++)
-					{
-						grskl_comp->addEdge(it->first,neigh[j]);
-					}
-				}
-			}
-			list_comp.push_back(grskl_comp);
+			vec_comp[label]->addNode(labels.nodes[i],grskel->getNode(labels.nodes[i]));
 		}
 	}
 
-	return list_comp;
+	/*
+	 * As the nodes do have the sames indices,
+	 * we can add directly the edges
+	 */
+	std::vector<std::pair<unsigned int,unsigned int> > edges(0);
+	grskel->getAllEdges(edges);
+	for(unsigned int i = 0; i < edges.size(); i++)
+	{
+		vec_comp[labels.getLabel(edges[i].first)]->addEdge(edges[i].first,edges[i].second);
+	}
+
+	return std::list<typename GraphSkel::Ptr>(vec_comp.begin(),vec_comp.end());
+}
+
+algorithm::graphoperation::ComponentLabels algorithm::graphoperation::LabelComponents(const skeleton::GraphSkel2d::Ptr grskel)
+{
+	return LabelComponents_helper<skeleton::GraphSkel2d>(grskel);
+}
+
+algorithm::graphoperation::ComponentLabels algorithm::graphoperation::LabelComponents(const skeleton::GraphSkel3d::Ptr grskel)
+{
+	return LabelComponents_helper<skeleton::GraphSkel3d>(grskel);
+}
+
+algorithm::graphoperation::ComponentLabels algorithm::graphoperation::LabelComponents(const skeleton::GraphProjSkel::Ptr grskel)
+{
+	return LabelComponents_helper<skeleton::GraphProjSkel>(grskel);
 }
 
 std::list<skeleton::GraphSkel2d::Ptr> algorithm::graphoperation::SeparateComponents(const skeleton::GraphSkel2d::Ptr grskel)
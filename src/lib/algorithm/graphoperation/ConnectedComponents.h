@@ -31,6 +31,9 @@ SOFTWARE.
 #define _CONNECTEDCOMPONENTS_H_
 
 #include <skeleton/Skeletons.h>
+#include <vector>
+#include <unordered_map>
+#include <limits>
 
 /**
  *  \brief Lots of algorithms
@@ -42,12 +45,103 @@ namespace algorithm
 	 */
 	namespace graphoperation
 	{
+		/**
+		 *  \brief Connected components labelling of a skeleton
+		 *
+		 *  \details Nodes of the component c are nodes[offset[c]] to nodes[offset[c+1]-1].
+		 *           Components are ordered by their smallest node index.
+		 */
+		struct ComponentLabels
+		{
+			/**
+			 *  \brief Label given to indices that are not in the skeleton
+			 */
+			static const unsigned int NoLabel = std::numeric_limits<unsigned int>::max();
+
+			/**
+			 *  \brief Node indices of the skeleton, in increasing order
+			 */
+			std::vector<unsigned int> keys;
+
+			/**
+			 *  \brief Position of each node index in keys
+			 */
+			std::unordered_map<unsigned int,unsigned int> position;
+
+			/**
+			 *  \brief Component of each node, in the order of keys
+			 */
+			std::vector<unsigned int> label;
+
+			/**
+			 *  \brief Node indices, grouped by component
+			 */
+			std::vector<unsigned int> nodes;
+
+			/**
+			 *  \brief Position of the first node of each component in nodes (size: number of components + 1)
+			 */
+			std::vector<unsigned int> offset;
+
+			/**
+			 *  \brief Number of components getter
+			 *
+			 *  \return number of connected components
+			 */
+			unsigned int getNbComponents() const
+			{
+				return offset.empty() ? 0 : offset.size()-1;
+			}
+
+			/**
+			 *  \brief Component getter
+			 *
+			 *  \param index node index
+			 *
+			 *  \return component of the node, NoLabel if the node is not in the skeleton
+			 */
+			unsigned int getLabel(unsigned int index) const
+			{
+				std::unordered_map<unsigned int,unsigned int>::const_iterator it = position.find(index);
+				return it != position.end() ? label[it->second] : NoLabel;
+			}
+		};
+
+		/**
+		 *  \brief Labels the connected components of a skeleton, in O(V+E)
+		 *
+		 *  \param grskel skeleton to label
+		 *
+		 *  \return components labelling
+		 */
+		ComponentLabels LabelComponents(const skeleton::GraphSkel2d::Ptr grskel);
+
+		/**
+		 *  \brief Labels the connected components of a skeleton, in O(V+E)
+		 *
+		 *  \param grskel skeleton to label
+		 *
+		 *  \return components labelling
+		 */
+		ComponentLabels LabelComponents(const skeleton::GraphSkel3d::Ptr grskel);
+
+		/**
+		 *  \brief Labels the connected components of a skeleton, in O(V+E)
+		 *
+		 *  \param grskel skeleton to label
+		 *
+		 *  \return components labelling
+		 */
+		ComponentLabels LabelComponents(const skeleton::GraphProjSkel::Ptr grskel);
+
 		/**
 		 *  \brief Separate skeleton into connected components
 		 *
 		 *  \param grskel skeleton to separate
 		 *
 		 *  \return list of connected components
+		 *
+		 *  \details Copies each component in a new skeleton, prefer LabelComponents when copies are not needed
 		 */
 		std::list<skeleton::GraphSkel2d::Ptr> SeparateComponents(const skeleton::GraphSkel2d::Ptr grskel);
 
@@ -57,6 +151,8 @@ namespace algorithm
 		 *  \param grskel skeleton to separate
 		 *
 		 *  \return list of connected components
+		 *
+		 *  \details Copies each component in a new skeleton, prefer LabelComponents when copies are not needed
 		 */
 		std::list<skeleton::GraphProjSkel::Ptr> SeparateComponents(const skeleton::GraphProjSkel::Ptr grskel);
 	}
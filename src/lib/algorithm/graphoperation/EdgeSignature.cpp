@@ -0,0 +1,117 @@
+/*
+Copyright (c) 2016 Bastien Durix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/**
+ *  \file EdgeSignature.cpp
+ *  \brief Defines topological signature of skeleton edges
+ *  \author Bastien Durix
+ */
+
+#include "EdgeSignature.h"
+
+/**
+ *  \brief Mixes a value into a 64 bits hash
+ */
+inline std::uint64_t HashMix(std::uint64_t hash, std::uint64_t val)
+{
+	hash ^= val + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+algorithm::graphoperation::EdgeSignature::EdgeSignature(const Bitset &side) : EdgeSignature(side,~Bitset(side.size()))
+{}
+
+algorithm::graphoperation::EdgeSignature::EdgeSignature(const Bitset &side, const Bitset &universe) : m_first(side & universe), m_second(universe - side), m_hash(0)
+{
+	if(lexicoLess(m_second,m_first))
+		m_first.swap(m_second);
+
+	std::vector<Bitset::block_type> blocks(0);
+	blocks.reserve(m_first.num_blocks() + m_second.num_blocks());
+	boost::to_block_range(m_first,std::back_inserter(blocks));
+	boost::to_block_range(m_second,std::back_inserter(blocks));
+
+	m_hash = HashMix(0,m_first.size());
+	for(unsigned int i = 0; i < blocks.size(); i++)
+		m_hash = HashMix(m_hash,blocks[i]);
+}
+
+unsigned int algorithm::graphoperation::EdgeSignature::getNbExt() const
+{
+	return m_first.size();
+}
+
+const algorithm::graphoperation::EdgeSignature::Bitset& algorithm::graphoperation::EdgeSignature::getFirstSide() const
+{
+	return m_first;
+}
+
+const algorithm::graphoperation::EdgeSignature::Bitset& algorithm::graphoperation::EdgeSignature::getSecondSide() const
+{
+	return m_second;
+}
+
+std::uint64_t algorithm::graphoperation::EdgeSignature::getHash() const
+{
+	return m_hash;
+}
+
+bool algorithm::graphoperation::EdgeSignature::operator==(const EdgeSignature &sign) const
+{
+	return m_hash == sign.m_hash && m_first == sign.m_first && m_second == sign.m_second;
+}
+
+bool algorithm::graphoperation::EdgeSignature::operator!=(const EdgeSignature &sign) const
+{
+	return !(*this == sign);
+}
+
+bool algorithm::graphoperation::EdgeSignature::operator<(const EdgeSignature &sign) const
+{
+	if(m_first.size() != sign.m_first.size())
+		return m_first.size() < sign.m_first.size();
+	if(m_first != sign.m_first)
+		return lexicoLess(m_first,sign.m_first);
+	return lexicoLess(m_second,sign.m_second);
+}
+
+bool algorithm::graphoperation::EdgeSignature::lexicoLess(const Bitset &bits1, const Bitset &bits2)
+{
+	Bitset diff = bits1 ^ bits2;
+	Bitset::size_type pos = diff.find_first();
+
+	if(pos == Bitset::npos) // same sets
+		return false;
+
+	/*
+	 *  Both sets share the same elements before pos.
+	 *  The set containing pos is before the other one if the other one still has elements after pos.
+	 */
+	if(bits1[pos])
+		return bits2.find_next(pos) != Bitset::npos;
+	else
+		return bits1.find_next(pos) == Bitset::npos;
+}
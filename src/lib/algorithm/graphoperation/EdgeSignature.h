@@ -0,0 +1,183 @@
+/*
+Copyright (c) 2016 Bastien Durix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/**
+ *  \file EdgeSignature.h
+ *  \brief Defines topological signature of skeleton edges
+ *  \author Bastien Durix
+ */
+
+#ifndef _EDGESIGNATURE_H_
+#define _EDGESIGNATURE_H_
+
+#include <boost/dynamic_bitset.hpp>
+#include <unordered_map>
+#include <cstdint>
+#include <vector>
+
+/**
+ *  \brief Lots of algorithms
+ */
+namespace algorithm
+{
+	/**
+	 *  \brief Operations on graphs
+	 */
+	namespace graphoperation
+	{
+		/**
+		 *  \brief Topological signature of an edge: bipartition of the extremities it separates
+		 *
+		 *  \details A side and its complement (in the extremities present around the edge) give the same signature.
+		 *           Sides are ordered as the sorted lists of their extremities would be.
+		 */
+		class EdgeSignature
+		{
+			public:
+				/**
+				 *  \brief Extremities bitset type
+				 */
+				using Bitset = boost::dynamic_bitset<>;
+
+				/**
+				 *  \brief Hash functor, to use signatures as keys of unordered containers
+				 */
+				struct Hash
+				{
+					std::size_t operator()(const EdgeSignature &sign) const { return sign.getHash(); }
+				};
+
+			protected:
+				/**
+				 *  \brief First side of the edge
+				 */
+				Bitset m_first;
+
+				/**
+				 *  \brief Second side of the edge
+				 */
+				Bitset m_second;
+
+				/**
+				 *  \brief 64 bits hash of the signature
+				 */
+				std::uint64_t m_hash;
+
+			public:
+				/**
+				 *  \brief Constructor
+				 *
+				 *  \param side extremities on one side of the edge (its size is the total number of extremities)
+				 */
+				EdgeSignature(const Bitset &side = Bitset());
+
+				/**
+				 *  \brief Constructor
+				 *
+				 *  \param side     extremities on one side of the edge
+				 *  \param universe extremities on both sides of the edge
+				 */
+				EdgeSignature(const Bitset &side, const Bitset &universe);
+
+				/**
+				 *  \brief Number of extremities getter
+				 *
+				 *  \return total number of extremities
+				 */
+				unsigned int getNbExt() const;
+
+				/**
+				 *  \brief First side getter
+				 *
+				 *  \return extremities of the first side
+				 */
+				const Bitset& getFirstSide() const;
+
+				/**
+				 *  \brief Second side getter
+				 *
+				 *  \return extremities of the second side
+				 */
+				const Bitset& getSecondSide() const;
+
+				/**
+				 *  \brief Hash getter
+				 *
+				 *  \return 64 bits hash of the signature
+				 */
+				std::uint64_t getHash() const;
+
+				/**
+				 *  \brief Equality operator
+				 *
+				 *  \param sign signature to compare
+				 *
+				 *  \return true if signatures represent the same bipartition
+				 */
+				bool operator==(const EdgeSignature &sign) const;
+
+				/**
+				 *  \brief Inequality operator
+				 *
+				 *  \param sign signature to compare
+				 *
+				 *  \return true if signatures represent different bipartitions
+				 */
+				bool operator!=(const EdgeSignature &sign) const;
+
+				/**
+				 *  \brief Ordering operator (lexicographic order on sides)
+				 *
+				 *  \param sign signature to compare
+				 *
+				 *  \return true if this signature is before sign
+				 */
+				bool operator<(const EdgeSignature &sign) const;
+
+				/**
+				 *  \brief Lexicographic comparison of two extremities sets
+				 *
+				 *  \param bits1 first set
+				 *  \param bits2 second set
+				 *
+				 *  \return true if the sorted extremities of bits1 are lexicographically before the ones of bits2
+				 */
+				static bool lexicoLess(const Bitset &bits1, const Bitset &bits2);
+		};
+
+		/**
+		 *  \brief Unordered index on edge signatures
+		 *
+		 *  \tparam T mapped type
+		 */
+		template<typename T>
+		using EdgeSignatureMap = std::unordered_map<EdgeSignature,T,EdgeSignature::Hash>;
+
+		/**
+		 *  \brief Index from signature to the edges having it, in each view
+		 */
+		using EdgeSignatureIndex = EdgeSignatureMap<std::vector<std::vector<unsigned int> > >;
+	}
+}
+
+#endif //_EDGESIGNATURE_H_
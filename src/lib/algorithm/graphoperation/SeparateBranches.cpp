@@ -28,6 +28,7 @@ SOFTWARE.
  */
 
 #include "SeparateBranches.h"
+#include "TreePathIndex.h"
 
 template<typename Model>
 typename skeleton::ComposedCurveSkeleton<skeleton::GraphBranch<Model> >::Ptr SeparateBranches_helper(const typename skeleton::GraphCurveSkeleton<Model>::Ptr grskel)
@@ -340,6 +341,17 @@ std::vector<typename skeleton::CompGraphProjSkel::Ptr> algorithm::graphoperation
 	{
 		typename skeleton::CompGraphProjSkel::Ptr compskel(new skeleton::CompGraphProjSkel());
 		
+		// path index, built once per skeleton (only available on acyclic skeletons)
+		TreePathIndex::Ptr pathind;
+		try
+		{
+			pathind = TreePathIndex::Ptr(new TreePathIndex(vec_prskel[i]));
+		}
+		catch(const std::logic_error &)
+		{
+			pathind = TreePathIndex::Ptr();
+		}
+		
 		for(std::list<unsigned int>::iterator it = nodes.begin(); it != nodes.end(); it++)
 		{
 			compskel->addNode(*it);
@@ -354,19 +366,38 @@ std::vector<typename skeleton::CompGraphProjSkel::Ptr> algorithm::graphoperation
 			unsigned int firstext = recbr->getFirstExt()[i];
 			unsigned int lastext = recbr->getLastExt()[i];
 			
-			std::list<typename skeleton::BranchGraphProjSkel::Ptr> listbr = GetBranch(vec_prskel[i],firstext,lastext);
+			typename skeleton::BranchGraphProjSkel::Ptr prbranch;
 			
-			if(listbr.size() == 0)
+			if(pathind)
 			{
-				throw std::logic_error("algorithm::graphoperation::GetComposed : Branch does not exist in skeleton");
+				if(!pathind->isNodeIn(firstext) || !pathind->isNodeIn(lastext) || !pathind->areConnected(firstext,lastext))
+				{
+					throw std::logic_error("algorithm::graphoperation::GetComposed : Branch does not exist in skeleton");
+				}
+				
+				std::vector<unsigned int> path = pathind->getPath(firstext,lastext);
+				
+				std::vector<typename skeleton::BranchGraphProjSkel::Stor> vec_br(0);
+				vec_prskel[i]->getNodes(path,vec_br);
+				
+				prbranch = typename skeleton::BranchGraphProjSkel::Ptr(new skeleton::BranchGraphProjSkel(vec_prskel[i]->getModel(),vec_br));
 			}
-			else if(listbr.size() > 1)
+			else
 			{
-				throw std::logic_error("algorithm::graphoperation::GetComposed : Skeleton contains a cycle");
+				std::list<typename skeleton::BranchGraphProjSkel::Ptr> listbr = GetBranch(vec_prskel[i],firstext,lastext);
+				
+				if(listbr.size() == 0)
+				{
+					throw std::logic_error("algorithm::graphoperation::GetComposed : Branch does not exist in skeleton");
+				}
+				else if(listbr.size() > 1)
+				{
+					throw std::logic_error("algorithm::graphoperation::GetComposed : Skeleton contains a cycle");
+				}
+				
+				prbranch = *(listbr.begin());
 			}
 			
-			typename skeleton::BranchGraphProjSkel::Ptr prbranch = *(listbr.begin());
-			
 			compskel->addEdge(ext.first,ext.second,prbranch);
 		}
 		
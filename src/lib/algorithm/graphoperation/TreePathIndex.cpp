@@ -0,0 +1,248 @@
+/*
+Copyright (c) 2016 Bastien Durix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/**
+ *  \file TreePathIndex.cpp
+ *  \brief Defines path queries index on acyclic skeletons
+ *  \author Bastien Durix
+ */
+
+#include "TreePathIndex.h"
+#include <algorithm>
+#include <stdexcept>
+
+template<typename Model>
+void GetEdgePairs(const typename skeleton::GraphCurveSkeleton<Model>::Ptr grskel,
+				  std::vector<unsigned int> &nodes,
+				  std::vector<std::pair<unsigned int,unsigned int> > &edges)
+{
+	grskel->getAllNodes(nodes);
+	grskel->getAllEdges(edges);
+}
+
+void GetEdgePairs(const skeleton::ReconstructionSkeleton::Ptr recskel,
+				  std::vector<unsigned int> &nodes,
+				  std::vector<std::pair<unsigned int,unsigned int> > &edges)
+{
+	recskel->getAllNodes(nodes);
+
+	std::vector<unsigned int> edgeind(0);
+	recskel->getAllEdges(edgeind);
+
+	edges.reserve(edgeind.size());
+	for(unsigned int i = 0; i < edgeind.size(); i++)
+	{
+		edges.push_back(recskel->getExtremities(edgeind[i]));
+	}
+}
+
+algorithm::graphoperation::TreePathIndex::TreePathIndex(const skeleton::GraphSkel2d::Ptr grskel)
+{
+	std::vector<unsigned int> nodes(0);
+	std::vector<std::pair<unsigned int,unsigned int> > edges(0);
+	GetEdgePairs<skeleton::model::Classic<2> >(grskel,nodes,edges);
+	build(nodes,edges);
+}
+
+algorithm::graphoperation::TreePathIndex::TreePathIndex(const skeleton::GraphSkel3d::Ptr grskel)
+{
+	std::vector<unsigned int> nodes(0);
+	std::vector<std::pair<unsigned int,unsigned int> > edges(0);
+	GetEdgePairs<skeleton::model::Classic<3> >(grskel,nodes,edges);
+	build(nodes,edges);
+}
+
+algorithm::graphoperation::TreePathIndex::TreePathIndex(const skeleton::GraphProjSkel::Ptr grskel)
+{
+	std::vector<unsigned int> nodes(0);
+	std::vector<std::pair<unsigned int,unsigned int> > edges(0);
+	GetEdgePairs<skeleton::model::Projective>(grskel,nodes,edges);
+	build(nodes,edges);
+}
+
+algorithm::graphoperation::TreePathIndex::TreePathIndex(const skeleton::ReconstructionSkeleton::Ptr recskel)
+{
+	std::vector<unsigned int> nodes(0);
+	std::vector<std::pair<unsigned int,unsigned int> > edges(0);
+	GetEdgePairs(recskel,nodes,edges);
+	build(nodes,edges);
+}
+
+void algorithm::graphoperation::TreePathIndex::build(const std::vector<unsigned int> &nodes, const std::vector<std::pair<unsigned int,unsigned int> > &edges)
+{
+	unsigned int nbnodes = nodes.size();
+
+	m_node = nodes;
+	for(unsigned int i = 0; i < nbnodes; i++)
+		m_pos[nodes[i]] = i;
+
+	// adjacency, on dense positions
+	std::vector<std::vector<unsigned int> > adj(nbnodes);
+	for(unsigned int i = 0; i < edges.size(); i++)
+	{
+		unsigned int pos1 = getPos(edges[i].first);
+		unsigned int pos2 = getPos(edges[i].second);
+		adj[pos1].push_back(pos2);
+		adj[pos2].push_back(pos1);
+	}
+
+	unsigned int nblevels = 1;
+	while((1u << nblevels) < nbnodes)
+		nblevels++;
+
+	m_depth.assign(nbnodes,0);
+	m_comp.assign(nbnodes,nbnodes);
+	m_up.assign(nblevels,std::vector<unsigned int>(nbnodes,0));
+
+	/*
+	 *  Breadth first traversal of each component, from its first node
+	 */
+	std::vector<unsigned int> order(0);
+	order.reserve(nbnodes);
+	unsigned int nbcomp = 0;
+	for(unsigned int root = 0; root < nbnodes; root++)
+	{
+		if(m_comp[root] != nbnodes)
+			continue;
+
+		m_comp[root] = nbcomp;
+		m_up[0][root] = root;
+		order.push_back(root);
+
+		for(unsigned int cur = order.size()-1; cur < order.size(); cur++)
+		{
+			unsigned int pos = order[cur];
+			for(unsigned int j = 0; j < adj[pos].size(); j++)
+			{
+				unsigned int neigh = adj[pos][j];
+				if(m_comp[neigh] == nbnodes)
+				{
+					m_comp[neigh] = nbcomp;
+					m_depth[neigh] = m_depth[pos]+1;
+					m_up[0][neigh] = pos;
+					order.push_back(neigh);
+				}
+			}
+		}
+		nbcomp++;
+	}
+
+	// a forest has exactly (#nodes - #components) edges
+	if(edges.size() + nbcomp != nbnodes)
+		throw std::logic_error("algorithm::graphoperation::TreePathIndex : Skeleton contains a cycle");
+
+	for(unsigned int k = 1; k < nblevels; k++)
+	{
+		for(unsigned int i = 0; i < nbnodes; i++)
+		{
+			m_up[k][i] = m_up[k-1][ m_up[k-1][i] ];
+		}
+	}
+}
+
+unsigned int algorithm::graphoperation::TreePathIndex::getPos(unsigned int index) const
+{
+	std::map<unsigned int,unsigned int>::const_iterator it = m_pos.find(index);
+	if(it == m_pos.end())
+		throw std::logic_error("algorithm::graphoperation::TreePathIndex : Node index is not in the skeleton");
+	return it->second;
+}
+
+unsigned int algorithm::graphoperation::TreePathIndex::lca(unsigned int pos1, unsigned int pos2) const
+{
+	if(m_comp[pos1] != m_comp[pos2])
+		throw std::logic_error("algorithm::graphoperation::TreePathIndex : Nodes are not connected");
+
+	if(m_depth[pos1] < m_depth[pos2])
+		std::swap(pos1,pos2);
+
+	// bring pos1 at the same depth as pos2
+	unsigned int diff = m_depth[pos1] - m_depth[pos2];
+	for(unsigned int k = 0; diff != 0; k++, diff >>= 1)
+	{
+		if(diff & 1)
+			pos1 = m_up[k][pos1];
+	}
+
+	if(pos1 == pos2)
+		return pos1;
+
+	for(unsigned int k = m_up.size(); k > 0; k--)
+	{
+		if(m_up[k-1][pos1] != m_up[k-1][pos2])
+		{
+			pos1 = m_up[k-1][pos1];
+			pos2 = m_up[k-1][pos2];
+		}
+	}
+
+	return m_up[0][pos1];
+}
+
+bool algorithm::graphoperation::TreePathIndex::isNodeIn(unsigned int index) const
+{
+	return m_pos.find(index) != m_pos.end();
+}
+
+bool algorithm::graphoperation::TreePathIndex::areConnected(unsigned int ind1, unsigned int ind2) const
+{
+	return m_comp[getPos(ind1)] == m_comp[getPos(ind2)];
+}
+
+unsigned int algorithm::graphoperation::TreePathIndex::getPathLength(unsigned int ind1, unsigned int ind2) const
+{
+	unsigned int pos1 = getPos(ind1);
+	unsigned int pos2 = getPos(ind2);
+	unsigned int posa = lca(pos1,pos2);
+	return m_depth[pos1] + m_depth[pos2] - 2*m_depth[posa];
+}
+
+bool algorithm::graphoperation::TreePathIndex::isOnPath(unsigned int ind1, unsigned int ind2, unsigned int ind) const
+{
+	if(!areConnected(ind1,ind))
+		return false;
+	return getPathLength(ind1,ind) + getPathLength(ind,ind2) == getPathLength(ind1,ind2);
+}
+
+std::vector<unsigned int> algorithm::graphoperation::TreePathIndex::getPath(unsigned int ind1, unsigned int ind2) const
+{
+	unsigned int pos1 = getPos(ind1);
+	unsigned int pos2 = getPos(ind2);
+	unsigned int posa = lca(pos1,pos2);
+
+	std::vector<unsigned int> path(0);
+	path.reserve(m_depth[pos1] + m_depth[pos2] - 2*m_depth[posa] + 1);
+
+	// ascending part, from ind1 to the common ancestor
+	for(unsigned int pos = pos1; pos != posa; pos = m_up[0][pos])
+		path.push_back(m_node[pos]);
+	path.push_back(m_node[posa]);
+
+	// descending part, from the common ancestor to ind2
+	unsigned int mid = path.size();
+	for(unsigned int pos = pos2; pos != posa; pos = m_up[0][pos])
+		path.push_back(m_node[pos]);
+	std::reverse(path.begin()+mid,path.end());
+
+	return path;
+}
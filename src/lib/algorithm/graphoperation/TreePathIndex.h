@@ -0,0 +1,219 @@
+/*
+Copyright (c) 2016 Bastien Durix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/**
+ *  \file TreePathIndex.h
+ *  \brief Defines path queries index on acyclic skeletons
+ *  \author Bastien Durix
+ */
+
+#ifndef _TREEPATHINDEX_H_
+#define _TREEPATHINDEX_H_
+
+#include <skeleton/Skeletons.h>
+#include <vector>
+#include <map>
+
+/**
+ *  \brief Lots of algorithms
+ */
+namespace algorithm
+{
+	/**
+	 *  \brief Operations on graphs
+	 */
+	namespace graphoperation
+	{
+		/**
+		 *  \brief Path queries index on an acyclic skeleton (forest)
+		 *
+		 *  \details Each connected component is rooted, and ancestors are stored by binary lifting.
+		 *           Lowest common ancestor queries then cost O(log n), and path queries O(path length).
+		 *           The index is a snapshot: it has to be rebuilt if the skeleton is modified.
+		 */
+		class TreePathIndex
+		{
+			public:
+				/**
+				 *  \brief Shared pointer definition
+				 */
+				using Ptr = std::shared_ptr<TreePathIndex>;
+
+			protected:
+				/**
+				 *  \brief Dense position associated to each node index
+				 */
+				std::map<unsigned int,unsigned int> m_pos;
+
+				/**
+				 *  \brief Node index associated to each dense position
+				 */
+				std::vector<unsigned int> m_node;
+
+				/**
+				 *  \brief Depth of each node in its component
+				 */
+				std::vector<unsigned int> m_depth;
+
+				/**
+				 *  \brief Component of each node
+				 */
+				std::vector<unsigned int> m_comp;
+
+				/**
+				 *  \brief Ancestors table: m_up[k][i] is the 2^k-th ancestor of node i (roots are their own ancestors)
+				 */
+				std::vector<std::vector<unsigned int> > m_up;
+
+			public:
+				/**
+				 *  \brief Constructor
+				 *
+				 *  \param grskel skeleton to index
+				 *
+				 *  \throws std::logic_error if the skeleton contains a cycle
+				 */
+				TreePathIndex(const skeleton::GraphSkel2d::Ptr grskel);
+
+				/**
+				 *  \brief Constructor
+				 *
+				 *  \param grskel skeleton to index
+				 *
+				 *  \throws std::logic_error if the skeleton contains a cycle
+				 */
+				TreePathIndex(const skeleton::GraphSkel3d::Ptr grskel);
+
+				/**
+				 *  \brief Constructor
+				 *
+				 *  \param grskel skeleton to index
+				 *
+				 *  \throws std::logic_error if the skeleton contains a cycle
+				 */
+				TreePathIndex(const skeleton::GraphProjSkel::Ptr grskel);
+
+				/**
+				 *  \brief Constructor
+				 *
+				 *  \param recskel reconstruction skeleton to index
+				 *
+				 *  \throws std::logic_error if the skeleton contains a cycle
+				 */
+				TreePathIndex(const skeleton::ReconstructionSkeleton::Ptr recskel);
+
+			protected:
+				/**
+				 *  \brief Builds the index from the list of nodes and edges
+				 *
+				 *  \param nodes node indices
+				 *  \param edges edges, as couples of node indices
+				 *
+				 *  \throws std::logic_error if the graph contains a cycle
+				 */
+				void build(const std::vector<unsigned int> &nodes, const std::vector<std::pair<unsigned int,unsigned int> > &edges);
+
+				/**
+				 *  \brief Dense position getter
+				 *
+				 *  \param index node index
+				 *
+				 *  \return dense position of the node
+				 *
+				 *  \throws std::logic_error if the node is not indexed
+				 */
+				unsigned int getPos(unsigned int index) const;
+
+				/**
+				 *  \brief Lowest common ancestor, on dense positions
+				 *
+				 *  \param pos1 first position
+				 *  \param pos2 second position
+				 *
+				 *  \return position of the lowest common ancestor
+				 */
+				unsigned int lca(unsigned int pos1, unsigned int pos2) const;
+
+			public:
+				/**
+				 *  \brief Tests if the node index is in the index
+				 *
+				 *  \param index node index
+				 *
+				 *  \return true if the node is indexed
+				 */
+				bool isNodeIn(unsigned int index) const;
+
+				/**
+				 *  \brief Tests if two nodes are in the same connected component
+				 *
+				 *  \param ind1 first node index
+				 *  \param ind2 second node index
+				 *
+				 *  \return true if there is a path between the nodes
+				 *
+				 *  \throws std::logic_error if one of the nodes is not indexed
+				 */
+				bool areConnected(unsigned int ind1, unsigned int ind2) const;
+
+				/**
+				 *  \brief Number of edges on the path between two nodes
+				 *
+				 *  \param ind1 first node index
+				 *  \param ind2 second node index
+				 *
+				 *  \return path length
+				 *
+				 *  \throws std::logic_error if one of the nodes is not indexed, or if nodes are not connected
+				 */
+				unsigned int getPathLength(unsigned int ind1, unsigned int ind2) const;
+
+				/**
+				 *  \brief Tests if a node lies on the path between two nodes (extremities included)
+				 *
+				 *  \param ind1 first path extremity
+				 *  \param ind2 second path extremity
+				 *  \param ind  tested node
+				 *
+				 *  \return true if ind is on the path from ind1 to ind2
+				 *
+				 *  \throws std::logic_error if one of the nodes is not indexed, or if ind1 and ind2 are not connected
+				 */
+				bool isOnPath(unsigned int ind1, unsigned int ind2, unsigned int ind) const;
+
+				/**
+				 *  \brief Gets the nodes indices between two nodes
+				 *
+				 *  \param ind1 first node index
+				 *  \param ind2 last node index
+				 *
+				 *  \return node indices from ind1 to ind2 (both included)
+				 *
+				 *  \throws std::logic_error if one of the nodes is not indexed, or if nodes are not connected
+				 */
+				std::vector<unsigned int> getPath(unsigned int ind1, unsigned int ind2) const;
+		};
+	}
+}
+
+#endif //_TREEPATHINDEX_H_
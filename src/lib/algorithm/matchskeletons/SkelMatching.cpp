@@ -27,47 +27,112 @@ SOFTWARE.
  *  \author Bastien Durix
  */
 
-#include "SkelMatching.h"
+#include "SkelMatchingOde.h"
 #include <nlopt.hpp>
-#include <mathtools/application/Compositor.h>
+#include <mathtools/application/StaticCompositor.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace mathtools::application;
+using namespace algorithm::matchskeletons;
+
+/*
+ *  Line of a view at parameter t, and its derivative
+ */
+inline void EvalLine(const LineField &field, double t, Eigen::Matrix<double,8,1> &lin, Eigen::Matrix<double,8,1> &dlin)
+{
+	if(field.table)
+	{
+		// cubic hermite interpolation in the segment of t (extrapolated outside of [0,1])
+		const Eigen::Matrix<double,16,Eigen::Dynamic> &table = *field.table;
+		double h = 1.0/(double)(table.cols()-1);
+		int k = std::min(std::max((int)std::floor(t/h),0),(int)table.cols()-2);
+		double s = t/h - (double)k;
+		double s2 = s*s;
+		double s3 = s2*s;
+
+		lin = table.block<8,1>(0,k)*(2.0*s3 - 3.0*s2 + 1.0) + table.block<8,1>(8,k)*((s3 - 2.0*s2 + s)*h)
+			+ table.block<8,1>(0,k+1)*(3.0*s2 - 2.0*s3) + table.block<8,1>(8,k+1)*((s3 - s2)*h);
+		dlin = (table.block<8,1>(0,k+1) - table.block<8,1>(0,k))*((6.0*s - 6.0*s2)/h)
+			+ table.block<8,1>(8,k)*(3.0*s2 - 4.0*s + 1.0) + table.block<8,1>(8,k+1)*(3.0*s2 - 2.0*s);
+	}
+	else
+	{
+		// the node and its derivative come from one jet of the node function, the R8 conversion without virtual calls
+		using CompFun = skeleton::BranchContProjSkel::CompFun;
+		Eigen::Vector3d node;
+		derivativematrix<1,dimension<CompFun::outType>::value,dimension<CompFun::inType>::value>::type dnode;
+		derivativematrix<2,dimension<CompFun::outType>::value,dimension<CompFun::inType>::value>::type d2node;
+		field.branch->getCompFun()->jet(t,node,dnode,d2node);
+
+		Eigen::Matrix<double,8,3> jacr8;
+		field.branch->getModel()->getR8StaticFun().eval(node,lin,jacr8);
+		dlin = jacr8*Eigen::Map<Eigen::Vector3d>((double*)dnode.data());
+	}
+}
+
+LineField algorithm::matchskeletons::TabulateLine(const skeleton::BranchContProjSkel::Ptr branch, unsigned int nbnodes)
+{
+	LineField field;
+	field.branch = branch;
+
+	if(nbnodes >= 2)
+	{
+		std::shared_ptr<Eigen::Matrix<double,16,Eigen::Dynamic> > table(new Eigen::Matrix<double,16,Eigen::Dynamic>(16,nbnodes));
+		Eigen::Matrix<double,8,1> lin;
+		Eigen::Matrix<double,8,1> dlin;
+		for(unsigned int k = 0; k < nbnodes; k++)
+		{
+			EvalLine(field,(double)k/(double)(nbnodes-1),lin,dlin);
+			table->block<8,1>(0,k) = lin;
+			table->block<8,1>(8,k) = dlin;
+		}
+		field.table = table;
+	}
+
+	return field;
+}
 
-void Dist_grad(const Eigen::Matrix<double,Eigen::Dynamic,1> &t,
-			   const std::vector<skeleton::BranchContProjSkel::Ptr> &skel,
+/*
+ *  Distance between the lines of the views at parameters t, and its gradient
+ *  (Nb is the number of views, every temporary has a fixed size when it is known)
+ */
+template<int Nb>
+void Dist_grad(const Eigen::Matrix<double,Nb,1> &t,
+			   const std::vector<LineField> &skel,
 			   double &value,
-			   Eigen::Matrix<double,Eigen::Dynamic,1> &gradient)
+			   Eigen::Matrix<double,Nb,1> &gradient)
 {
 	Eigen::Matrix4d A = Eigen::Matrix4d::Zero();
 	Eigen::Vector4d b = Eigen::Vector4d::Zero();
 	value = 0.0;
-	gradient = Eigen::Matrix<double,Eigen::Dynamic,1>::Zero(t.rows(),1);
+	gradient = Eigen::Matrix<double,Nb,1>::Zero(t.rows(),1);
 
-	std::vector<Eigen::Vector4d> ori(skel.size());
-	std::vector<Eigen::Vector4d> vec(skel.size());
-	std::vector<Eigen::Vector4d> orijac(skel.size());
-	std::vector<Eigen::Vector4d> vecjac(skel.size());
-	std::vector<Eigen::Matrix4d> A_part_jac(skel.size());
-	std::vector<Eigen::Vector4d> b_part_jac(skel.size());
+	Eigen::Matrix<double,4,Nb> ori(4,skel.size());
+	Eigen::Matrix<double,4,Nb> vec(4,skel.size());
+	Eigen::Matrix<double,4,Nb> orijac(4,skel.size());
+	Eigen::Matrix<double,4,Nb> vecjac(4,skel.size());
+	Eigen::Matrix<double,4,Nb> b_part_jac(4,skel.size());
 
 	for(unsigned int i=0;i<skel.size();i++)
 	{
-		Compositor<Application<Eigen::Matrix<double,8,1>,Eigen::Vector3d>,Application<Eigen::Vector3d,double> >
-			fun(skel[i]->getModel()->getR8Fun(),skel[i]->getCompFun());
-		Eigen::Matrix<double,8,1> veclin = fun(t(i));
-		Eigen::Matrix<double,8,1> jaclin = fun.jac(t(i));
+		Eigen::Matrix<double,8,1> veclin;
+		Eigen::Matrix<double,8,1> jaclin;
+		EvalLine(skel[i],t(i),veclin,jaclin);
 
-		ori[i]  = veclin.block<4,1>(0,0);
-		vec[i]  = veclin.block<4,1>(4,0).normalized();
+		ori.col(i)  = veclin.block<4,1>(0,0);
+		vec.col(i)  = veclin.block<4,1>(4,0).normalized();
 
-		orijac[i] = jaclin.block<4,1>(0,0);
-		vecjac[i] = jaclin.block<4,1>(4,0)*(1.0/veclin.block<4,1>(4,0).norm());
+		orijac.col(i) = jaclin.block<4,1>(0,0);
+		vecjac.col(i) = jaclin.block<4,1>(4,0)*(1.0/veclin.block<4,1>(4,0).norm());
 
-		Eigen::Matrix4d A_part = Eigen::Matrix4d::Identity() - vec[i]*vec[i].transpose();
-		Eigen::Vector4d b_part = A_part*ori[i];
+		Eigen::Matrix4d A_part = Eigen::Matrix4d::Identity() - vec.col(i)*vec.col(i).transpose();
+		Eigen::Vector4d b_part = A_part*ori.col(i);
 
-		A_part_jac[i] = - vecjac[i]*vec[i].transpose() - vec[i]*vecjac[i].transpose();
-		b_part_jac[i] = A_part_jac[i] * ori[i] + A_part * orijac[i];
+		Eigen::Matrix4d A_part_jac = - vecjac.col(i)*vec.col(i).transpose() - vec.col(i)*vecjac.col(i).transpose();
+		b_part_jac.col(i) = A_part_jac * ori.col(i) + A_part * orijac.col(i);
 
 		A+=A_part;
 		b+=b_part;
@@ -78,20 +143,22 @@ void Dist_grad(const Eigen::Matrix<double,Eigen::Dynamic,1> &t,
 	Eigen::Vector4d P = A_inv*b;
 	for(unsigned int i=0;i<skel.size();i++)
 	{
-		Eigen::Vector4d P_jac = A_inv * A_part_jac[i] * P + A_inv * b_part_jac[i];
+		Eigen::Matrix4d A_part_jac = - vecjac.col(i)*vec.col(i).transpose() - vec.col(i)*vecjac.col(i).transpose();
+		Eigen::Vector4d P_jac = A_inv * A_part_jac * P + A_inv * b_part_jac.col(i);
 
-		double Dist = (P - ori[i]).squaredNorm() - pow((P - ori[i]).dot(vec[i]),2);
+		double Dist = (P - ori.col(i)).squaredNorm() - pow((P - ori.col(i)).dot(vec.col(i)),2);
 
-		gradient(i) =  2*(P_jac - orijac[i]).dot(P - ori[i])
-					  -2*(P_jac - orijac[i]).dot(vec[i]) * (P - ori[i]).dot(vec[i])
-					  -2*(P - ori[i]).dot(vecjac[i]) * (P - ori[i]).dot(vec[i]);
+		gradient(i) =  2*(P_jac - orijac.col(i)).dot(P - ori.col(i))
+					  -2*(P_jac - orijac.col(i)).dot(vec.col(i)) * (P - ori.col(i)).dot(vec.col(i))
+					  -2*(P - ori.col(i)).dot(vecjac.col(i)) * (P - ori.col(i)).dot(vec.col(i));
 
 		value += Dist;
 	}
 }
 
 //out of bounds
-bool Oob(const Eigen::Matrix<double,Eigen::Dynamic,1> &q)
+template<int Nb>
+bool Oob(const Eigen::Matrix<double,Nb,1> &q)
 {
 	for(unsigned int i=0;i<q.rows();i++)
 	{
@@ -101,14 +168,14 @@ bool Oob(const Eigen::Matrix<double,Eigen::Dynamic,1> &q)
 	return false;
 }
 
-double SolveODE(
+double algorithm::matchskeletons::SolveODE(
 		std::list<double> &list_val,
 		std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > &list_pos,
 		std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > &list_vit,
 		std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > &list_grad,
 		double &t_tot,
 		double &v_tot,
-		const std::vector<skeleton::BranchContProjSkel::Ptr> &skel,
+		const std::vector<LineField> &skel,
 		const Eigen::Matrix<double,Eigen::Dynamic,1> &q_init,
 		const Eigen::Matrix<double,Eigen::Dynamic,1> &v_init,
 		const double &lambda,
@@ -178,21 +245,499 @@ double SolveODE(
 	return df;
 }
 
-struct DataODE
+/*
+ *  Appends a state of the integration in the history buffer (positions, speeds, gradients, then values)
+ */
+template<int Nb>
+inline void PushState(
+		Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> &hist,
+		unsigned int &nbhist,
+		const Eigen::Matrix<double,Nb,1> &q,
+		const Eigen::Matrix<double,Nb,1> &v,
+		const Eigen::Matrix<double,Nb,1> &grad,
+		double val)
 {
-	std::vector<skeleton::BranchContProjSkel::Ptr> skel;
-	std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > list_pos;
-	std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > list_vit;
-	std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > list_grad;
-	std::list<double> list_val;
-	double t_tot;
-	double v_tot;
-	double deltat;
-	double lambda;
-	std::vector<double> vit_init;
+	// only happens if the path is much longer than expected
+	if(nbhist == hist.cols())
+		hist.conservativeResize(Eigen::NoChange,2*hist.cols());
+
+	hist.block(0,nbhist,q.rows(),1) = q;
+	hist.block(q.rows(),nbhist,q.rows(),1) = v;
+	hist.block(2*q.rows(),nbhist,q.rows(),1) = grad;
+	hist(3*q.rows(),nbhist) = val;
+	nbhist++;
+}
+
+/*
+ *  Same integration as SolveODE, for a fixed number of views Nb: states are fixed size vectors,
+ *  and the trajectory is written in the first nbhist columns of hist, reserved before the integration
+ */
+template<int Nb>
+double SolveODEFixed(
+		Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> &hist,
+		unsigned int &nbhist,
+		double &t_tot,
+		double &v_tot,
+		const std::vector<LineField> &skel,
+		const Eigen::Matrix<double,Nb,1> &q_init,
+		const Eigen::Matrix<double,Nb,1> &v_init,
+		const double &lambda,
+		const double &deltat)
+{
+	double value = 0.0;
+	double valuef = 0.0;
+	Eigen::Matrix<double,Nb,1> gradient;
+	Eigen::Matrix<double,Nb,1> gradientf;
+	v_tot = 0.0;
+	t_tot = 0.0;
+
+	// each step moves of deltat: a path of a few diagonals of the unit cube fits in the buffer
+	nbhist = 0;
+	if(hist.rows() != 3*Nb+1 || hist.cols() == 0)
+		hist.resize(3*Nb+1,(unsigned int)(4.0*std::sqrt((double)Nb)/deltat)+3);
+
+	Dist_grad(q_init,skel,valuef,gradientf);
+
+	PushState(hist,nbhist,q_init,v_init,gradientf,valuef);
+
+	//first step, to avoid boundary problem :
+	Eigen::Matrix<double,Nb,1> q = q_init + v_init * deltat;
+	Eigen::Matrix<double,Nb,1> v = v_init;
+
+	gradient = gradientf;
+	value    = valuef;
+	Dist_grad(q,skel,valuef,gradientf);
+
+	while(!Oob(q) && t_tot<10.0)
+	{
+		PushState(hist,nbhist,q,v,gradientf,valuef);
+
+		value = valuef;
+		gradient = gradientf;
+		Dist_grad(q,skel,valuef,gradientf);
+
+		double vnor = v.norm();
+
+		double frac = deltat/vnor;
+		v_tot+=(vnor*lambda + (value+valuef)/2.0)*frac;
+		t_tot += frac;
+
+		q += v*frac;
+		v += gradientf*(1.0/lambda)*frac;
+	}
+
+	Eigen::Matrix<double,Nb,1> qf = Eigen::Matrix<double,Nb,1>::Ones();
+	value = valuef;
+	gradient = gradientf;
+	Dist_grad(qf,skel,valuef,gradientf);
+
+	double df = (q-qf).norm();
+
+	v_tot+=df*lambda + ((valuef+value)/2.0)*df;
+
+	PushState(hist,nbhist,qf,v,gradientf,valuef);
+
+	return df;
+}
+
+/*
+ *  Dormand-Prince 5(4) coefficients: Runge-Kutta matrix, error weights (5th minus 4th order)
+ *  and coefficients of the 4th order continuous extension (the ode is autonomous, nodes are not needed)
+ */
+static const double DopriA[7][6] = {
+	{0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+	{1.0/5.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+	{3.0/40.0, 9.0/40.0, 0.0, 0.0, 0.0, 0.0},
+	{44.0/45.0, -56.0/15.0, 32.0/9.0, 0.0, 0.0, 0.0},
+	{19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0, -212.0/729.0, 0.0, 0.0},
+	{9017.0/3168.0, -355.0/33.0, 46732.0/5247.0, 49.0/176.0, -5103.0/18656.0, 0.0},
+	{35.0/384.0, 0.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0, 11.0/84.0}};
+
+static const double DopriE[7] = {71.0/57600.0, 0.0, -71.0/16695.0, 71.0/1920.0, -17253.0/339200.0, 22.0/525.0, -1.0/40.0};
+
+static const double DopriP[7][4] = {
+	{1.0, -8048581381.0/2820520608.0, 8663915743.0/2820520608.0, -12715105075.0/11282082432.0},
+	{0.0, 0.0, 0.0, 0.0},
+	{0.0, 131558114200.0/32700410799.0, -68118460800.0/10900136933.0, 87487479700.0/32700410799.0},
+	{0.0, -1754552775.0/470086768.0, 14199869525.0/1410260304.0, -10690763975.0/1880347072.0},
+	{0.0, 127303824393.0/49829197408.0, -318862633887.0/49829197408.0, 701980252875.0/199316789632.0},
+	{0.0, -282668133.0/205662961.0, 2019193451.0/616988883.0, -1453857185.0/822651844.0},
+	{0.0, 40617522.0/29380423.0, -110615467.0/29380423.0, 69997945.0/29380423.0}};
+
+/*
+ *  Size of the state of the adaptive integration: positions, speeds, arc length and cost
+ */
+template<int Nb>
+struct DopriState
+{
+	static constexpr int size = Nb == Eigen::Dynamic ? Eigen::Dynamic : 2*Nb+2;
+	using type = Eigen::Matrix<double,size,1>;
+};
+
+/*
+ *  Derivative of the state y = (q, v, s, V): q' = v, v' = grad/lambda, s' = |v|, V' = lambda |v| + dist
+ */
+template<int Nb>
+void DopriDerivative(
+		const typename DopriState<Nb>::type &y,
+		const std::vector<LineField> &skel,
+		const double &lambda,
+		typename DopriState<Nb>::type &dy,
+		double &value,
+		Eigen::Matrix<double,Nb,1> &gradient)
+{
+	unsigned int nb = skel.size();
+	Eigen::Matrix<double,Nb,1> q = y.segment(0,nb);
+	Dist_grad(q,skel,value,gradient);
+
+	double vnor = y.segment(nb,nb).norm();
+	dy.segment(0,nb) = y.segment(nb,nb);
+	dy.segment(nb,nb) = gradient*(1.0/lambda);
+	dy(2*nb) = vnor;
+	dy(2*nb+1) = vnor*lambda + value;
+}
+
+/*
+ *  State at y0 + theta*h, with the continuous extension of the step
+ */
+template<int Nb>
+void DopriDense(
+		const typename DopriState<Nb>::type &y0,
+		const std::array<typename DopriState<Nb>::type,7> &k,
+		double h,
+		double theta,
+		typename DopriState<Nb>::type &y)
+{
+	y = y0;
+	for(unsigned int i = 0; i < 7; i++)
+	{
+		double bi = theta*(DopriP[i][0] + theta*(DopriP[i][1] + theta*(DopriP[i][2] + theta*DopriP[i][3])));
+		if(bi != 0.0)
+			y += (h*bi)*k[i];
+	}
+}
+
+/*
+ *  Same problem as SolveODE, integrated by an embedded Dormand-Prince 5(4) scheme with step size control (tolerance tol)
+ *  The path is resampled every deltat of arc length of the continuous extension and written in hist
+ *  (with the gradient and value of the beginning of the step), the exit of the unit cube is located on the continuous extension
+ */
+template<int Nb>
+double SolveODEDopri(
+		Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> &hist,
+		unsigned int &nbhist,
+		double &t_tot,
+		double &v_tot,
+		const std::vector<LineField> &skel,
+		const Eigen::Matrix<double,Nb,1> &q_init,
+		const Eigen::Matrix<double,Nb,1> &v_init,
+		const double &lambda,
+		const double &deltat,
+		const double &tol)
+{
+	unsigned int nb = skel.size();
+	unsigned int nbstate = 2*nb+2;
+
+	// longest step, in the unit cube, to keep the exit location reliable
+	const double maxlength = 0.25;
+
+	nbhist = 0;
+	if(hist.rows() != 3*nb+1 || hist.cols() == 0)
+		hist.resize(3*nb+1,(unsigned int)(4.0*std::sqrt((double)nb)/deltat)+3);
+
+	typename DopriState<Nb>::type y0(nbstate), y1(nbstate), ys(nbstate), err(nbstate);
+	std::array<typename DopriState<Nb>::type,7> k;
+	for(unsigned int i = 0; i < 7; i++)
+		k[i].resize(nbstate);
+	y0.segment(0,nb) = q_init;
+	y0.segment(nb,nb) = v_init;
+	y0(2*nb) = 0.0;
+	y0(2*nb+1) = 0.0;
+
+	double value, value1;
+	Eigen::Matrix<double,Nb,1> gradient(nb), gradient1(nb);
+	DopriDerivative<Nb>(y0,skel,lambda,k[0],value,gradient);
+
+	PushState(hist,nbhist,q_init,v_init,gradient,value);
+	double nexts = deltat;
+
+	double tau = 0.0;
+	double h = deltat/v_init.norm();
+	bool out = false;
+	while(!out && tau<10.0 && h>1e-12)
+	{
+		h = std::min(std::min(h,maxlength/y0.segment(nb,nb).norm()),10.0-tau);
+
+		for(unsigned int i = 1; i < 7; i++)
+		{
+			ys = y0;
+			for(unsigned int j = 0; j < i; j++)
+				if(DopriA[i][j] != 0.0)
+					ys += (h*DopriA[i][j])*k[j];
+			DopriDerivative<Nb>(ys,skel,lambda,k[i],value1,gradient1);
+		}
+		y1 = ys;
+
+		err.setZero();
+		for(unsigned int i = 0; i < 7; i++)
+			if(DopriE[i] != 0.0)
+				err += (h*DopriE[i])*k[i];
+		double errnorm = 0.0;
+		for(unsigned int i = 0; i < nbstate; i++)
+		{
+			double sc = tol*(1.0 + std::max(std::abs(y0(i)),std::abs(y1(i))));
+			errnorm += (err(i)/sc)*(err(i)/sc);
+		}
+		errnorm = std::sqrt(errnorm/(double)nbstate);
+
+		if(errnorm > 1.0)
+		{
+			h *= std::max(0.2,0.9*std::pow(errnorm,-0.2));
+			continue;
+		}
+
+		// exit of the unit cube during the step
+		double theta = 1.0;
+		if(Oob(Eigen::Matrix<double,Nb,1>(y1.segment(0,nb))))
+		{
+			out = true;
+			double thetain = 0.0;
+			for(unsigned int it = 0; it < 40; it++)
+			{
+				double thetamid = 0.5*(thetain+theta);
+				DopriDense<Nb>(y0,k,h,thetamid,ys);
+				if(Oob(Eigen::Matrix<double,Nb,1>(ys.segment(0,nb))))
+					theta = thetamid;
+				else
+					thetain = thetamid;
+			}
+			DopriDense<Nb>(y0,k,h,theta,y1);
+		}
+
+		// resampling of the path every deltat of arc length
+		double s0 = y0(2*nb);
+		double s1 = y1(2*nb);
+		double thetas = 0.0;
+		while(nexts < s1)
+		{
+			// the speed varies along the step: the arc length of the continuous extension is inverted by Newton iterations
+			thetas = std::max(thetas,theta*(nexts-s0)/(s1-s0));
+			for(unsigned int it = 0; it < 10; it++)
+			{
+				DopriDense<Nb>(y0,k,h,thetas,ys);
+				double dtheta = (nexts-ys(2*nb))/(h*ys.segment(nb,nb).norm());
+				thetas = std::min(std::max(thetas+dtheta,0.0),theta);
+				if(std::abs(dtheta) < 1e-12)
+					break;
+			}
+			DopriDense<Nb>(y0,k,h,thetas,ys);
+			PushState(hist,nbhist,Eigen::Matrix<double,Nb,1>(ys.segment(0,nb)),Eigen::Matrix<double,Nb,1>(ys.segment(nb,nb)),gradient,value);
+			nexts += deltat;
+		}
+
+		tau += theta*h;
+		y0 = y1;
+		if(out)
+		{
+			Dist_grad(Eigen::Matrix<double,Nb,1>(y0.segment(0,nb)),skel,value,gradient);
+		}
+		else
+		{
+			// first same as last: the last stage is the derivative at the end of the step
+			k[0] = k[6];
+			value = value1;
+			gradient = gradient1;
+			h *= std::min(5.0,0.9*std::pow(std::max(errnorm,1e-10),-0.2));
+		}
+	}
+	t_tot = tau;
+
+	Eigen::Matrix<double,Nb,1> q = y0.segment(0,nb);
+	Eigen::Matrix<double,Nb,1> qf = Eigen::Matrix<double,Nb,1>::Ones(nb,1);
+	double valuef;
+	Eigen::Matrix<double,Nb,1> gradientf(nb);
+	Dist_grad(qf,skel,valuef,gradientf);
+
+	double df = (q-qf).norm();
+
+	v_tot = y0(2*nb+1) + df*lambda + ((valuef+value)/2.0)*df;
+
+	PushState(hist,nbhist,q,Eigen::Matrix<double,Nb,1>(y0.segment(nb,nb)),gradient,value);
+	PushState(hist,nbhist,qf,Eigen::Matrix<double,Nb,1>(y0.segment(nb,nb)),gradientf,valuef);
+
+	return df;
+}
+
+/*
+ *  Number of parameters of the initial speed, for Nb views
+ */
+template<int Nb>
+struct SpeedParam
+{
+	static constexpr int size = Nb == Eigen::Dynamic ? Eigen::Dynamic : Nb-1;
 };
 
-double minFunODE(const std::vector<double> &x, std::vector<double> &, void *dataFun)
+/*
+ *  Same integration as SolveODEFixed, differentiated with respect to the parameters of the initial speed:
+ *  the sensitivities of positions and speeds follow the Euler steps (the hessian of the distance being applied
+ *  by finite differences of its gradient), and give the gradient ddf of the returned distance
+ */
+template<int Nb>
+double SolveODETangent(
+		Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> &hist,
+		unsigned int &nbhist,
+		double &t_tot,
+		double &v_tot,
+		const std::vector<LineField> &skel,
+		const Eigen::Matrix<double,Nb,1> &q_init,
+		const Eigen::Matrix<double,Nb,1> &v_init,
+		const Eigen::Matrix<double,Nb,SpeedParam<Nb>::size> &dv_init,
+		const double &lambda,
+		const double &deltat,
+		std::vector<double> &ddf)
+{
+	unsigned int nb = skel.size();
+	double value = 0.0;
+	double valuef = 0.0;
+	double valueeps = 0.0;
+	Eigen::Matrix<double,Nb,1> gradient(nb);
+	Eigen::Matrix<double,Nb,1> gradientf(nb);
+	Eigen::Matrix<double,Nb,1> gradienteps(nb);
+	Eigen::Matrix<double,Nb,SpeedParam<Nb>::size> hdq(nb,nb-1);
+	v_tot = 0.0;
+	t_tot = 0.0;
+
+	nbhist = 0;
+	if(hist.rows() != 3*nb+1 || hist.cols() == 0)
+		hist.resize(3*nb+1,(unsigned int)(4.0*std::sqrt((double)nb)/deltat)+3);
+
+	Dist_grad(q_init,skel,valuef,gradientf);
+
+	PushState(hist,nbhist,q_init,v_init,gradientf,valuef);
+
+	//first step, to avoid boundary problem :
+	Eigen::Matrix<double,Nb,1> q = q_init + v_init * deltat;
+	Eigen::Matrix<double,Nb,1> v = v_init;
+	Eigen::Matrix<double,Nb,SpeedParam<Nb>::size> dq = dv_init * deltat;
+	Eigen::Matrix<double,Nb,SpeedParam<Nb>::size> dv = dv_init;
+
+	gradient = gradientf;
+	value    = valuef;
+	Dist_grad(q,skel,valuef,gradientf);
+
+	while(!Oob(q) && t_tot<10.0)
+	{
+		PushState(hist,nbhist,q,v,gradientf,valuef);
+
+		value = valuef;
+		gradient = gradientf;
+		Dist_grad(q,skel,valuef,gradientf);
+
+		double vnor = v.norm();
+
+		double frac = deltat/vnor;
+		v_tot+=(vnor*lambda + (value+valuef)/2.0)*frac;
+		t_tot += frac;
+
+		// hessian of the distance along the position sensitivities
+		for(unsigned int j = 0; j < nb-1; j++)
+		{
+			double nor = dq.col(j).norm();
+			if(nor > 0.0)
+			{
+				double eps = 1e-6/nor;
+				Dist_grad(Eigen::Matrix<double,Nb,1>(q + dq.col(j)*eps),skel,valueeps,gradienteps);
+				hdq.col(j) = (gradienteps - gradientf)*(1.0/eps);
+			}
+			else
+				hdq.col(j).setZero();
+		}
+
+		Eigen::Matrix<double,1,SpeedParam<Nb>::size> dfrac = (v.transpose()*dv)*(-frac/(vnor*vnor));
+		dq += dv*frac + v*dfrac;
+		dv += hdq*(frac/lambda) + gradientf*(dfrac*(1.0/lambda));
+
+		q += v*frac;
+		v += gradientf*(1.0/lambda)*frac;
+	}
+
+	Eigen::Matrix<double,Nb,1> qf = Eigen::Matrix<double,Nb,1>::Ones(nb,1);
+	value = valuef;
+	gradient = gradientf;
+	Dist_grad(qf,skel,valuef,gradientf);
+
+	double df = (q-qf).norm();
+
+	ddf.resize(nb-1);
+	for(unsigned int j = 0; j < nb-1; j++)
+		ddf[j] = df > 0.0 ? (q-qf).dot(dq.col(j))/df : 0.0;
+
+	v_tot+=df*lambda + ((valuef+value)/2.0)*df;
+
+	PushState(hist,nbhist,qf,v,gradientf,valuef);
+
+	return df;
+}
+
+/*
+ *  Adaptive integration from the origin
+ */
+template<int Nb>
+double SolveODEDopri(DataODE *data, const Eigen::Matrix<double,Eigen::Dynamic,1> &v_init)
+{
+	return SolveODEDopri<Nb>(
+			data->hist,
+			data->nbhist,
+			data->t_tot,
+			data->v_tot,
+			data->skel,
+			Eigen::Matrix<double,Nb,1>::Zero(v_init.rows(),1),
+			v_init,
+			data->lambda,
+			data->deltat,
+			data->odetol);
+}
+
+/*
+ *  Fixed size integration from the origin
+ */
+template<int Nb>
+double SolveODEFixed(DataODE *data, const Eigen::Matrix<double,Eigen::Dynamic,1> &v_init)
+{
+	return SolveODEFixed<Nb>(
+			data->hist,
+			data->nbhist,
+			data->t_tot,
+			data->v_tot,
+			data->skel,
+			Eigen::Matrix<double,Nb,1>::Zero(),
+			v_init,
+			data->lambda,
+			data->deltat);
+}
+
+/*
+ *  Initial speed of the path, parameterized by angles x, and its derivatives with respect to the angles
+ */
+void InitSpeed(const std::vector<double> &x,
+			   Eigen::Matrix<double,Eigen::Dynamic,1> &v_init,
+			   Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> &dv_init)
+{
+	v_init = Eigen::Matrix<double,Eigen::Dynamic,1>::Zero(x.size()+1,1);
+	dv_init = Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic>::Zero(x.size()+1,x.size());
+	v_init(0,0) = 1.0;
+	for(unsigned int i=0;i<x.size();i++)
+	{
+		dv_init *= cos(x[i]);
+		dv_init.col(i) -= v_init*sin(x[i]);
+		v_init *= cos(x[i]);
+		v_init(i+1,0) = sin(x[i]);
+		dv_init.row(i+1).setZero();
+		dv_init(i+1,i) = cos(x[i]);
+	}
+}
+
+double algorithm::matchskeletons::minFunODE(const std::vector<double> &x, std::vector<double> &, void *dataFun)
 {
 	DataODE *data = (DataODE*) dataFun;
 
@@ -200,16 +745,38 @@ double minFunODE(const std::vector<double> &x, std::vector<double> &, void *data
 	data->list_vit.erase(data->list_vit.begin(),data->list_vit.end());
 	data->list_grad.erase(data->list_grad.begin(),data->list_grad.end());
 	data->list_val.erase(data->list_val.begin(),data->list_val.end());
+	data->nbhist = 0;
 	data->t_tot = 0.0;
 	data->v_tot = 0.0;
 
-	Eigen::Matrix<double,Eigen::Dynamic,1> v_init(x.size()+1,1);
-	v_init *= 0;
-	v_init(0,0) = 1.0;
-	for(unsigned int i=0;i<x.size();i++)
+	Eigen::Matrix<double,Eigen::Dynamic,1> v_init;
+	Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> dv_init;
+	InitSpeed(x,v_init,dv_init);
+
+	if(data->integrator == algorithm::matchskeletons::OptionsMatch::enum_integrator::dopri)
 	{
-		v_init *= cos(x[i]);
-		v_init(i+1,0) = sin(x[i]);
+		switch(x.size()+1)
+		{
+			case 2:
+				return SolveODEDopri<2>(data,v_init);
+			case 3:
+				return SolveODEDopri<3>(data,v_init);
+			case 4:
+				return SolveODEDopri<4>(data,v_init);
+			default:
+				return SolveODEDopri<Eigen::Dynamic>(data,v_init);
+		}
+	}
+
+	// common numbers of views are integrated without any allocation
+	switch(x.size()+1)
+	{
+		case 2:
+			return SolveODEFixed<2>(data,v_init);
+		case 3:
+			return SolveODEFixed<3>(data,v_init);
+		case 4:
+			return SolveODEFixed<4>(data,v_init);
 	}
 
 	double val = SolveODE(
@@ -228,13 +795,99 @@ double minFunODE(const std::vector<double> &x, std::vector<double> &, void *data
 	return val;
 }
 
+double algorithm::matchskeletons::minFunODEGrad(const std::vector<double> &x, std::vector<double> &grad, void *dataFun)
+{
+	if(grad.empty())
+		return minFunODE(x,grad,dataFun);
+
+	DataODE *data = (DataODE*) dataFun;
+
+	// the adaptive integrator is differentiated by central differences, with a step of the order of its tolerance:
+	// a smaller step differentiates the error control, a larger one crosses the changes of the integration steps
+	if(data->integrator == algorithm::matchskeletons::OptionsMatch::enum_integrator::dopri)
+	{
+		double h = std::min(std::max(data->odetol,1e-6),1e-2);
+		std::vector<double> tmp;
+		std::vector<double> xeps = x;
+		std::vector<double> fp(x.size()), fm(x.size()), hp(x.size()), hm(x.size());
+		for(unsigned int i = 0; i < x.size(); i++)
+		{
+			// steps stay in the bounds of the angles (one sided on a bound)
+			hp[i] = std::min(h,M_PI/2.0 - x[i]);
+			hm[i] = std::min(h,x[i]);
+			if(hp[i] > 0.0)
+			{
+				xeps[i] = x[i] + hp[i];
+				fp[i] = minFunODE(xeps,tmp,dataFun);
+			}
+			if(hm[i] > 0.0)
+			{
+				xeps[i] = x[i] - hm[i];
+				fm[i] = minFunODE(xeps,tmp,dataFun);
+			}
+			xeps[i] = x[i];
+		}
+		double val = minFunODE(x,tmp,dataFun);
+		for(unsigned int i = 0; i < x.size(); i++)
+		{
+			if(hp[i] <= 0.0)
+				fp[i] = val;
+			if(hm[i] <= 0.0)
+				fm[i] = val;
+			grad[i] = (fp[i] - fm[i])/(hp[i] + hm[i]);
+		}
+		return val;
+	}
+
+	data->list_pos.erase(data->list_pos.begin(),data->list_pos.end());
+	data->list_vit.erase(data->list_vit.begin(),data->list_vit.end());
+	data->list_grad.erase(data->list_grad.begin(),data->list_grad.end());
+	data->list_val.erase(data->list_val.begin(),data->list_val.end());
+
+	Eigen::Matrix<double,Eigen::Dynamic,1> v_init;
+	Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> dv_init;
+	InitSpeed(x,v_init,dv_init);
+
+	switch(x.size()+1)
+	{
+		case 2:
+			return SolveODETangent<2>(data->hist,data->nbhist,data->t_tot,data->v_tot,data->skel,
+					Eigen::Matrix<double,2,1>::Zero(),v_init,dv_init,data->lambda,data->deltat,grad);
+		case 3:
+			return SolveODETangent<3>(data->hist,data->nbhist,data->t_tot,data->v_tot,data->skel,
+					Eigen::Matrix<double,3,1>::Zero(),v_init,dv_init,data->lambda,data->deltat,grad);
+		case 4:
+			return SolveODETangent<4>(data->hist,data->nbhist,data->t_tot,data->v_tot,data->skel,
+					Eigen::Matrix<double,4,1>::Zero(),v_init,dv_init,data->lambda,data->deltat,grad);
+		default:
+			return SolveODETangent<Eigen::Dynamic>(data->hist,data->nbhist,data->t_tot,data->v_tot,data->skel,
+					Eigen::Matrix<double,Eigen::Dynamic,1>::Zero(x.size()+1,1),v_init,dv_init,data->lambda,data->deltat,grad);
+	}
+}
+
 double FindSpeed(DataODE &data)
 {
 	Eigen::Matrix<double,Eigen::Dynamic,1> q = Eigen::Matrix<double,Eigen::Dynamic,1>::Zero(data.skel.size(),1); //starting point
 	
 	std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > list_pos;
 	
-	nlopt::opt opt(nlopt::LN_COBYLA, data.skel.size()-1);
+	nlopt::algorithm algo = nlopt::LN_COBYLA;
+	switch(data.speedoptim)
+	{
+		case algorithm::matchskeletons::OptionsMatch::enum_speedoptim::cobyla:
+			algo = nlopt::LN_COBYLA;
+			break;
+		case algorithm::matchskeletons::OptionsMatch::enum_speedoptim::mma:
+			algo = nlopt::LD_MMA;
+			break;
+		case algorithm::matchskeletons::OptionsMatch::enum_speedoptim::slsqp:
+			algo = nlopt::LD_SLSQP;
+			break;
+		case algorithm::matchskeletons::OptionsMatch::enum_speedoptim::lbfgs:
+			algo = nlopt::LD_LBFGS;
+			break;
+	}
+	nlopt::opt opt(algo, data.skel.size()-1);
 	
 	std::vector<double> lb(data.skel.size()-1);
 	std::vector<double> ub(data.skel.size()-1);
@@ -245,10 +898,16 @@ double FindSpeed(DataODE &data)
 		ub[i] = M_PI/2.0;
 		vit_init[i] = M_PI/4.0;
 	}
+	if(data.vit_start.size() == vit_init.size())
+		for(unsigned int i = 0;i<vit_init.size();i++)
+			vit_init[i] = std::min(std::max(data.vit_start[i],lb[i]),ub[i]);
 	opt.set_lower_bounds(lb);
 	opt.set_upper_bounds(ub);
 
-	opt.set_min_objective(minFunODE, &data);
+	if(algo == nlopt::LN_COBYLA)
+		opt.set_min_objective(minFunODE, &data);
+	else
+		opt.set_min_objective(minFunODEGrad, &data);
 	
 	opt.set_xtol_rel(1e-4);
 	
@@ -270,31 +929,249 @@ double FindSpeed(DataODE &data)
 	return val;
 }
 
+/*
+ *  Sweep of vec_lambda from beg to end by batches of nbbatch lambdas evaluated concurrently,
+ *  data gets the path of the first successful lambda, whose index is returned (-1 if none succeeds)
+ *  (nbspeed is increased by the number of speed optimizations)
+ */
+int SweepLambda(DataODE &data, const algorithm::matchskeletons::OptionsMatch &options,
+				const std::vector<double> &vec_lambda, unsigned int beg, unsigned int end, unsigned int nbbatch,
+				unsigned int &nbspeed)
+{
+	// batches are evaluated in order, and stop on the first success
+	int found = -1;
+	for(; beg < end && found == -1; beg+=nbbatch)
+	{
+		unsigned int endbatch = std::min(beg+nbbatch,end);
+		std::vector<DataODE> vec_data(endbatch-beg,data);
+		std::vector<double> vec_minf(endbatch-beg);
+
+		#pragma omp parallel for if(nbbatch > 1)
+		for(int i = 0; i < (int)(endbatch-beg); i++)
+		{
+			vec_data[i].lambda = vec_lambda[beg+i];
+			vec_minf[i] = FindSpeed(vec_data[i]);
+		}
+		nbspeed += endbatch-beg;
+
+		for(unsigned int i = 0; i < endbatch-beg && found == -1; i++)
+		{
+			if(vec_minf[i]<=options.deltat)
+			{
+				found = beg+i;
+				data = vec_data[i];
+			}
+		}
+
+		// the next batch starts from the optimum of the largest lambda
+		if(data.warmstart && found == -1)
+			data.vit_start = vec_data[endbatch-beg-1].vit_init;
+	}
+	return found;
+}
+
+/*
+ *  Linear sweep of lambda from lambdamin to lambdamax, data gets the path of the smallest successful lambda
+ *  (with a starting lambda, the sweep goes up from it, then down while lambda succeeds,
+ *  and the lambdas below the starting one are swept if none above succeeds)
+ *  (nbspeed gets the number of speed optimizations)
+ */
+bool LinearLambdaSearch(DataODE &data, const algorithm::matchskeletons::OptionsMatch &options, unsigned int &nbspeed)
+{
+	// swept values of lambda, accumulated as in the sequential sweep
+	std::vector<double> vec_lambda(0);
+	double lambda = options.lambdamin;
+	do{
+		vec_lambda.push_back(lambda);
+		lambda+=options.lambdastep;
+	}while(lambda<options.lambdamax);
+
+	unsigned int first = 0;
+	if(data.lambdastart != 0.0)
+		for(unsigned int i = 1; i < vec_lambda.size(); i++)
+			if(std::abs(vec_lambda[i]-data.lambdastart) < std::abs(vec_lambda[first]-data.lambdastart))
+				first = i;
+
+	unsigned int nbbatch = 1;
+#ifdef _OPENMP
+	// inside a parallel branch matching, threads are already busy
+	if(options.parallel && !omp_in_parallel())
+		nbbatch = omp_get_max_threads();
+#endif
+
+	// the smallest lambda giving a path to the end is kept
+	std::vector<double> vit_start = data.vit_start;
+	nbspeed = 0;
+	int found = SweepLambda(data,options,vec_lambda,first,vec_lambda.size(),nbbatch,nbspeed);
+
+	// no lambda succeeds from the starting one: the smaller ones are swept from the warm start speed
+	if(found == -1 && first != 0)
+	{
+		data.vit_start = vit_start;
+		found = SweepLambda(data,options,vec_lambda,0,first,nbbatch,nbspeed);
+	}
+
+	// smaller lambdas than the starting one
+	if(found == (int)first && first != 0)
+	{
+		DataODE cur = data;
+		do{
+			if(cur.warmstart)
+				cur.vit_start = cur.vit_init;
+			cur.lambda = vec_lambda[found-1];
+			nbspeed++;
+			if(FindSpeed(cur)<=options.deltat)
+			{
+				found--;
+				data = cur;
+			}
+			else
+				break;
+		}while(found != 0);
+	}
+
+	// as in the sequential sweep, a success on the last lambda is not kept
+	return found != -1 && found+1 < (int)vec_lambda.size();
+}
+
+/*
+ *  Exponential bracketing of the smallest successful lambda, then bisection down to lambdatol,
+ *  data gets the path of the smallest successful lambda found
+ *  (with a starting lambda, the bracketing halves it while it succeeds, or doubles it until it succeeds)
+ *  (nbspeed gets the number of speed optimizations)
+ */
+bool BisectionLambdaSearch(DataODE &data, const algorithm::matchskeletons::OptionsMatch &options, unsigned int &nbspeed)
+{
+	DataODE cur = data;
+	nbspeed = 1;
+
+	// bracketing: lambdamin, 2*lambdamin, 4*lambdamin... up to lambdamax
+	double lambdafail = 0.0;
+	cur.lambda = options.lambdamin;
+	if(data.lambdastart != 0.0)
+		cur.lambda = std::min(std::max(data.lambdastart,options.lambdamin),options.lambdamax);
+	bool success = FindSpeed(cur)<=options.deltat;
+	while(!success && cur.lambda<options.lambdamax)
+	{
+		lambdafail = cur.lambda;
+		cur.lambda = std::min(2.0*cur.lambda,options.lambdamax);
+		if(cur.warmstart)
+			cur.vit_start = cur.vit_init;
+		nbspeed++;
+		success = FindSpeed(cur)<=options.deltat;
+	}
+
+	if(!success)
+		return false;
+	data = cur;
+
+	// bracketing down from a successful starting lambda
+	while(lambdafail == 0.0 && data.lambda>options.lambdamin)
+	{
+		cur.lambda = std::max(0.5*data.lambda,options.lambdamin);
+		if(cur.warmstart)
+			cur.vit_start = cur.vit_init;
+		nbspeed++;
+		if(FindSpeed(cur)<=options.deltat)
+			data = cur;
+		else
+			lambdafail = cur.lambda;
+	}
+
+	// bisection between the last failure and the smallest success
+	if(lambdafail != 0.0)
+	{
+		double lambdasuccess = data.lambda;
+		while(lambdasuccess-lambdafail>options.lambdatol)
+		{
+			cur.lambda = 0.5*(lambdafail+lambdasuccess);
+			// bracket narrower than the floating point precision
+			if(cur.lambda <= lambdafail || cur.lambda >= lambdasuccess)
+				break;
+			if(cur.warmstart)
+				cur.vit_start = cur.vit_init;
+			nbspeed++;
+			if(FindSpeed(cur)<=options.deltat)
+			{
+				lambdasuccess = cur.lambda;
+				data = cur;
+			}
+			else
+				lambdafail = cur.lambda;
+		}
+	}
+
+	// as in the linear search, a success on lambdamax only is not kept
+	return data.lambda < options.lambdamax;
+}
+
+/*
+ *  Ode matching of a branch, warm started if warmstart is not null
+ */
 void SkelMatchingOde(
 		skeleton::ReconstructionBranch::Ptr recbranch,
 		const std::vector<skeleton::BranchContProjSkel::Ptr> projbr,
-		const algorithm::matchskeletons::OptionsMatch &options)
+		const algorithm::matchskeletons::OptionsMatch &options,
+		algorithm::matchskeletons::WarmStart *warmstart)
 {
 	DataODE data;
-	data.skel = projbr;
+	data.skel.resize(projbr.size());
+	for(unsigned int i = 0; i < projbr.size(); i++)
+		data.skel[i] = TabulateLine(projbr[i],options.linefield);
 	data.deltat = options.deltat;
-	data.lambda = options.lambdamin;
+	data.nbhist = 0;
+	data.integrator = options.integrator;
+	data.odetol = options.odetol;
+	data.speedoptim = options.speedoptim;
+	data.warmstart = false;
+	data.lambdastart = 0.0;
+	if(warmstart)
+	{
+		data.warmstart = true;
+		data.vit_start = warmstart->speed;
+		data.lambdastart = warmstart->lambda;
+	}
 
-	double minf;
-	do{
-		minf = FindSpeed(data);
-		data.lambda+=options.lambdastep;
-	}while(minf>options.deltat && data.lambda<options.lambdamax);
+	bool success = false;
+	unsigned int nbspeed = 0;
+	switch(options.lambdasearch)
+	{
+		case algorithm::matchskeletons::OptionsMatch::enum_lambdasearch::linear:
+			success = LinearLambdaSearch(data,options,nbspeed);
+			break;
+		case algorithm::matchskeletons::OptionsMatch::enum_lambdasearch::bisection:
+			success = BisectionLambdaSearch(data,options,nbspeed);
+			break;
+	}
+	if(warmstart)
+		warmstart->nbspeed = nbspeed;
 	
 	std::vector<Eigen::Matrix<double,Eigen::Dynamic,1> > vectcoords;
-	if(data.lambda<options.lambdamax)
+	if(success)
 	{
-		vectcoords.resize(data.list_pos.size());
-		unsigned int ind = 0;
-		for(std::list<Eigen::Matrix<double,Eigen::Dynamic,1> >::iterator it = data.list_pos.begin(); it != data.list_pos.end() ;it++)
+		if(warmstart)
+		{
+			warmstart->speed = data.vit_init;
+			warmstart->lambda = data.lambda;
+		}
+
+		if(data.nbhist != 0)
+		{
+			vectcoords.resize(data.nbhist);
+			for(unsigned int i = 0; i < data.nbhist; i++)
+			{
+				vectcoords[i] = data.hist.block(0,i,projbr.size(),1);
+			}
+		}
+		else
 		{
-			vectcoords[ind] = *it;
-			ind++;
+			vectcoords.resize(data.list_pos.size());
+			unsigned int ind = 0;
+			for(std::list<Eigen::Matrix<double,Eigen::Dynamic,1> >::iterator it = data.list_pos.begin(); it != data.list_pos.end() ;it++)
+			{
+				vectcoords[ind] = *it;
+				ind++;
+			}
 		}
 	}
 	else
@@ -309,27 +1186,38 @@ void SkelMatchingOde(
 	recbranch->setMatch(vectcoords);
 }
 
-void algorithm::matchskeletons::BranchMatching(
+/*
+ *  Branch matching, warm started if warmstart is not null
+ */
+void MatchBranch(
 		skeleton::ReconstructionBranch::Ptr recbranch,
 		const std::vector<skeleton::BranchContProjSkel::Ptr> projbr,
-		const OptionsMatch &options)
+		const algorithm::matchskeletons::OptionsMatch &options,
+		algorithm::matchskeletons::WarmStart *warmstart)
 {
 	switch(options.methodmatch)
 	{
-		case OptionsMatch::enum_methodmatch::ode:
-			SkelMatchingOde(recbranch,projbr,options);
+		case algorithm::matchskeletons::OptionsMatch::enum_methodmatch::ode:
+			SkelMatchingOde(recbranch,projbr,options,warmstart);
 			break;
 	}
 }
 
-void algorithm::matchskeletons::ComposedMatching(
+/*
+ *  Matching of all the branches of a skeleton, warm started if warmstart is not null
+ */
+void MatchSkeleton(
 		skeleton::ReconstructionSkeleton::Ptr recskel,
 		const std::vector<skeleton::CompContProjSkel::Ptr> projskel,
-		const OptionsMatch &options)
+		const algorithm::matchskeletons::OptionsMatch &options,
+		std::map<unsigned int,algorithm::matchskeletons::WarmStart> *warmstart)
 {
 	std::list<unsigned int> l_edge;
 	recskel->getAllEdges(l_edge);
 
+	std::vector<skeleton::ReconstructionBranch::Ptr> vec_recbr(0);
+	std::vector<std::vector<skeleton::BranchContProjSkel::Ptr> > vec_projbr(0);
+	std::vector<algorithm::matchskeletons::WarmStart*> vec_warm(0);
 	for(std::list<unsigned int>::iterator it = l_edge.begin(); it != l_edge.end(); it++)
 	{
 		skeleton::ReconstructionBranch::Ptr recbr = recskel->getBranch(*it);
@@ -341,6 +1229,56 @@ void algorithm::matchskeletons::ComposedMatching(
 			projbr[i] = projskel[recbr->getIndSkel()[i]]->getBranch(ext.first,ext.second);
 		}
 
-		BranchMatching(recbr,projbr,options);
+		vec_recbr.push_back(recbr);
+		vec_projbr.push_back(projbr);
+		// warm starts are inserted before the matching, each branch then updates its own one
+		vec_warm.push_back(warmstart ? &(*warmstart)[*it] : NULL);
+	}
+
+	// branches are matched on copies, written back in edge order
+	std::vector<skeleton::ReconstructionBranch::Ptr> vec_match(vec_recbr.size());
+	#pragma omp parallel for schedule(dynamic) if(options.parallelbranches)
+	for(int i = 0; i < (int)vec_recbr.size(); i++)
+	{
+		vec_match[i] = skeleton::ReconstructionBranch::Ptr(new skeleton::ReconstructionBranch(*vec_recbr[i]));
+		MatchBranch(vec_match[i],vec_projbr[i],options,vec_warm[i]);
 	}
+
+	for(unsigned int i = 0; i < vec_recbr.size(); i++)
+		if(vec_match[i]->isMatched())
+			vec_recbr[i]->setMatch(vec_match[i]->getMatch());
+}
+
+void algorithm::matchskeletons::BranchMatching(
+		skeleton::ReconstructionBranch::Ptr recbranch,
+		const std::vector<skeleton::BranchContProjSkel::Ptr> projbr,
+		const OptionsMatch &options)
+{
+	MatchBranch(recbranch,projbr,options,NULL);
+}
+
+void algorithm::matchskeletons::BranchMatching(
+		skeleton::ReconstructionBranch::Ptr recbranch,
+		const std::vector<skeleton::BranchContProjSkel::Ptr> projbr,
+		WarmStart &warmstart,
+		const OptionsMatch &options)
+{
+	MatchBranch(recbranch,projbr,options,&warmstart);
+}
+
+void algorithm::matchskeletons::ComposedMatching(
+		skeleton::ReconstructionSkeleton::Ptr recskel,
+		const std::vector<skeleton::CompContProjSkel::Ptr> projskel,
+		const OptionsMatch &options)
+{
+	MatchSkeleton(recskel,projskel,options,NULL);
+}
+
+void algorithm::matchskeletons::ComposedMatching(
+		skeleton::ReconstructionSkeleton::Ptr recskel,
+		const std::vector<skeleton::CompContProjSkel::Ptr> projskel,
+		std::map<unsigned int,WarmStart> &warmstart,
+		const OptionsMatch &options)
+{
+	MatchSkeleton(recskel,projskel,options,&warmstart);
 }
@@ -31,6 +31,7 @@ SOFTWARE.
 #define _SKELMATCHING_H_
 
 #include <skeleton/Skeletons.h>
+#include <map>
 
 /**
  *  \brief Lots of algorithms
@@ -60,6 +61,25 @@ namespace algorithm
 			 */
 			enum_methodmatch methodmatch;
 			
+			/**
+			 *  \brief Several searches of the smallest lambda giving a matching
+			 *
+			 *  \details linear tries every lambdastep from lambdamin to lambdamax,
+			 *           bisection brackets lambda by doubling it from lambdamin, then bisects down to lambdatol
+			 *           (it assumes that lambdas larger than a successful one also succeed).
+			 *           Both searches fail if only lambdamax, or the last lambda of the linear sweep, succeeds.
+			 */
+			enum enum_lambdasearch
+			{
+				linear = 0,
+				bisection
+			};
+			
+			/**
+			 *  \brief Lambda search method
+			 */
+			enum_lambdasearch lambdasearch;
+			
 			/**
 			 *  \brief Min weight of the distance function between the lines (>0)
 			 */
@@ -75,16 +95,115 @@ namespace algorithm
 			 */
 			double lambdastep;
 			
+			/**
+			 *  \brief Precision on lambda of the bisection search (the bisection also stops at the floating point precision)
+			 */
+			double lambdatol;
+			
 			/**
 			 *  \brief Time between two step for ODE
 			 */
 			double deltat;
 			
+			/**
+			 *  \brief Several integrators of the matching ode
+			 *
+			 *  \details euler takes steps of deltat,
+			 *           dopri is an embedded Dormand-Prince 5(4) scheme with step size control, resampled every deltat
+			 */
+			enum enum_integrator
+			{
+				euler = 0,
+				dopri
+			};
+			
+			/**
+			 *  \brief Integrator of the matching ode
+			 */
+			enum_integrator integrator;
+			
+			/**
+			 *  \brief Error tolerance of the dopri integrator, on each state component relative to 1 + its magnitude
+			 */
+			double odetol;
+			
+			/**
+			 *  \brief Several optimizers of the initial speed
+			 *
+			 *  \details cobyla is derivative free, mma, slsqp and lbfgs use the gradient of the distance
+			 *           between the end of the path and the end of the branches (differentiated along the euler integration,
+			 *           by finite differences with the dopri integrator). A gradient evaluation costs about as much
+			 *           as one objective evaluation per view, so they pay off when they need that many fewer evaluations.
+			 */
+			enum enum_speedoptim
+			{
+				cobyla = 0,
+				mma,
+				slsqp,
+				lbfgs
+			};
+			
+			/**
+			 *  \brief Optimizer of the initial speed
+			 */
+			enum_speedoptim speedoptim;
+			
+			/**
+			 *  \brief Number of nodes of the tables of lines of the views, interpolated by cubic hermite splines during the integration
+			 *          (0 evaluates the branches at each step)
+			 */
+			unsigned int linefield;
+			
+			/**
+			 *  \brief Evaluates batches of lambda values concurrently in the linear search
+			 *
+			 *  \details Same result as the sequential sweep, except with a warm start:
+			 *           a batch then starts from the optimum of the previous batch, which depends on the batch size
+			 */
+			bool parallel;
+			
+			/**
+			 *  \brief Matches the branches of a skeleton concurrently
+			 */
+			bool parallelbranches;
+			
 			/**
 			 *  \brief Default constructor
+			 *
+			 *  \details The other options take their default values, and are set by member assignment
 			 */
 			OptionsMatch(enum_methodmatch methodmatch_ = ode, double lambdamin_ = 0.1, double lambdamax_ = 10.0, double lambdastep_ = 0.1, double deltat_ = 0.01) :
-				methodmatch(methodmatch_), lambdamin(lambdamin_), lambdamax(lambdamax_), lambdastep(lambdastep_), deltat(deltat_) {}
+				methodmatch(methodmatch_), lambdasearch(linear), lambdamin(lambdamin_), lambdamax(lambdamax_), lambdastep(lambdastep_), lambdatol(0.1),
+				deltat(deltat_), integrator(euler), odetol(1e-3), speedoptim(cobyla), linefield(0), parallel(false), parallelbranches(false) {}
+		};
+		
+		/**
+		 *  \brief Warm start of the matching of a branch
+		 *
+		 *  \details Updated by each successful matching, it gives the starting point of the next matching
+		 *           of the same branch (typically in the next frame of a video)
+		 */
+		struct WarmStart
+		{
+			/**
+			 *  \brief Angles of the initial speed of the path (empty if unknown)
+			 */
+			std::vector<double> speed;
+			
+			/**
+			 *  \brief Smallest successful lambda (0 if unknown)
+			 */
+			double lambda;
+			
+			/**
+			 *  \brief Number of optimizations of the initial speed by the last matching
+			 */
+			unsigned int nbspeed;
+			
+			/**
+			 *  \brief Constructor
+			 */
+			WarmStart() : speed(0), lambda(0.0), nbspeed(0) {}
 		};
 		
 		/**
@@ -99,6 +218,23 @@ namespace algorithm
 				const std::vector<skeleton::BranchContProjSkel::Ptr> projbr,
 				const OptionsMatch &options = OptionsMatch());
 		
+		/**
+		 *  \brief Multiple branches matching algorithm, warm started
+		 *
+		 *  \details Within the lambda search, each optimization of the initial speed also starts from the previous optimum.
+		 *           The linear search goes up from the lambda of the warm start, and sweeps the smaller lambdas if none succeeds
+		 *
+		 *  \param recbranch branch containing reconstruction data
+		 *  \param projbr    projective branches
+		 *  \param warmstart warm start of the branch, updated if the matching succeeds
+		 *  \param options   algorithm options
+		 */
+		void BranchMatching(
+				skeleton::ReconstructionBranch::Ptr recbranch,
+				const std::vector<skeleton::BranchContProjSkel::Ptr> projbr,
+				WarmStart &warmstart,
+				const OptionsMatch &options = OptionsMatch());
+		
 		/**
 		 *  \brief Two skeletons matching algorithm
 		 *
@@ -110,6 +246,20 @@ namespace algorithm
 				skeleton::ReconstructionSkeleton::Ptr recskel,
 				const std::vector<skeleton::CompContProjSkel::Ptr> projskel,
 				const OptionsMatch &options = OptionsMatch());
+		
+		/**
+		 *  \brief Two skeletons matching algorithm, warm started
+		 *
+		 *  \param recskel   skeleton containing reconstruction data
+		 *  \param projskel  projective skeletons
+		 *  \param warmstart warm starts of the branches, indexed by edge (missing edges are added)
+		 *  \param options   algorithm options
+		 */
+		void ComposedMatching(
+				skeleton::ReconstructionSkeleton::Ptr recskel,
+				const std::vector<skeleton::CompContProjSkel::Ptr> projskel,
+				std::map<unsigned int,WarmStart> &warmstart,
+				const OptionsMatch &options = OptionsMatch());
 	}
 }
 
@@ -185,13 +185,27 @@ void algorithm::matchskeletons::ComposedMatching(
 	std::list<unsigned int> l_edge;
 	recskel->getAllEdges(l_edge);
 
+	std::vector<skeleton::ReconstructionBranch::Ptr> vec_recbr(0);
+	std::vector<skeleton::BranchContProjSkel::Ptr> vec_projbr1(0);
+	std::vector<skeleton::BranchContProjSkel::Ptr> vec_projbr2(0);
 	for(std::list<unsigned int>::iterator it = l_edge.begin(); it != l_edge.end(); it++)
 	{
-		skeleton::ReconstructionBranch::Ptr recbr = recskel->getBranch(*it);
 		std::pair<unsigned int,unsigned int> ext = recskel->getExtremities(*it);
-		typename skeleton::BranchContProjSkel::Ptr projbr1 = projskel1->getBranch(ext.first,ext.second);
-		typename skeleton::BranchContProjSkel::Ptr projbr2 = projskel2->getBranch(ext.first,ext.second);
+		vec_recbr.push_back(recskel->getBranch(*it));
+		vec_projbr1.push_back(projskel1->getBranch(ext.first,ext.second));
+		vec_projbr2.push_back(projskel2->getBranch(ext.first,ext.second));
+	}
 
-		BranchMatching(recbr,projbr1,projbr2,options);
+	// branches are matched on copies, written back in edge order
+	std::vector<skeleton::ReconstructionBranch::Ptr> vec_match(vec_recbr.size());
+	#pragma omp parallel for schedule(dynamic) if(options.parallelbranches)
+	for(int i = 0; i < (int)vec_recbr.size(); i++)
+	{
+		vec_match[i] = skeleton::ReconstructionBranch::Ptr(new skeleton::ReconstructionBranch(*vec_recbr[i]));
+		BranchMatching(vec_match[i],vec_projbr1[i],vec_projbr2[i],options);
 	}
+
+	for(unsigned int i = 0; i < vec_recbr.size(); i++)
+		if(vec_match[i]->isMatched())
+			vec_recbr[i]->setMatch(vec_match[i]->getMatch());
 }
@@ -91,13 +91,18 @@ namespace algorithm
 			 */
 			double deltat;
 			
+			/**
+			 *  \brief Matches the branches of a skeleton concurrently
+			 */
+			bool parallelbranches;
+			
 			/**
 			 *  \brief Default constructor
 			 */
 			OptionsMatch2(enum_methodmatch methodmatch_ = graph, unsigned int nb_triang_ = 100, double lambda_ = 1.0,
-					      double lambdamin_ = 0.1, double lambdamax_ = 10.0, double lambdastep_ = 0.1, double deltat_ = 0.01) :
+					      double lambdamin_ = 0.1, double lambdamax_ = 10.0, double lambdastep_ = 0.1, double deltat_ = 0.01, bool parallelbranches_ = false) :
 				methodmatch(methodmatch_), nb_triang(nb_triang_), lambda(lambda_),
-				lambdamin(lambdamin_), lambdamax(lambdamax_), lambdastep(lambdastep_), deltat(deltat_) {}
+				lambdamin(lambdamin_), lambdamax(lambdamax_), lambdastep(lambdastep_), deltat(deltat_), parallelbranches(parallelbranches_) {}
 		};
 		
 		/**
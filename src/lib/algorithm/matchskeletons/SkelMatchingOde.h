@@ -0,0 +1,229 @@
+/*
+Copyright (c) 2016 Bastien Durix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/**
+ *  \file SkelMatchingOde.h
+ *  \brief Ode of the skeletal branches matching, and the objective functions of its initial speed
+ *  \author Bastien Durix
+ */
+
+#ifndef _SKELMATCHINGODE_H_
+#define _SKELMATCHINGODE_H_
+
+#include "SkelMatching.h"
+#include <list>
+#include <memory>
+
+/**
+ *  \brief Lots of algorithms
+ */
+namespace algorithm
+{
+	/**
+	 *  \brief Matching and triangulation skeleton algorithms
+	 */
+	namespace matchskeletons
+	{
+		/**
+		 *  \brief Line field of a view: lines in R8 (origin, direction) along the branch, and their derivatives,
+		 *         either evaluated on the branch or interpolated in a table
+		 */
+		struct LineField
+		{
+			/**
+			 *  \brief Projective branch of the view
+			 */
+			skeleton::BranchContProjSkel::Ptr branch;
+
+			/**
+			 *  \brief Lines and derivatives at regularly spaced t (none if empty)
+			 */
+			std::shared_ptr<const Eigen::Matrix<double,16,Eigen::Dynamic> > table;
+		};
+
+		/**
+		 *  \brief Line field of a branch
+		 *
+		 *  \param branch  projective branch
+		 *  \param nbnodes number of values of t of the table (no table if lower than 2)
+		 *
+		 *  \return line field of the branch
+		 */
+		LineField TabulateLine(const skeleton::BranchContProjSkel::Ptr branch, unsigned int nbnodes);
+
+		/**
+		 *  \brief Data of the matching ode of a branch
+		 */
+		struct DataODE
+		{
+			/**
+			 *  \brief Line fields of the views
+			 */
+			std::vector<LineField> skel;
+
+			/**
+			 *  \brief Positions of the path integrated by SolveODE
+			 */
+			std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > list_pos;
+
+			/**
+			 *  \brief Speeds of the path integrated by SolveODE
+			 */
+			std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > list_vit;
+
+			/**
+			 *  \brief Distance gradients along the path integrated by SolveODE
+			 */
+			std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > list_grad;
+
+			/**
+			 *  \brief Distances along the path integrated by SolveODE
+			 */
+			std::list<double> list_val;
+
+			/**
+			 *  \brief Integration time of the path
+			 */
+			double t_tot;
+
+			/**
+			 *  \brief Energy of the path
+			 */
+			double v_tot;
+
+			/**
+			 *  \brief Time between two steps
+			 */
+			double deltat;
+
+			/**
+			 *  \brief Weight of the distance function between the lines
+			 */
+			double lambda;
+
+			/**
+			 *  \brief Angles of the optimal initial speed
+			 */
+			std::vector<double> vit_init;
+
+			/**
+			 *  \brief Trajectory of the fixed size and adaptive integrations (positions, speeds, gradients, then values)
+			 */
+			Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic> hist;
+
+			/**
+			 *  \brief Number of states in hist (0 if the path is in the lists)
+			 */
+			unsigned int nbhist;
+
+			/**
+			 *  \brief Integrator of the ode
+			 */
+			OptionsMatch::enum_integrator integrator;
+
+			/**
+			 *  \brief Tolerance of the adaptive integrator
+			 */
+			double odetol;
+
+			/**
+			 *  \brief Optimization algorithm of the initial speed
+			 */
+			OptionsMatch::enum_speedoptim speedoptim;
+
+			/**
+			 *  \brief Starting point of the speed optimization (default one if empty)
+			 */
+			std::vector<double> vit_start;
+
+			/**
+			 *  \brief Each speed optimization of the lambda search starts from the previous optimum
+			 */
+			bool warmstart;
+
+			/**
+			 *  \brief First lambda of the search (lambdamin if 0)
+			 */
+			double lambdastart;
+		};
+
+		/**
+		 *  \brief Euler integration of the matching ode, for any number of views
+		 *
+		 *  \param list_val  out distances along the path
+		 *  \param list_pos  out positions of the path
+		 *  \param list_vit  out speeds of the path
+		 *  \param list_grad out distance gradients along the path
+		 *  \param t_tot     out integration time
+		 *  \param v_tot     out energy of the path
+		 *  \param skel      line fields of the views
+		 *  \param q_init    starting position
+		 *  \param v_init    starting speed
+		 *  \param lambda    weight of the distance function between the lines
+		 *  \param deltat    time between two steps
+		 *
+		 *  \return distance between the exit point of the path and the end of the branches
+		 */
+		double SolveODE(
+				std::list<double> &list_val,
+				std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > &list_pos,
+				std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > &list_vit,
+				std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > &list_grad,
+				double &t_tot,
+				double &v_tot,
+				const std::vector<LineField> &skel,
+				const Eigen::Matrix<double,Eigen::Dynamic,1> &q_init,
+				const Eigen::Matrix<double,Eigen::Dynamic,1> &v_init,
+				const double &lambda,
+				const double &deltat);
+
+		/**
+		 *  \brief Objective of the initial speed optimization
+		 *
+		 *  \details Two to four views are integrated without allocation, in hist
+		 *
+		 *  \param x       angles of the initial speed
+		 *  \param grad    unused gradient
+		 *  \param dataFun pointer to the DataODE of the branch, which gets the path
+		 *
+		 *  \return distance between the exit point of the path and the end of the branches
+		 */
+		double minFunODE(const std::vector<double> &x, std::vector<double> &grad, void *dataFun);
+
+		/**
+		 *  \brief Objective of the initial speed optimization, and its gradient if grad is not empty
+		 *
+		 *  \details The euler path is differentiated along with its integration, the adaptive one by finite differences
+		 *
+		 *  \param x       angles of the initial speed
+		 *  \param grad    out gradient (not computed if empty)
+		 *  \param dataFun pointer to the DataODE of the branch, which gets the path
+		 *
+		 *  \return distance between the exit point of the path and the end of the branches
+		 */
+		double minFunODEGrad(const std::vector<double> &x, std::vector<double> &grad, void *dataFun);
+	}
+}
+
+
+#endif //_SKELMATCHINGODE_H_
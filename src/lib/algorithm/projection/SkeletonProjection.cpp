@@ -32,6 +32,7 @@ SOFTWARE.
 #include <skeleton/model/Perspective.h>
 #include <mathtools/application/Application.h>
 #include <mathtools/application/Bspline.h>
+#include <mathtools/application/PiecewisePolynomial.h>
 #include <mathtools/application/Nurbs.h>
 
 template<typename Model>
@@ -44,7 +45,12 @@ skeleton::BranchContProjSkel::Ptr SkeletonProjection_helper(const skeleton::Bran
 	
 	mathtools::application::Application<Eigen::Vector3d,double>::Ptr nodefunproj;
 	
-	mathtools::application::Bspline<4>::Ptr bsplinenode = std::static_pointer_cast<mathtools::application::Bspline<4> >(nodefun);
+	mathtools::application::Bspline<4>::Ptr bsplinenode = std::dynamic_pointer_cast<mathtools::application::Bspline<4> >(nodefun);
+
+	// frozen branch: the projection is computed from the bspline
+	mathtools::application::PiecewisePolynomial<4>::Ptr polynode = std::dynamic_pointer_cast<mathtools::application::PiecewisePolynomial<4> >(nodefun);
+	if(polynode)
+		bsplinenode = polynode->getBspline();
 	
 	if(bsplinenode)
 	{
@@ -36,6 +36,49 @@ SOFTWARE.
 
 #include <algorithm/graphoperation/ConnectedComponents.h>
 
+/**
+ *  \brief Copies the connected components containing internal nodes
+ *
+ *  \tparam Model    skeleton model
+ *  \param  skel_int skeleton in which copy the components
+ *  \param  grskel   skeleton to filter
+ *  \param  labels   connected components of grskel
+ *  \param  v_intsph internal nodes
+ */
+template<typename Model>
+void KeepInternComponents(typename skeleton::GraphCurveSkeleton<Model>::Ptr skel_int,
+						  const typename skeleton::GraphCurveSkeleton<Model>::Ptr grskel,
+						  const algorithm::graphoperation::ComponentLabels &labels,
+						  const std::list<unsigned int> &v_intsph)
+{
+	std::vector<bool> intern(labels.getNbComponents(),false);
+	for(std::list<unsigned int>::const_iterator itl = v_intsph.begin(); itl != v_intsph.end(); itl++)
+	{
+		unsigned int label = labels.getLabel(*itl);
+		if(label != algorithm::graphoperation::ComponentLabels::NoLabel)
+			intern[label] = true;
+	}
+
+	for(unsigned int label = 0; label < intern.size(); label++)
+	{
+		if(intern[label])
+		{
+			for(unsigned int i = labels.offset[label]; i < labels.offset[label+1]; i++)
+			{
+				skel_int->addNode(labels.nodes[i],grskel->getNode(labels.nodes[i]));
+			}
+		}
+	}
+
+	std::vector<std::pair<unsigned int,unsigned int> > edges(0);
+	grskel->getAllEdges(edges);
+	for(unsigned int i = 0; i < edges.size(); i++)
+	{
+		if(intern[labels.getLabel(edges[i].first)])
+			skel_int->addEdge(edges[i].first,edges[i].second);
+	}
+}
+
 template<typename Model>
 void VoronoiOrtho(typename skeleton::GraphCurveSkeleton<Model>::Ptr skel_int, const boundary::DiscreteBoundary<2>::Ptr disbnd, const mathtools::affine::Frame<2>::Ptr frame)
 {
@@ -223,27 +266,8 @@ void VoronoiOrtho(typename skeleton::GraphCurveSkeleton<Model>::Ptr skel_int, co
 	/*
 	 *  Separation into connected components
 	 */
-	std::list<typename skeleton::GraphCurveSkeleton<Model>::Ptr> list_comp = algorithm::graphoperation::SeparateComponents(grskel);
-
-	for(typename std::list<typename skeleton::GraphCurveSkeleton<Model>::Ptr>::iterator it = list_comp.begin(); it!=list_comp.end(); it++)
-	{
-		std::list<unsigned int> list_ver;
-		(*it)->getAllNodes(list_ver);
-
-		bool intern = false;
-		for(std::list<unsigned int>::iterator itl = v_intsph.begin(); itl != v_intsph.end() && !intern; itl++)
-		{
-			if( std::find(list_ver.begin(),list_ver.end(),*itl) != list_ver.end() )
-			{
-				intern=true;
-			}
-		}
-
-		if(intern)
-		{
-			skel_int->insertExactSkel(*it);
-		}
-	}
+	algorithm::graphoperation::ComponentLabels labels = algorithm::graphoperation::LabelComponents(grskel);
+	KeepInternComponents<Model>(skel_int,grskel,labels,v_intsph);
 }
 
 void VoronoiPersp(skeleton::GraphProjSkel::Ptr skel_int, const boundary::DiscreteBoundary<2>::Ptr disbnd, const mathtools::affine::Frame<2>::Ptr frame)
@@ -371,27 +395,8 @@ void VoronoiPersp(skeleton::GraphProjSkel::Ptr skel_int, const boundary::Discret
 	/*
 	 *  Separation into connected components
 	 */
-	std::list<skeleton::GraphProjSkel::Ptr> list_comp = algorithm::graphoperation::SeparateComponents(grskel);
-
-	for(std::list<skeleton::GraphProjSkel::Ptr>::iterator it = list_comp.begin(); it!=list_comp.end(); it++)
-	{
-		std::list<unsigned int> list_ver;
-		(*it)->getAllNodes(list_ver);
-
-		bool intern = false;
-		for(std::list<unsigned int>::iterator itl = v_intsph.begin(); itl != v_intsph.end() && !intern; itl++)
-		{
-			if( std::find(list_ver.begin(),list_ver.end(),*itl) != list_ver.end() )
-			{
-				intern=true;
-			}
-		}
-
-		if(intern)
-		{
-			skel_int->insertExactSkel(*it);
-		}
-	}
+	algorithm::graphoperation::ComponentLabels labels = algorithm::graphoperation::LabelComponents(grskel);
+	KeepInternComponents<skeleton::model::Projective>(skel_int,grskel,labels,v_intsph);
 }
 
 skeleton::GraphSkel2d::Ptr algorithm::skeletonization::VoronoiSkeleton2d(const boundary::DiscreteBoundary<2>::Ptr disbnd)
@@ -314,13 +314,17 @@ void ComputeCirclesFrenet(const skeleton::BranchContSkel3d::Ptr contbr,
 {
 	Eigen::Matrix3d frenet_basis_prev;
 
+	std::vector<double> vec_t(0);
+	contbr->getSampling(options.nbcer,options.arclength,vec_t);
+
+	Eigen::Matrix<double,4,Eigen::Dynamic> mat_val, mat_der, mat_der2;
+	contbr->evaluate(vec_t,mat_val,mat_der,mat_der2);
+
 	for(unsigned int i = 0; i < options.nbcer; i++)
 	{
-		double t = (double)i/(double)(options.nbcer-1);
-
-		Eigen::Vector4d val = contbr->getCompFun()->operator()(t);
-		Eigen::Vector4d der = Eigen::Map<Eigen::Vector4d>((double*)contbr->getCompFun()->der(t).data());
-		Eigen::Vector4d der2 = Eigen::Map<Eigen::Vector4d>((double*)contbr->getCompFun()->der2(t).data());
+		Eigen::Vector4d val = mat_val.col(i);
+		Eigen::Vector4d der = mat_der.col(i);
+		Eigen::Vector4d der2 = mat_der2.col(i);
 
 		HyperSphere<3> sphere = ComputeSphere(val,contbr->getModel()->getFrame());
 		HyperPlane<3> plane = ComputeCaractPlane(val,der,contbr->getModel()->getFrame()->getBasis());
@@ -359,13 +363,16 @@ void ComputeCirclesProjBasis(const skeleton::BranchContSkel3d::Ptr contbr,
 							 std::list<HyperCircle<3> > &list_cir,
 							 std::list<Basis<3>::Ptr> &list_basis)
 {
+	std::vector<double> vec_t(0);
+	contbr->getSampling(options.nbcer,options.arclength,vec_t);
+
+	Eigen::Matrix<double,4,Eigen::Dynamic> mat_val, mat_der;
+	contbr->evaluate(vec_t,mat_val,mat_der);
+
 	for(unsigned int i = 0; i < options.nbcer; i++)
 	{
-		double t = (double)i/(double)(options.nbcer-1);
-
-		Eigen::Vector4d val = contbr->getCompFun()->operator()(t);
-		Eigen::Vector4d der = Eigen::Map<Eigen::Vector4d>((double*)contbr->getCompFun()->der(t).data());
-		Eigen::Vector4d der2 = Eigen::Map<Eigen::Vector4d>((double*)contbr->getCompFun()->der2(t).data());
+		Eigen::Vector4d val = mat_val.col(i);
+		Eigen::Vector4d der = mat_der.col(i);
 
 		HyperSphere<3> sphere = ComputeSphere(val,contbr->getModel()->getFrame());
 		HyperPlane<3> plane = ComputeCaractPlane(val,der,contbr->getModel()->getFrame()->getBasis());
@@ -77,11 +77,16 @@ namespace algorithm
  			 */
 			unsigned int fracnbcer;
 
+			/**
+			 *  \brief Circles evenly spaced along the branch (true) or in its parameter (false)
+			 */
+			bool arclength;
+
 			/**
 			 *  \brief Default constructor
 			 */
-			OptionsContSkinning(unsigned int nbcer_ = 20, unsigned int nbpt_ = 16, unsigned int fracnbcer_ = 8, enum_computebasis computebasis_ = projbasis) :
-				nbcer(nbcer_), nbpt(nbpt_), fracnbcer(fracnbcer_), computebasis(computebasis_) {}
+			OptionsContSkinning(unsigned int nbcer_ = 20, unsigned int nbpt_ = 16, unsigned int fracnbcer_ = 8, enum_computebasis computebasis_ = projbasis, bool arclength_ = false) :
+				nbcer(nbcer_), nbpt(nbpt_), fracnbcer(fracnbcer_), computebasis(computebasis_), arclength(arclength_) {}
 		};
 		
 		/**
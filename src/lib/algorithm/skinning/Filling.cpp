@@ -35,10 +35,15 @@ void algorithm::skinning::Filling(shape::DiscreteShape<2>::Ptr shape, const skel
 {
 	cv::Mat im_shape(shape->getHeight(),shape->getWidth(),CV_8U,&shape->getContainer()[0]);
 	
+	std::vector<double> vec_t(0);
+	contbr->getSampling(options.nbcer,options.arclength,vec_t);
+
+	Eigen::Matrix<double,3,Eigen::Dynamic> nodes;
+	contbr->evaluate(vec_t,nodes);
+
 	for(unsigned int i = 0; i < options.nbcer; i++)
 	{
-		double t = (double)i/(double)(options.nbcer-1);
-		mathtools::geometry::euclidian::HyperSphere<2> sph = contbr->getNode<mathtools::geometry::euclidian::HyperSphere<2> >(t);
+		mathtools::geometry::euclidian::HyperSphere<2> sph = contbr->getModel()->toObj<mathtools::geometry::euclidian::HyperSphere<2> >(nodes.col(i));
 		
     	cv::circle(im_shape,cv::Point2i(sph.getCenter().getCoords(shape->getFrame()).x(),sph.getCenter().getCoords(shape->getFrame()).y()),sph.getRadius(),255,-1);
 	}
@@ -61,10 +66,15 @@ void algorithm::skinning::Filling(shape::DiscreteShape<2>::Ptr shape, const skel
 {
 	cv::Mat im_shape(shape->getHeight(),shape->getWidth(),CV_8U,&shape->getContainer()[0]);
 	
+	std::vector<double> vec_t(0);
+	contbr->getSampling(options.nbcer,options.arclength,vec_t);
+
+	Eigen::Matrix<double,3,Eigen::Dynamic> nodes;
+	contbr->evaluate(vec_t,nodes);
+
 	for(unsigned int i = 0; i < options.nbcer; i++)
 	{
-		double t = (double)i/(double)(options.nbcer-1);
-		mathtools::geometry::euclidian::HyperEllipse<2> ell = contbr->getNode<mathtools::geometry::euclidian::HyperEllipse<2> >(t);
+		mathtools::geometry::euclidian::HyperEllipse<2> ell = contbr->getModel()->toObj<mathtools::geometry::euclidian::HyperEllipse<2> >(nodes.col(i));
 		
 		Eigen::Vector2d vec_ctr = ell.getCenter().getCoords(shape->getFrame());
 
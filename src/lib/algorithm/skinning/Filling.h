@@ -53,11 +53,16 @@ namespace algorithm
 			 */
 			unsigned int nbcer;
 
+			/**
+			 *  \brief Circles evenly spaced along the branch (true) or in its parameter (false)
+			 */
+			bool arclength;
+
 			/**
 			 *  \brief Default constructor
 			 */
-			OptionsFilling(unsigned int nbcer_ = 100) :
-				nbcer(nbcer_) {}
+			OptionsFilling(unsigned int nbcer_ = 100, bool arclength_ = false) :
+				nbcer(nbcer_), arclength(arclength_) {}
 		};
 
 		/**
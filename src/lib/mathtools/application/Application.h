@@ -34,6 +34,7 @@ SOFTWARE.
 #include <memory>
 #include <type_traits>
 #include <array>
+#include <vector>
 
 /**
  *  \brief Mathematical tools
@@ -77,6 +78,33 @@ namespace mathtools
 			static constexpr unsigned int value = 1;
 		};
 
+		/**
+		 *  \brief Conversion of an Eigen vector into a column
+		 *
+		 *  \tparam Dim Eigen vector dimension
+		 *
+		 *  \param vec vector to convert
+		 *
+		 *  \return column vector
+		 */
+		template<int Dim>
+		inline const Eigen::Matrix<double,Dim,1>& toColumn(const Eigen::Matrix<double,Dim,1> &vec)
+		{
+			return vec;
+		}
+
+		/**
+		 *  \brief Conversion of a double into a column
+		 *
+		 *  \param val value to convert
+		 *
+		 *  \return column vector of size 1
+		 */
+		inline Eigen::Matrix<double,1,1> toColumn(double val)
+		{
+			return Eigen::Matrix<double,1,1>(val);
+		}
+
 		/**
 		 *  \brief Recursively defined derivative matrix
 		 *
@@ -271,6 +299,83 @@ namespace mathtools
 					throw std::logic_error("Not implemented");
 				}
 				
+				/**
+				 *  \brief Value, first and second derivatives of the function
+				 *
+				 *  \param t     Input of the application
+				 *  \param val   Out value associated to input t
+				 *  \param dval  Out first derivative associated to input t
+				 *  \param d2val Out second derivative associated to input t
+				 *
+				 *  \details Default implementation calls the function and its derivatives separately,
+				 *           applications which share computations between them should override it
+				 */
+				virtual void jet(const inType &t,
+								 outType &val,
+								 typename derivativematrix<1,dimension<outType>::value,dimension<inType>::value>::type &dval,
+								 typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type &d2val) const
+				{
+					val = operator()(t);
+					dval = der(t);
+					d2val = der2(t);
+				}
+
+				/**
+				 *  \brief Values of the function at several inputs
+				 *
+				 *  \param t   Inputs of the application (evaluation is faster if they are sorted)
+				 *  \param val Out values: column i is associated to t[i]
+				 */
+				virtual void evaluate(const std::vector<inType> &t,
+									  Eigen::Matrix<double,dimension<outType>::value,Eigen::Dynamic> &val) const
+				{
+					val.resize(dimension<outType>::value,t.size());
+					for(unsigned int i = 0; i < t.size(); i++)
+					{
+						val.col(i) = toColumn(operator()(t[i]));
+					}
+				}
+
+				/**
+				 *  \brief Values and first derivatives of the function at several inputs
+				 *
+				 *  \param t    Inputs of the application (evaluation is faster if they are sorted)
+				 *  \param val  Out values: column i is associated to t[i]
+				 *  \param dval Out first derivatives: column i is the derivative matrix at t[i], stored as der(t[i]).data()
+				 */
+				virtual void evaluate(const std::vector<inType> &t,
+									  Eigen::Matrix<double,dimension<outType>::value,Eigen::Dynamic> &val,
+									  Eigen::Matrix<double,dimension<outType>::value*dimension<inType>::value,Eigen::Dynamic> &dval) const
+				{
+					evaluate(t,val);
+					dval.resize(dimension<outType>::value*dimension<inType>::value,t.size());
+					for(unsigned int i = 0; i < t.size(); i++)
+					{
+						dval.col(i) = Eigen::Map<Eigen::Matrix<double,dimension<outType>::value*dimension<inType>::value,1> >((double*)der(t[i]).data());
+					}
+				}
+
+				/**
+				 *  \brief Values, first and second derivatives of the function at several inputs
+				 *
+				 *  \param t     Inputs of the application (evaluation is faster if they are sorted)
+				 *  \param val   Out values: column i is associated to t[i]
+				 *  \param dval  Out first derivatives: column i is the derivative matrix at t[i], stored as der(t[i]).data()
+				 *  \param d2val Out second derivatives: column i is the derivative matrix at t[i], stored as der2(t[i]).data()
+				 */
+				virtual void evaluate(const std::vector<inType> &t,
+									  Eigen::Matrix<double,dimension<outType>::value,Eigen::Dynamic> &val,
+									  Eigen::Matrix<double,dimension<outType>::value*dimension<inType>::value,Eigen::Dynamic> &dval,
+									  Eigen::Matrix<double,dimension<outType>::value*dimension<inType>::value*dimension<inType>::value,Eigen::Dynamic> &d2val) const
+				{
+					evaluate(t,val,dval);
+					d2val.resize(dimension<outType>::value*dimension<inType>::value*dimension<inType>::value,t.size());
+					for(unsigned int i = 0; i < t.size(); i++)
+					{
+						d2val.col(i) = Eigen::Map<Eigen::Matrix<double,dimension<outType>::value*dimension<inType>::value*dimension<inType>::value,1> >((double*)der2(t[i]).data());
+					}
+				}
+
 				/**
 				 *  \brief Pure virtual destructor
 				 */
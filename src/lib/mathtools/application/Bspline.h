@@ -147,6 +147,15 @@ namespace mathtools
 					m_ctrlptder(bspline.m_ctrlptder), m_nodevecder(bspline.m_nodevecder),
 					m_ctrlptder2(bspline.m_ctrlptder2), m_nodevecder2(bspline.m_nodevecder2),
 					m_degree(bspline.m_degree) {};
+
+				/**
+				 *  \brief Copy assignment
+				 *
+				 *  \param bspline Bspline to copy
+				 *
+				 *  \return this Bspline
+				 */
+				Bspline<Dim>& operator=(const Bspline<Dim> &bspline) = default;
 				
 				/**
 				 *  \brief Bspline call
@@ -157,15 +166,7 @@ namespace mathtools
 				 */
 				Eigen::Matrix<double,Dim,1> operator()(const double &t) const
 				{
-					Eigen::Matrix<double,Dim,1> res = Eigen::Matrix<double,Dim,1>::Zero();
-
-					for(unsigned int ind = 0; ind<m_ctrlpt.cols(); ind++)
-					{
-						double basis_ind = BsplineBasis(t,m_degree,ind,m_nodevec);
-						res+=m_ctrlpt.block(0,ind,Dim,1)*basis_ind;
-					}
-
-					return res;
+					return BsplineEval<Dim>(t,m_degree,m_nodevec,m_ctrlpt);
 				}
 
 				/**
@@ -186,11 +187,7 @@ namespace mathtools
 					
 					if(m_degree > 0)
 					{
-						for(unsigned int ind = 0; ind<m_ctrlptder.cols(); ind++)
-						{
-							double basis_ind = BsplineBasis(t,m_degree-1,ind,m_nodevecder);
-							res+=m_ctrlptder.block(0,ind,Dim,1)*basis_ind;
-						}
+						res = BsplineEval<Dim>(t,m_degree-1,m_nodevecder,m_ctrlptder);
 					}
 
 					return arr;
@@ -214,16 +211,84 @@ namespace mathtools
 					
 					if(m_degree > 1)
 					{
-						for(unsigned int ind = 0; ind<m_ctrlptder2.cols(); ind++)
-						{
-							double basis_ind = BsplineBasis(t,m_degree-2,ind,m_nodevecder2);
-							res+=m_ctrlptder2.block(0,ind,Dim,1)*basis_ind;
-						}
+						res = BsplineEval<Dim>(t,m_degree-2,m_nodevecder2,m_ctrlptder2);
 					}
 
 					return arr;
 				}
 				
+				/**
+				 *  \brief Value, first and second derivatives of the bspline
+				 *
+				 *  \param t     Input of the application
+				 *  \param val   Out value associated to input t
+				 *  \param dval  Out first derivative associated to input t
+				 *  \param d2val Out second derivative associated to input t
+				 *
+				 *  \details The three evaluations share the basis functions computed at t.
+				 */
+				virtual void jet(const double &t,
+								 Eigen::Matrix<double,Dim,1> &val,
+								 typename derivativematrix<1,dimension<outType>::value,dimension<inType>::value>::type &dval,
+								 typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type &d2val) const
+				{
+					Eigen::Matrix<double,Dim,Eigen::Dynamic> ders;
+					BsplineDerivatives<Dim>(t,m_degree,m_nodevec,m_ctrlpt,2,ders);
+					val = ders.col(0);
+					Eigen::Map<Eigen::Matrix<double,Dim,1> >((double*)dval.data()) = ders.col(1);
+					Eigen::Map<Eigen::Matrix<double,Dim,1> >((double*)d2val.data()) = ders.col(2);
+				}
+
+				/**
+				 *  \brief Values of the bspline at several parameters
+				 *
+				 *  \param t   Parameters (evaluation is faster if they are sorted)
+				 *  \param val Out values: column i is associated to t[i]
+				 */
+				virtual void evaluate(const std::vector<double> &t,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &val) const
+				{
+					BsplineEvalBatch<Dim>(t,m_degree,m_nodevec,m_ctrlpt,val);
+				}
+
+				/**
+				 *  \brief Values and first derivatives of the bspline at several parameters
+				 *
+				 *  \param t    Parameters (evaluation is faster if they are sorted)
+				 *  \param val  Out values: column i is associated to t[i]
+				 *  \param dval Out first derivatives: column i is associated to t[i]
+				 */
+				virtual void evaluate(const std::vector<double> &t,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &val,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &dval) const
+				{
+					evaluate(t,val);
+					if(m_degree > 0)
+						BsplineEvalBatch<Dim>(t,m_degree-1,m_nodevecder,m_ctrlptder,dval);
+					else
+						dval.setZero(Dim,t.size());
+				}
+
+				/**
+				 *  \brief Values, first and second derivatives of the bspline at several parameters
+				 *
+				 *  \param t     Parameters (evaluation is faster if they are sorted)
+				 *  \param val   Out values: column i is associated to t[i]
+				 *  \param dval  Out first derivatives: column i is associated to t[i]
+				 *  \param d2val Out second derivatives: column i is associated to t[i]
+				 */
+				virtual void evaluate(const std::vector<double> &t,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &val,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &dval,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &d2val) const
+				{
+					evaluate(t,val,dval);
+					if(m_degree > 1)
+						BsplineEvalBatch<Dim>(t,m_degree-2,m_nodevecder2,m_ctrlptder2,d2val);
+					else
+						d2val.setZero(Dim,t.size());
+				}
+
 				/**
 				 *  \brief Degree getter
 				 *
@@ -28,103 +28,51 @@ SOFTWARE.
  */
 
 #include "Bspline.h"
+#include <algorithm>
+
+unsigned int mathtools::application::BsplineSpan(double t, const NodeRef &node)
+{
+	const double *beg = node.data();
+	return std::upper_bound(beg,beg+node.cols(),t) - beg;
+}
+
+unsigned int mathtools::application::BsplineSpan(double t, const NodeRef &node, unsigned int hint)
+{
+	unsigned int nbnode = node.cols();
+	if(hint > nbnode || (hint > 0 && !(node(0,hint-1) <= t)))
+		return BsplineSpan(t,node);
+
+	// t is after the hint span: usual case of sorted parameters
+	const double *beg = node.data();
+	unsigned int span = hint;
+	if(span < nbnode && node(0,span) <= t)
+		span = std::upper_bound(beg+span+1,beg+nbnode,t) - beg;
+	return span;
+}
+
+unsigned int mathtools::application::BsplineBasisSpan(double t, unsigned int degree, const NodeRef &node, Eigen::Matrix<double,1,Eigen::Dynamic> &basis)
+{
+	unsigned int span = BsplineSpan(t,node);
+	BsplineBasisOnSpan(t,span,degree,node,basis);
+	return span;
+}
+
+void mathtools::application::BsplineBasisOnSpan(double t, unsigned int span, unsigned int degree, const NodeRef &node, Eigen::Matrix<double,1,Eigen::Dynamic> &basis)
+{
+	basis.resize(1,degree+1);
+	BsplineBasisKernel<Eigen::Dynamic>(t,span,degree,node,basis);
+}
 
 double mathtools::application::BsplineBasis(double t, unsigned int degree, unsigned int indice, const Eigen::Matrix<double,1,Eigen::Dynamic> &node)
 {
 	if(indice + degree > node.cols())
 		throw std::logic_error("BsplineBasis : Basis indice is out of node vector");
-	double res = 0.0;
-	/*
-	 *  if degree = 0
-	 *  B(t) = 1 if t_{indice-1} <= t < t_{indice}
-	 *  with t_{-1}          = -infinity
-	 *       t_{node.cols()} = +infinity
-	 *  
-	 *  example:
-	 *
-	 *  node vector: node = {0}
-	 *
-	 *  B_0(t) = 1 if t <  0
-	 *           0 if t >= 0
-	 *
-	 *  B_1(t) = 0 if t <  0
-	 *           1 if t >= 0
-	 *
-	 */
-	if(node.cols() == 0)
-	{
-		res = 1.0;
-	}
-	else if(degree == 0)
-	{
-		if(indice == 0)
-		{
-			if(t < node(0,0))
-				res = 1.0;
-		}
-		else if(indice == node.cols())
-		{
-			if(node(0,indice-1) <= t)
-				res = 1.0;
-		}
-		else
-		{
-			if(node(0,indice-1) <= t && t < node(0,indice))
-				res = 1.0;
-		}
-	}
-	/*
-	 *  if degree != 0
-	 *  classical recursive definition of bspline basis
-	 *  
-	 *  B_{d,i}(t) = B_{d-1,i}(t) * a_1(t) + B_{d-1,i+1}(t) * a_2(t) 
-	 *
-	 *  with a_1(t) = 1                                           if i == 0
-	 *	              (t - node[i-1])/(node[i+d-1] - node[i-1])   if i >  0
-	 *                
-	 *
-	 *  with a_2(t) = (node[i+d] - t)/(node[i+d] - node[i])       if i + d <  node.cols()
-	 *                1                                           if i + d == node.cols()
-	 */
-	else
-	{
-		if(indice > 0)
-		{
-			if(node(0, indice-1) <= t && t < node(0, indice + degree - 1))
-			{
-				double num1 = t                            - node(0, indice - 1);
-				double den1 = node(0, indice + degree - 1) - node(0, indice - 1);
 
-				if(den1 != 0)
-					res += (num1/den1) * BsplineBasis(t, degree-1, indice, node);
-			}
-		}
-		else
-		{
-			if(t < node(0,indice + degree - 1))
-			{
-				res += BsplineBasis(t, degree-1, indice, node);
-			}
-		}
+	Eigen::Matrix<double,1,Eigen::Dynamic> basis(1,degree+1);
+	int first = (int)BsplineBasisSpan(t,degree,node,basis) - (int)degree;
 
-		if(indice + degree < node.cols())
-		{
-			if(node(0, indice) <= t && t < node(0, indice + degree))
-			{
-				double num2 = node(0, indice + degree) - t;
-				double den2 = node(0, indice + degree) - node(0, indice);
-
-				if(den2 != 0)
-					res += (num2/den2) * BsplineBasis(t, degree-1, indice+1, node);
-			}
-		}
-		else
-		{
-			if(node(0, indice) <= t)
-			{
-				res += BsplineBasis(t, degree-1, indice+1, node);
-			}
-		}
-	}	
+	double res = 0.0;
+	if((int)indice >= first && (int)indice <= first + (int)degree)
+		res = basis(0,indice-first);
 	return res;
 }
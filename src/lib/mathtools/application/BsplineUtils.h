@@ -32,6 +32,8 @@ SOFTWARE.
 
 #include "Application.h"
 #include <Eigen/Dense>
+#include <algorithm>
+#include <vector>
 
 /**
  *  \brief Mathematical tools
@@ -43,6 +45,175 @@ namespace mathtools
 	 */
 	namespace application
 	{
+		/**
+		 *  \brief Node vector reference type (avoids copies of node sub-vectors)
+		 */
+		using NodeRef = Eigen::Ref<const Eigen::Matrix<double,1,Eigen::Dynamic> >;
+
+		/**
+		 *  \brief Finds the knot span of a parameter, by binary search
+		 *
+		 *  \param t    Parameter
+		 *  \param node Node vector of the basis
+		 *
+		 *  \return span s, such that node[s-1] <= t < node[s] (with node[-1] = -infinity and node[node.cols()] = +infinity)
+		 */
+		unsigned int BsplineSpan(double t, const NodeRef &node);
+
+		/**
+		 *  \brief Finds the knot span of a parameter, starting from the span of a previous parameter
+		 *
+		 *  \param t    Parameter
+		 *  \param node Node vector of the basis
+		 *  \param hint Span of a previous parameter (lower or equal to t for a fast search)
+		 *
+		 *  \return span s, such that node[s-1] <= t < node[s] (with node[-1] = -infinity and node[node.cols()] = +infinity)
+		 */
+		unsigned int BsplineSpan(double t, const NodeRef &node, unsigned int hint);
+
+		/**
+		 *  \brief Kernel of the evaluation of the bspline basis functions on a span
+		 *
+		 *  \tparam NbBasis Number of basis functions (degree + 1), or Eigen::Dynamic to use the degree parameter
+		 *
+		 *  \param t      Parameter for which evaluate the basis
+		 *  \param span   Span of the parameter
+		 *  \param degree Bspline degree (only used if NbBasis is Eigen::Dynamic)
+		 *  \param node   Node vector of the basis
+		 *  \param basis  Out basis values (already sized): basis(r) is the basis function of indice span - degree + r
+		 *
+		 *  \details With a fixed number of basis functions, all loops have constant bounds and the basis
+		 *           stays on the stack: the compiler unrolls them.
+		 */
+		template<int NbBasis>
+		inline void BsplineBasisKernel(double t, unsigned int span, unsigned int degree, const NodeRef &node, Eigen::Matrix<double,1,NbBasis> &basis)
+		{
+			const unsigned int deg = NbBasis == Eigen::Dynamic ? degree : NbBasis - 1;
+			unsigned int nbnode = node.cols();
+
+			basis.setZero();
+
+			/*
+			 *  t is not in the span (or not comparable, NaN): all basis functions are null
+			 */
+			if((span > 0 && !(node(0,span-1) <= t)) || (span < nbnode && !(t < node(0,span))))
+				return;
+
+			/*
+			 *  Same definition as the recursive one, evaluated from degree 0 upwards
+			 *  on the only basis functions that are not null on the span:
+			 *
+			 *  B_{d,i}(t) = B_{d-1,i}(t) * a_1(t) + B_{d-1,i+1}(t) * a_2(t)
+			 *
+			 *  at degree d, basis(r) stores B_{d,span-deg+r}, for r from deg-d to deg
+			 */
+			basis(0,deg) = 1.0;
+
+			/*
+			 *  Interior span: all the nodes involved are finite and the supports of the basis functions
+			 *  contain t, so the tests below always pass (except for the first term of the first function,
+			 *  which is null), and the same values are computed without them
+			 */
+			if(span > deg && span + deg < nbnode)
+			{
+				for(unsigned int d = 1; d <= deg; d++)
+				{
+					unsigned int indice = span - d;
+					basis(0,deg-d) = ((node(0, indice + d) - t)/(node(0, indice + d) - node(0, indice))) * basis(0,deg-d+1);
+
+					for(unsigned int r = deg-d+1; r <= deg; r++)
+					{
+						indice = span - deg + r;
+						double res = ((t - node(0, indice - 1))/(node(0, indice + d - 1) - node(0, indice - 1))) * basis(0,r);
+						if(r < deg)
+							res += ((node(0, indice + d) - t)/(node(0, indice + d) - node(0, indice))) * basis(0,r+1);
+						basis(0,r) = res;
+					}
+				}
+				return;
+			}
+
+			for(unsigned int d = 1; d <= deg; d++)
+			{
+				for(unsigned int r = deg-d; r <= deg; r++)
+				{
+					int indice = (int)span - (int)deg + (int)r;
+					double res = 0.0;
+
+					if(indice >= 0 && indice + d <= nbnode)
+					{
+						if(indice > 0)
+						{
+							if(node(0, indice - 1) <= t && t < node(0, indice + d - 1))
+							{
+								double num1 = t                       - node(0, indice - 1);
+								double den1 = node(0, indice + d - 1) - node(0, indice - 1);
+
+								if(den1 != 0)
+									res += (num1/den1) * basis(0,r);
+							}
+						}
+						else
+						{
+							if(t < node(0, indice + d - 1))
+							{
+								res += basis(0,r);
+							}
+						}
+
+						if(r < deg)
+						{
+							if(indice + d < nbnode)
+							{
+								if(node(0, indice) <= t && t < node(0, indice + d))
+								{
+									double num2 = node(0, indice + d) - t;
+									double den2 = node(0, indice + d) - node(0, indice);
+
+									if(den2 != 0)
+										res += (num2/den2) * basis(0,r+1);
+								}
+							}
+							else
+							{
+								if(node(0, indice) <= t)
+								{
+									res += basis(0,r+1);
+								}
+							}
+						}
+					}
+
+					basis(0,r) = res;
+				}
+			}
+		}
+
+		/**
+		 *  \brief Evaluate all the bspline basis functions that can be non null on a given span (Cox-de Boor triangular scheme)
+		 *
+		 *  \param t      Parameter for which evaluate the basis
+		 *  \param span   Span of the parameter
+		 *  \param degree Bspline degree
+		 *  \param node   Node vector of the basis
+		 *  \param basis  Out basis values: basis(r) is the basis function of indice span - degree + r (0 if this indice does not exist)
+		 *
+		 *  \details All values are null if t is not in the span.
+		 */
+		void BsplineBasisOnSpan(double t, unsigned int span, unsigned int degree, const NodeRef &node, Eigen::Matrix<double,1,Eigen::Dynamic> &basis);
+
+		/**
+		 *  \brief Evaluate all the bspline basis functions that can be non null at a parameter (Cox-de Boor triangular scheme)
+		 *
+		 *  \param t      Parameter for which evaluate the basis
+		 *  \param degree Bspline degree
+		 *  \param node   Node vector of the basis
+		 *  \param basis  Out basis values: basis(r) is the basis function of indice span - degree + r (0 if this indice does not exist)
+		 *
+		 *  \return span of the parameter
+		 */
+		unsigned int BsplineBasisSpan(double t, unsigned int degree, const NodeRef &node, Eigen::Matrix<double,1,Eigen::Dynamic> &basis);
+
 		/**
 		 *  \brief Evaluate the bspline basis function
 		 *
@@ -91,6 +262,237 @@ namespace mathtools
 			}
 			nodeout.block(0,0,1,nodein.cols() - 2) = nodein.block(0,1,1,nodein.cols() - 2);
 		}
+
+		/**
+		 *  \brief Kernel of the evaluation of a bspline curve on a span
+		 *
+		 *  \tparam Dim     Control points dimension
+		 *  \tparam NbBasis Number of basis functions (degree + 1), or Eigen::Dynamic to use the degree parameter
+		 *
+		 *  \param t      Parameter
+		 *  \param span   Span of the parameter
+		 *  \param degree Bspline degree (only used if NbBasis is Eigen::Dynamic)
+		 *  \param node   Node vector
+		 *  \param ctrl   Control points
+		 *  \param basis  Basis buffer (already sized)
+		 *
+		 *  \return Bspline evaluation at t
+		 */
+		template<unsigned int Dim, int NbBasis>
+		inline Eigen::Matrix<double,Dim,1> BsplineEvalKernel(double t,
+															 unsigned int span,
+															 unsigned int degree,
+															 const NodeRef &node,
+															 const Eigen::Matrix<double,Dim,Eigen::Dynamic> &ctrl,
+															 Eigen::Matrix<double,1,NbBasis> &basis)
+		{
+			const unsigned int deg = NbBasis == Eigen::Dynamic ? degree : NbBasis - 1;
+			BsplineBasisKernel<NbBasis>(t,span,degree,node,basis);
+
+			Eigen::Matrix<double,Dim,1> res = Eigen::Matrix<double,Dim,1>::Zero();
+			int first = (int)span - (int)deg;
+			if(first >= 0 && first + (int)deg < ctrl.cols())
+			{
+				for(unsigned int r = 0; r <= deg; r++)
+					res += ctrl.template block<Dim,1>(0,first+r)*basis(0,r);
+			}
+			else
+			{
+				for(unsigned int r = 0; r <= deg; r++)
+				{
+					int ind = first + (int)r;
+					if(ind >= 0 && ind < ctrl.cols())
+						res += ctrl.template block<Dim,1>(0,ind)*basis(0,r);
+				}
+			}
+			return res;
+		}
+
+		/**
+		 *  \brief Kernel of the evaluation of a bspline curve at several parameters
+		 *
+		 *  \tparam Dim     Control points dimension
+		 *  \tparam NbBasis Number of basis functions (degree + 1), or Eigen::Dynamic to use the degree parameter
+		 *
+		 *  \param t      Parameters
+		 *  \param degree Bspline degree
+		 *  \param node   Node vector
+		 *  \param ctrl   Control points
+		 *  \param res    Out evaluations
+		 */
+		template<unsigned int Dim, int NbBasis>
+		void BsplineEvalBatchKernel(const std::vector<double> &t,
+									unsigned int degree,
+									const NodeRef &node,
+									const Eigen::Matrix<double,Dim,Eigen::Dynamic> &ctrl,
+									Eigen::Matrix<double,Dim,Eigen::Dynamic> &res)
+		{
+			res.resize(Dim,t.size());
+
+			Eigen::Matrix<double,1,NbBasis> basis(1,degree+1);
+			unsigned int span = 0;
+			for(unsigned int i = 0; i < t.size(); i++)
+			{
+				span = BsplineSpan(t[i],node,span);
+				res.template block<Dim,1>(0,i) = BsplineEvalKernel<Dim,NbBasis>(t[i],span,degree,node,ctrl,basis);
+			}
+		}
+
+		/**
+		 *  \brief Evaluate a bspline curve, in O(degree^2)
+		 *
+		 *  \tparam Dim   Control points dimension
+		 *
+		 *  \param t      Parameter
+		 *  \param degree Bspline degree
+		 *  \param node   Node vector
+		 *  \param ctrl   Control points
+		 *
+		 *  \return Bspline evaluation at t
+		 *
+		 *  \details Degrees 1 to 5 use kernels with fixed size buffers, other degrees the generic one.
+		 */
+		template<unsigned int Dim>
+		Eigen::Matrix<double,Dim,1> BsplineEval(double t,
+												unsigned int degree,
+												const NodeRef &node,
+												const Eigen::Matrix<double,Dim,Eigen::Dynamic> &ctrl)
+		{
+			unsigned int span = BsplineSpan(t,node);
+			switch(degree)
+			{
+				case 1:
+				{
+					Eigen::Matrix<double,1,2> basis;
+					return BsplineEvalKernel<Dim,2>(t,span,degree,node,ctrl,basis);
+				}
+				case 2:
+				{
+					Eigen::Matrix<double,1,3> basis;
+					return BsplineEvalKernel<Dim,3>(t,span,degree,node,ctrl,basis);
+				}
+				case 3:
+				{
+					Eigen::Matrix<double,1,4> basis;
+					return BsplineEvalKernel<Dim,4>(t,span,degree,node,ctrl,basis);
+				}
+				case 4:
+				{
+					Eigen::Matrix<double,1,5> basis;
+					return BsplineEvalKernel<Dim,5>(t,span,degree,node,ctrl,basis);
+				}
+				case 5:
+				{
+					Eigen::Matrix<double,1,6> basis;
+					return BsplineEvalKernel<Dim,6>(t,span,degree,node,ctrl,basis);
+				}
+				default:
+				{
+					Eigen::Matrix<double,1,Eigen::Dynamic> basis(1,degree+1);
+					return BsplineEvalKernel<Dim,Eigen::Dynamic>(t,span,degree,node,ctrl,basis);
+				}
+			}
+		}
+
+		/**
+		 *  \brief Evaluate a bspline curve at several parameters
+		 *
+		 *  \tparam Dim   Control points dimension
+		 *
+		 *  \param t      Parameters (evaluation is faster if they are sorted)
+		 *  \param degree Bspline degree
+		 *  \param node   Node vector
+		 *  \param ctrl   Control points
+		 *  \param res    Out evaluations: column i is the bspline evaluation at t[i]
+		 *
+		 *  \details The span of each parameter is searched from the span of the previous one,
+		 *           and the basis buffer is shared by all the evaluations.
+		 *           Degrees 1 to 5 use kernels with fixed size buffers, other degrees the generic one.
+		 */
+		template<unsigned int Dim>
+		void BsplineEvalBatch(const std::vector<double> &t,
+							  unsigned int degree,
+							  const NodeRef &node,
+							  const Eigen::Matrix<double,Dim,Eigen::Dynamic> &ctrl,
+							  Eigen::Matrix<double,Dim,Eigen::Dynamic> &res)
+		{
+			switch(degree)
+			{
+				case 1:
+					BsplineEvalBatchKernel<Dim,2>(t,degree,node,ctrl,res);
+					break;
+				case 2:
+					BsplineEvalBatchKernel<Dim,3>(t,degree,node,ctrl,res);
+					break;
+				case 3:
+					BsplineEvalBatchKernel<Dim,4>(t,degree,node,ctrl,res);
+					break;
+				case 4:
+					BsplineEvalBatchKernel<Dim,5>(t,degree,node,ctrl,res);
+					break;
+				case 5:
+					BsplineEvalBatchKernel<Dim,6>(t,degree,node,ctrl,res);
+					break;
+				default:
+					BsplineEvalBatchKernel<Dim,Eigen::Dynamic>(t,degree,node,ctrl,res);
+					break;
+			}
+		}
+
+		/**
+		 *  \brief Evaluate a bspline curve and its first derivatives, in O(nbder * degree^2)
+		 *
+		 *  \tparam Dim   Control points dimension
+		 *
+		 *  \param t      Parameter
+		 *  \param degree Bspline degree
+		 *  \param node   Node vector
+		 *  \param ctrl   Control points
+		 *  \param nbder  Number of derivatives to compute
+		 *  \param ders   Out evaluations: column k is the k-th derivative at t
+		 *
+		 *  \details Derivatives are the ones of the bsplines built by ComputeDerivative,
+		 *           only the control points influencing t are computed.
+		 */
+		template<unsigned int Dim>
+		void BsplineDerivatives(double t,
+								unsigned int degree,
+								const NodeRef &node,
+								const Eigen::Matrix<double,Dim,Eigen::Dynamic> &ctrl,
+								unsigned int nbder,
+								Eigen::Matrix<double,Dim,Eigen::Dynamic> &ders)
+		{
+			ders.setZero(Dim,nbder+1);
+
+			Eigen::Matrix<double,1,Eigen::Dynamic> basis(1,degree+1);
+			Eigen::Matrix<double,Dim,Eigen::Dynamic> loc(Dim,degree+nbder+1);
+			for(unsigned int k = 0; k <= nbder && k <= degree && k < ctrl.cols(); k++)
+			{
+				// derivative bspline of order k: degree - k, nodes from k to node.cols()-k-1, ctrl.cols() - k control points
+				unsigned int degk = degree - k;
+				unsigned int nbctrlk = ctrl.cols() - k;
+				int first = (int)BsplineBasisSpan(t,degk,node.segment(k,node.cols()-2*k),basis) - (int)degk;
+
+				int beg = std::max(first,0);
+				int end = std::min(first+(int)degk,(int)nbctrlk-1);
+				if(beg > end)
+					continue;
+
+				// local control points of the derivative
+				loc.block(0,0,Dim,end-beg+k+1) = ctrl.block(0,beg,Dim,end-beg+k+1);
+				for(unsigned int l = 1; l <= k; l++)
+				{
+					for(int i = 0; i <= end-beg+(int)(k-l); i++)
+					{
+						loc.block(0,i,Dim,1) = (double)(degree-l+1) * (loc.block(0,i+1,Dim,1) - loc.block(0,i,Dim,1));
+						loc.block(0,i,Dim,1) /= node(0,beg+i+degree) - node(0,beg+i+l-1);
+					}
+				}
+
+				for(int i = beg; i <= end; i++)
+					ders.block(0,k,Dim,1) += loc.block(0,i-beg,Dim,1)*basis(i-first);
+			}
+		}
 	}
 }
 
@@ -145,6 +145,22 @@ namespace mathtools
 				{
 					return m_fct->der3(t);
 				}
+
+				/**
+				 *  \brief Function value, first and second derivatives
+				 *
+				 *  \param t     input of the application
+				 *  \param val   out value associated to input t
+				 *  \param dval  out first derivative associated to input t
+				 *  \param d2val out second derivative associated to input t
+				 */
+				inline void jet(const inType &t,
+								outType &val,
+								typename derivativematrix<1,dimension<outType>::value,dimension<inType>::value>::type &dval,
+								typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type &d2val) const
+				{
+					m_fct->jet(t,val,dval,d2val);
+				}
 				
 				/**
 				 *  \brief Function getter
@@ -218,6 +234,11 @@ namespace mathtools
 				 */
 				Compositor(const Fct &fct, const Fct_ &fct_, const Args&... fcts) :  m_fct(new Fct(fct)), m_next(fct_, fcts...) {};
 
+				/**
+				 *  \brief Batch evaluations which are not specialized
+				 */
+				using Application<typename Fct::outType,typename Compositor<Fct_,Args...>::inType>::evaluate;
+
 				/**
 				 *  \brief Function call
 				 *
@@ -261,25 +282,50 @@ namespace mathtools
 				inline typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type
 					der2(const inType &t) const
 				{
-					//(f_i o g)'' = Jg^t . Hf_i . Jg + sum( df_i/dyj . Hgj ) 
-					typename derivativematrix<2,dimension<typename Fct::outType>::value,dimension<typename Fct::inType>::value>::type 
-						f_sec = m_fct->der2( m_next(t) );
-					
-					typename derivativematrix<1,dimension<typename Fct::outType>::value,dimension<typename Fct::inType>::value>::type 
-						f_prim = m_fct->der( m_next(t) );
-					
-					typename derivativematrix<2,dimension<typename Compositor<Fct_,Args...>::outType>::value,dimension<typename Compositor<Fct_,Args...>::inType>::value>::type 
-						g_sec = m_next.der2(t);
-					
+					outType val;
+					typename derivativematrix<1,dimension<outType>::value,dimension<inType>::value>::type dval;
+					typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type d2val;
+					jet(t,val,dval,d2val);
+					return d2val;
+				}
+
+				/**
+				 *  \brief Function value, first and second derivatives
+				 *
+				 *  \param t     input of the application
+				 *  \param val   out value associated to input t
+				 *  \param dval  out first derivative associated to input t
+				 *  \param d2val out second derivative associated to input t
+				 *
+				 *  \details The next functions are evaluated once, the derivatives are propagated by the chain rule.
+				 */
+				inline void jet(const inType &t,
+								outType &val,
+								typename derivativematrix<1,dimension<outType>::value,dimension<inType>::value>::type &dval,
+								typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type &d2val) const
+				{
+					typename Compositor<Fct_,Args...>::outType g_val;
 					typename derivativematrix<1,dimension<typename Compositor<Fct_,Args...>::outType>::value,dimension<typename Compositor<Fct_,Args...>::inType>::value>::type 
-						g_prim = m_next.der(t);
+						g_prim;
+					typename derivativematrix<2,dimension<typename Compositor<Fct_,Args...>::outType>::value,dimension<typename Compositor<Fct_,Args...>::inType>::value>::type 
+						g_sec;
+					m_next.jet(t,g_val,g_prim,g_sec);
+
+					typename derivativematrix<1,dimension<typename Fct::outType>::value,dimension<typename Fct::inType>::value>::type 
+						f_prim;
+					typename derivativematrix<2,dimension<typename Fct::outType>::value,dimension<typename Fct::inType>::value>::type 
+						f_sec;
+					m_fct->jet(g_val,val,f_prim,f_sec);
+
+					Eigen::Map<Eigen::Matrix<double,dimension<typename Fct::outType>::value,dimension<typename Fct::inType>::value> > Jf((double*)f_prim.data());
 					Eigen::Map<Eigen::Matrix<double,dimension<typename Compositor<Fct_,Args...>::outType>::value,dimension<typename Compositor<Fct_,Args...>::inType>::value> > Jg((double*)g_prim.data());
 					
-					typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type fog_der2;
+					Eigen::Map<Eigen::Matrix<double,dimension<outType>::value,dimension<inType>::value> >((double*)dval.data()) = Jf*Jg;
 					
+					//(f_i o g)'' = Jg^t . Hf_i . Jg + sum( df_i/dyj . Hgj ) 
 					for(unsigned int i = 0; i < dimension<outType>::value; i++)
 					{
-						Eigen::Map<Eigen::Matrix<double,dimension<inType>::value,dimension<inType>::value>,0,Eigen::InnerStride<dimension<outType>::value> > fog_der2_i((double*)fog_der2.data() + i);
+						Eigen::Map<Eigen::Matrix<double,dimension<inType>::value,dimension<inType>::value>,0,Eigen::InnerStride<dimension<outType>::value> > fog_der2_i((double*)d2val.data() + i);
 						
 						Eigen::Map<Eigen::Matrix<double,dimension<typename Fct::inType>::value,dimension<typename Fct::inType>::value>,0,Eigen::Stride<dimension<typename Fct::outType>::value*dimension<typename Fct::inType>::value,dimension<typename Fct::outType>::value> > Hf_i((double*)f_sec.data() + i);
 						
@@ -291,8 +337,60 @@ namespace mathtools
 							fog_der2_i += f_prim[j][i] * Hg_j;
 						}
 					}
+				}
+
+				/**
+				 *  \brief Values and first derivatives of the composition at several inputs
+				 *
+				 *  \param t    Inputs of the application
+				 *  \param val  Out values: column i is associated to t[i]
+				 *  \param dval Out first derivatives: column i is the derivative matrix at t[i], stored as der(t[i]).data()
+				 */
+				virtual void evaluate(const std::vector<inType> &t,
+									  Eigen::Matrix<double,dimension<outType>::value,Eigen::Dynamic> &val,
+									  Eigen::Matrix<double,dimension<outType>::value*dimension<inType>::value,Eigen::Dynamic> &dval) const
+				{
+					val.resize(dimension<outType>::value,t.size());
+					dval.resize(dimension<outType>::value*dimension<inType>::value,t.size());
 					
-					return fog_der2;
+					outType v;
+					typename derivativematrix<1,dimension<outType>::value,dimension<inType>::value>::type d;
+					typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type d2;
+					for(unsigned int i = 0; i < t.size(); i++)
+					{
+						jet(t[i],v,d,d2);
+						val.col(i) = toColumn(v);
+						dval.col(i) = Eigen::Map<Eigen::Matrix<double,dimension<outType>::value*dimension<inType>::value,1> >((double*)d.data());
+					}
+				}
+
+				/**
+				 *  \brief Values, first and second derivatives of the composition at several inputs
+				 *
+				 *  \param t     Inputs of the application
+				 *  \param val   Out values: column i is associated to t[i]
+				 *  \param dval  Out first derivatives: column i is the derivative matrix at t[i], stored as der(t[i]).data()
+				 *  \param d2val Out second derivatives: column i is the derivative matrix at t[i], stored as der2(t[i]).data()
+				 */
+				virtual void evaluate(const std::vector<inType> &t,
+									  Eigen::Matrix<double,dimension<outType>::value,Eigen::Dynamic> &val,
+									  Eigen::Matrix<double,dimension<outType>::value*dimension<inType>::value,Eigen::Dynamic> &dval,
+									  Eigen::Matrix<double,dimension<outType>::value*dimension<inType>::value*dimension<inType>::value,Eigen::Dynamic> &d2val) const
+				{
+					val.resize(dimension<outType>::value,t.size());
+					dval.resize(dimension<outType>::value*dimension<inType>::value,t.size());
+					d2val.resize(dimension<outType>::value*dimension<inType>::value*dimension<inType>::value,t.size());
+					
+					outType v;
+					typename derivativematrix<1,dimension<outType>::value,dimension<inType>::value>::type d;
+					typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type d2;
+					for(unsigned int i = 0; i < t.size(); i++)
+					{
+						jet(t[i],v,d,d2);
+						val.col(i) = toColumn(v);
+						dval.col(i) = Eigen::Map<Eigen::Matrix<double,dimension<outType>::value*dimension<inType>::value,1> >((double*)d.data());
+						d2val.col(i) = Eigen::Map<Eigen::Matrix<double,dimension<outType>::value*dimension<inType>::value*dimension<inType>::value,1> >((double*)d2.data());
+					}
 				}
 
 				/**
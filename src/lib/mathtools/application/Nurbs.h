@@ -86,39 +86,188 @@ namespace mathtools
 				Eigen::Matrix<double,1,Eigen::Dynamic> m_nodevec;
 
 				/**
-				 *  \brief Control points for first derivative
+				 *  \brief Homogeneous control points: weighted coordinates, and weight in the last row
 				 */
-				Eigen::Matrix<double,Dim,Eigen::Dynamic> m_ctrlptder;
+				Eigen::Matrix<double,Dim+1,Eigen::Dynamic> m_homctrl;
 
 				/**
-				 *  \brief Weight for first derivative
+				 *  \brief Nurbs degree
 				 */
-				Eigen::Matrix<double,1,Eigen::Dynamic> m_weightder;
+				unsigned int m_degree;
 
 				/**
-				 *  \brief Node vector for first derivative
+				 *  \brief Homogeneous point and its first derivatives on an interior span, in one de Boor sweep
+				 *
+				 *  \tparam NbBasis Number of control points influencing the span (degree + 1), or Eigen::Dynamic to use the degree parameter
+				 *
+				 *  \param homctrl Homogeneous control points
+				 *  \param degree  Degree (only used if NbBasis is Eigen::Dynamic)
+				 *  \param nodevec Node vector
+				 *  \param t       Parameter
+				 *  \param span    Span of the parameter
+				 *  \param nbder   Number of derivatives to compute (0, 1 or 2)
+				 *  \param hom     Out homogeneous point (column 0) and its derivatives (columns 1 and 2)
+				 *
+				 *  \return false if the nodes of the span are not all defined, hom is then unchanged
+				 *
+				 *  \details The second derivative is the second difference of the three points of the triangle
+				 *           two levels before the end, the first derivative the difference of the two points
+				 *           one level before the end.
 				 */
-				Eigen::Matrix<double,1,Eigen::Dynamic> m_nodevecder;
+				template<int NbBasis>
+				static bool homogeneousKernel(const Eigen::Matrix<double,Dim+1,Eigen::Dynamic> &homctrl,
+											  unsigned int degree,
+											  const Eigen::Matrix<double,1,Eigen::Dynamic> &nodevec,
+											  double t,
+											  unsigned int span,
+											  unsigned int nbder,
+											  Eigen::Matrix<double,Dim+1,3> &hom)
+				{
+					const unsigned int deg = NbBasis == Eigen::Dynamic ? degree : NbBasis - 1;
+					// first point of the second difference, kept in the buffer for the degree 1 kernel (which has no second derivative)
+					const unsigned int deg2 = NbBasis == 2 ? 0 : deg - 2;
+					int first = (int)span - (int)deg;
+					if(deg == 0 || first < 0 || span + deg > nodevec.cols() || first + (int)deg >= homctrl.cols())
+						return false;
+					if(!(nodevec(0,span-1) <= t && t < nodevec(0,span)))
+						return false;
+
+					Eigen::Matrix<double,Dim+1,NbBasis> loc(Dim+1,deg+1);
+					loc = homctrl.block(0,first,Dim+1,deg+1);
+
+					double len = nodevec(0,span) - nodevec(0,span-1);
+					for(unsigned int r = 0; r <= deg; r++)
+					{
+						// level r of the triangle: loc(j) is a combination of the control points first+j-r to first+j
+						// (j > 0 is implied by r > 0, but keeps j-1 provably inside the fixed size buffer)
+						for(unsigned int j = deg; r > 0 && j >= r && j > 0; j--)
+						{
+							double beg = nodevec(0,first+j-1);
+							double alpha = (t - beg)/(nodevec(0,span+j-r) - beg);
+							loc.template block<Dim+1,1>(0,j) = (1.0 - alpha)*loc.template block<Dim+1,1>(0,j-1) + alpha*loc.template block<Dim+1,1>(0,j);
+						}
 
-				/**
-				 *  \brief Control points for second derivative
-				 */
-				Eigen::Matrix<double,Dim,Eigen::Dynamic> m_ctrlptder2;
+						if(nbder > 1 && NbBasis != 2 && r + 2 == deg)
+						{
+							hom.template block<Dim+1,1>(0,2) =
+								((loc.template block<Dim+1,1>(0,deg) - loc.template block<Dim+1,1>(0,deg-1))/(nodevec(0,span+1) - nodevec(0,span-1)) -
+								 (loc.template block<Dim+1,1>(0,deg-1) - loc.template block<Dim+1,1>(0,deg2))/(nodevec(0,span) - nodevec(0,span-2))) *
+								((double)(deg*(deg-1))/len);
+						}
+						if(nbder > 0 && r + 1 == deg)
+							hom.template block<Dim+1,1>(0,1) = (loc.template block<Dim+1,1>(0,deg) - loc.template block<Dim+1,1>(0,deg-1))*((double)deg/len);
+					}
+					hom.template block<Dim+1,1>(0,0) = loc.template block<Dim+1,1>(0,deg);
+
+					return true;
+				}
 
 				/**
-				 *  \brief Weight for second derivative
+				 *  \brief Homogeneous point and its first derivatives
+				 *
+				 *  \param t     Parameter
+				 *  \param span  Span of the parameter
+				 *  \param nbder Number of derivatives to compute (0, 1 or 2)
+				 *  \param hom   Out homogeneous point (column 0) and its derivatives (columns 1 and 2, null if not computed)
+				 *
+				 *  \details Degrees 1 to 5 use kernels with fixed size buffers. Spans close to the extremities
+				 *           of the node vector use the derivatives of the homogeneous bspline.
 				 */
-				Eigen::Matrix<double,1,Eigen::Dynamic> m_weightder2;
+				void homogeneous(double t, unsigned int span, unsigned int nbder, Eigen::Matrix<double,Dim+1,3> &hom) const
+				{
+					hom.setZero();
+
+					bool interior;
+					switch(m_degree)
+					{
+						case 1:
+							interior = homogeneousKernel<2>(m_homctrl,m_degree,m_nodevec,t,span,nbder,hom);
+							break;
+						case 2:
+							interior = homogeneousKernel<3>(m_homctrl,m_degree,m_nodevec,t,span,nbder,hom);
+							break;
+						case 3:
+							interior = homogeneousKernel<4>(m_homctrl,m_degree,m_nodevec,t,span,nbder,hom);
+							break;
+						case 4:
+							interior = homogeneousKernel<5>(m_homctrl,m_degree,m_nodevec,t,span,nbder,hom);
+							break;
+						case 5:
+							interior = homogeneousKernel<6>(m_homctrl,m_degree,m_nodevec,t,span,nbder,hom);
+							break;
+						default:
+							interior = homogeneousKernel<Eigen::Dynamic>(m_homctrl,m_degree,m_nodevec,t,span,nbder,hom);
+							break;
+					}
+
+					if(!interior)
+					{
+						Eigen::Matrix<double,Dim+1,Eigen::Dynamic> ders;
+						BsplineDerivatives<Dim+1>(t,m_degree,m_nodevec,m_homctrl,nbder,ders);
+						hom.block(0,0,Dim+1,nbder+1) = ders;
+					}
+				}
 
 				/**
-				 *  \brief Node vector for second derivative
+				 *  \brief Rational point and its first derivatives, from the homogeneous ones (quotient rule)
+				 *
+				 *  \param hom   Homogeneous point and its derivatives
+				 *  \param nbder Number of derivatives to compute (0, 1 or 2)
+				 *  \param val   Out value
+				 *  \param dval  Out first derivative (if nbder >= 1)
+				 *  \param d2val Out second derivative (if nbder >= 2)
 				 */
-				Eigen::Matrix<double,1,Eigen::Dynamic> m_nodevecder2;
+				static void project(const Eigen::Matrix<double,Dim+1,3> &hom,
+									unsigned int nbder,
+									Eigen::Matrix<double,Dim,1> &val,
+									Eigen::Matrix<double,Dim,1> &dval,
+									Eigen::Matrix<double,Dim,1> &d2val)
+				{
+					double invw = 1.0/hom(Dim,0);
+					val = hom.template block<Dim,1>(0,0)*invw;
+					if(nbder > 0)
+						dval = (hom.template block<Dim,1>(0,1) - val*hom(Dim,1))*invw;
+					if(nbder > 1)
+						d2val = (hom.template block<Dim,1>(0,2) - 2.0*dval*hom(Dim,1) - val*hom(Dim,2))*invw;
+				}
 
 				/**
-				 *  \brief Nurbs degree
+				 *  \brief Values and derivatives of the nurbs at several parameters
+				 *
+				 *  \param t     Parameters
+				 *  \param val   Out values
+				 *  \param dval  Out first derivatives (if nbder >= 1)
+				 *  \param d2val Out second derivatives (if nbder >= 2)
+				 *  \param nbder Number of derivatives to compute (0, 1 or 2)
 				 */
-				unsigned int m_degree;
+				void evaluate(const std::vector<double> &t,
+							  Eigen::Matrix<double,Dim,Eigen::Dynamic> &val,
+							  Eigen::Matrix<double,Dim,Eigen::Dynamic> &dval,
+							  Eigen::Matrix<double,Dim,Eigen::Dynamic> &d2val,
+							  unsigned int nbder) const
+				{
+					val.resize(Dim,t.size());
+					if(nbder > 0)
+						dval.resize(Dim,t.size());
+					if(nbder > 1)
+						d2val.resize(Dim,t.size());
+
+					Eigen::Matrix<double,Dim+1,3> hom;
+					Eigen::Matrix<double,Dim,1> vali, dvali, d2vali;
+					unsigned int span = 0;
+					for(unsigned int i = 0; i < t.size(); i++)
+					{
+						span = BsplineSpan(t[i],m_nodevec,span);
+						homogeneous(t[i],span,nbder,hom);
+						project(hom,nbder,vali,dvali,d2vali);
+
+						val.template block<Dim,1>(0,i) = vali;
+						if(nbder > 0)
+							dval.template block<Dim,1>(0,i) = dvali;
+						if(nbder > 1)
+							d2val.template block<Dim,1>(0,i) = d2vali;
+					}
+				}
 
 			public:
 				/**
@@ -136,51 +285,15 @@ namespace mathtools
 					  const unsigned int &degree) : 
 					Application<Eigen::Matrix<double,Dim,1>,double>(),
 					m_ctrlpt(ctrlpt), m_weight(weight), m_nodevec(nodevec),
-					m_ctrlptder(Dim,1), m_weightder(1,1), m_nodevecder(1,1),
-					m_ctrlptder2(Dim,1), m_weightder2(1,1), m_nodevecder2(1,1),
-					m_degree(degree)
+					m_homctrl(Dim+1,ctrlpt.cols()), m_degree(degree)
 				{
 					if( ctrlpt.cols() + degree != nodevec.cols()+1  )
 						throw std::logic_error("Nurbs : not verified #CtrlPt + degree = #NodeVec + 1");
-					if(m_degree>0)
-					{
-						Eigen::Matrix<double,Dim+1,Eigen::Dynamic> mat(Dim+1,m_ctrlpt.cols());
-						Eigen::Matrix<double,Dim+1,Eigen::Dynamic> dermat(Dim+1,1);
-						for(unsigned int i = 0; i < m_ctrlpt.cols(); i++)
-						{
-							mat.template block<Dim,1>(0,i) = m_ctrlpt.template block<Dim,1>(0,i)*m_weight(i);
-						}
-						mat.block(Dim,0,1,m_ctrlpt.cols()) = m_weight;
-						
-						ComputeDerivative<Dim+1>(m_degree, m_nodevec, mat, m_nodevecder, dermat);
-						
-						m_ctrlptder.resize(Dim,dermat.cols());
-						m_weightder.resize(1,dermat.cols());
-						m_weightder = dermat.block(Dim,0,1,dermat.cols());
-						for(unsigned int i = 0; i < m_ctrlptder.cols(); i++)
-						{
-							m_ctrlptder.template block<Dim,1>(0,i) = dermat.template block<Dim,1>(0,i)/m_weightder(i);
-						}
-					}
-					if(m_degree>1)
+
+					for(unsigned int i = 0; i < m_ctrlpt.cols(); i++)
 					{
-						Eigen::Matrix<double,Dim+1,Eigen::Dynamic> mat(Dim+1,m_ctrlptder.cols());
-						Eigen::Matrix<double,Dim+1,Eigen::Dynamic> dermat(Dim+1,1);
-						for(unsigned int i = 0; i < m_ctrlptder.cols(); i++)
-						{
-							mat.template block<Dim,1>(0,i) = m_ctrlptder.template block<Dim,1>(0,i)*m_weightder(i);
-						}
-						mat.block(Dim,0,1,m_ctrlptder.cols()) = m_weightder;
-						
-						ComputeDerivative<Dim+1>(m_degree-1, m_nodevecder, mat, m_nodevecder2, dermat);
-						
-						m_ctrlptder2.resize(Dim,dermat.cols());
-						m_weightder2.resize(1,dermat.cols());
-						m_weightder2 = dermat.block(Dim,0,1,dermat.cols());
-						for(unsigned int i = 0; i < m_ctrlptder2.cols(); i++)
-						{
-							m_ctrlptder2.template block<Dim,1>(0,i) = dermat.template block<Dim,1>(0,i)/m_weightder2(i);
-						}
+						m_homctrl.template block<Dim,1>(0,i) = m_ctrlpt.template block<Dim,1>(0,i)*m_weight(i);
+						m_homctrl(Dim,i) = m_weight(i);
 					}
 				}
 
@@ -191,9 +304,8 @@ namespace mathtools
 				 */
 				Nurbs(const Nurbs<Dim> &nurbs) : 
 					Application<Eigen::Matrix<double,Dim,1>,double>(),
-					m_ctrlpt(nurbs.m_ctrlpt), m_weight(nurbs.weight), m_nodevec(nurbs.m_nodevec),
-					m_ctrlptder(nurbs.m_ctrlptder), m_weightder(nurbs.weightder), m_nodevecder(nurbs.m_nodevecder),
-					m_ctrlptder2(nurbs.m_ctrlptder2), m_weightder2(nurbs.weightder2), m_nodevecder2(nurbs.m_nodevecder2),
+					m_ctrlpt(nurbs.m_ctrlpt), m_weight(nurbs.m_weight), m_nodevec(nurbs.m_nodevec),
+					m_homctrl(nurbs.m_homctrl),
 					m_degree(nurbs.m_degree) {};
 				
 				/**
@@ -202,23 +314,37 @@ namespace mathtools
 				 *  \param t Nurbs parameter
 				 * 
 				 *  \return Nurbs evaluation at t
+				 *
+				 *  \details The homogeneous point is computed as for the derivatives, then projected.
 				 */
 				Eigen::Matrix<double,Dim,1> operator()(const double &t) const
 				{
-					Eigen::Matrix<double,Dim,1> res = Eigen::Matrix<double,Dim,1>::Zero();
-					double weight = 0.0;       // weight function
-					Eigen::Matrix<double,Dim,1> comb = Eigen::Matrix<double,Dim,1>::Zero();         // linear combination of coordinates
-					
-					for(unsigned int ind = 0; ind < m_ctrlpt.cols(); ind++)
-					{
-						double basis_ind = BsplineBasis(t,m_degree,ind,m_nodevec);
-						comb += m_ctrlpt.block(0,ind,Dim,1)*basis_ind*m_weight(ind);
-						weight += basis_ind*m_weight(ind);
-					}
+					Eigen::Matrix<double,Dim+1,3> hom;
+					Eigen::Matrix<double,Dim,1> val, dval, d2val;
+					homogeneous(t,BsplineSpan(t,m_nodevec),0,hom);
+					project(hom,0,val,dval,d2val);
 
-					res = comb * (1.0/weight);
-					
-					return res;
+					return val;
+				}
+
+				/**
+				 *  \brief Value, first and second derivatives of the nurbs
+				 *
+				 *  \param t     Nurbs parameter
+				 *  \param val   Out value at t
+				 *  \param dval  Out first derivative at t
+				 *  \param d2val Out second derivative at t
+				 *
+				 *  \details The homogeneous point and its derivatives are computed together, then projected.
+				 */
+				void evaluate(const double &t,
+							  Eigen::Matrix<double,Dim,1> &val,
+							  Eigen::Matrix<double,Dim,1> &dval,
+							  Eigen::Matrix<double,Dim,1> &d2val) const
+				{
+					Eigen::Matrix<double,Dim+1,3> hom;
+					homogeneous(t,BsplineSpan(t,m_nodevec),2,hom);
+					project(hom,2,val,dval,d2val);
 				}
 
 				/**
@@ -235,29 +361,11 @@ namespace mathtools
 					
 					Eigen::Map<Eigen::Matrix<double,dimension<outType>::value,dimension<inType>::value> > res((double*)arr.data());
 
-					res.setZero();
-					if(m_degree > 0)
-					{
-						double weight = 0.0;       // weight function
-						double weight_prime = 0.0; // derivative of weight function
-						Eigen::Matrix<double,Dim,1> comb = Eigen::Matrix<double,Dim,1>::Zero();         // linear combination of coordinates
-						Eigen::Matrix<double,Dim,1> comb_prime = Eigen::Matrix<double,Dim,1>::Zero();   // derivative of linear combination of coordinates
-						
-						for(unsigned int ind = 0; ind < m_ctrlpt.cols(); ind++)
-						{
-							double basis_ind = BsplineBasis(t,m_degree,ind,m_nodevec);
-							comb += m_ctrlpt.block(0,ind,Dim,1)*basis_ind*m_weight(ind);
-							weight += basis_ind*m_weight(ind);
-						}
-
-						for(unsigned int ind = 0; ind<m_ctrlptder.cols(); ind++)
-						{
-							double basis_ind = BsplineBasis(t,m_degree-1,ind,m_nodevecder);
-							comb_prime += m_ctrlptder.block(0,ind,Dim,1)*basis_ind*m_weightder(ind);
-							weight_prime += basis_ind*m_weightder(ind);
-						}
-						res = (comb_prime*weight - comb*weight_prime)*(1.0/(weight*weight));
-					}
+					Eigen::Matrix<double,Dim+1,3> hom;
+					Eigen::Matrix<double,Dim,1> val, dval, d2val;
+					homogeneous(t,BsplineSpan(t,m_nodevec),1,hom);
+					project(hom,1,val,dval,d2val);
+					res = dval;
 
 					return arr;
 				}
@@ -275,44 +383,109 @@ namespace mathtools
 					typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type arr;
 					
 					Eigen::Map<Eigen::Matrix<double,dimension<outType>::value,dimension<inType>::value> > res((double*)arr.data());
-					
-					res.setZero();
-					
-					if(m_degree > 1)
-					{
-						double weight = 0.0;        // weight function
-						double weight_prime = 0.0;  // derivative of weight function
-						double weight_second = 0.0; // second derivative of weight function
-						Eigen::Matrix<double,Dim,1> comb = Eigen::Matrix<double,Dim,1>::Zero();          // linear combination of coordinates
-						Eigen::Matrix<double,Dim,1> comb_prime = Eigen::Matrix<double,Dim,1>::Zero();    // derivative of linear combination of coordinates
-						Eigen::Matrix<double,Dim,1> comb_second = Eigen::Matrix<double,Dim,1>::Zero();   // second derivative of linear combination of coordinates
-						
-						for(unsigned int ind = 0; ind < m_ctrlpt.cols(); ind++)
-						{
-							double basis_ind = BsplineBasis(t,m_degree,ind,m_nodevec);
-							comb += m_ctrlpt.block(0,ind,Dim,1)*basis_ind*m_weight(ind);
-							weight += basis_ind*m_weight(ind);
-						}
 
-						for(unsigned int ind = 0; ind<m_ctrlptder.cols(); ind++)
-						{
-							double basis_ind = BsplineBasis(t,m_degree-1,ind,m_nodevecder);
-							comb_prime += m_ctrlptder.block(0,ind,Dim,1)*basis_ind*m_weightder(ind);
-							weight_prime += basis_ind*m_weightder(ind);
-						}
-
-						for(unsigned int ind = 0; ind<m_ctrlptder2.cols(); ind++)
-						{
-							double basis_ind = BsplineBasis(t,m_degree-2,ind,m_nodevecder2);
-							comb_second += m_ctrlptder2.block(0,ind,Dim,1)*basis_ind*m_weightder2(ind);
-							weight_second += basis_ind*m_weightder2(ind);
-						}
-						res = (comb_second*weight*weight - comb*weight_second*weight - 2.0*comb_prime*weight_prime*weight + 2.0*comb*weight_prime*weight_prime)*(1.0/(weight*weight*weight));
-					}
+					Eigen::Matrix<double,Dim,1> val, dval, d2val;
+					evaluate(t,val,dval,d2val);
+					res = d2val;
 
 					return arr;
 				}
 
+				/**
+				 *  \brief Value, first and second derivatives of the nurbs
+				 *
+				 *  \param t     Input of the application
+				 *  \param val   Out value associated to input t
+				 *  \param dval  Out first derivative associated to input t
+				 *  \param d2val Out second derivative associated to input t
+				 *
+				 *  \details The homogeneous point and its derivatives are computed together, then projected.
+				 */
+				virtual void jet(const double &t,
+								 Eigen::Matrix<double,Dim,1> &val,
+								 typename derivativematrix<1,dimension<outType>::value,dimension<inType>::value>::type &dval,
+								 typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type &d2val) const
+				{
+					Eigen::Matrix<double,Dim,1> dvec, d2vec;
+					evaluate(t,val,dvec,d2vec);
+					Eigen::Map<Eigen::Matrix<double,Dim,1> >((double*)dval.data()) = dvec;
+					Eigen::Map<Eigen::Matrix<double,Dim,1> >((double*)d2val.data()) = d2vec;
+				}
+
+				/**
+				 *  \brief Values of the nurbs at several parameters
+				 *
+				 *  \param t   Parameters (evaluation is faster if they are sorted)
+				 *  \param val Out values: column i is associated to t[i]
+				 */
+				virtual void evaluate(const std::vector<double> &t,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &val) const
+				{
+					Eigen::Matrix<double,Dim,Eigen::Dynamic> dval, d2val;
+					evaluate(t,val,dval,d2val,0);
+				}
+
+				/**
+				 *  \brief Values and first derivatives of the nurbs at several parameters
+				 *
+				 *  \param t    Parameters (evaluation is faster if they are sorted)
+				 *  \param val  Out values: column i is associated to t[i]
+				 *  \param dval Out first derivatives: column i is associated to t[i]
+				 */
+				virtual void evaluate(const std::vector<double> &t,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &val,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &dval) const
+				{
+					Eigen::Matrix<double,Dim,Eigen::Dynamic> d2val;
+					evaluate(t,val,dval,d2val,1);
+				}
+
+				/**
+				 *  \brief Values, first and second derivatives of the nurbs at several parameters
+				 *
+				 *  \param t     Parameters (evaluation is faster if they are sorted)
+				 *  \param val   Out values: column i is associated to t[i]
+				 *  \param dval  Out first derivatives: column i is associated to t[i]
+				 *  \param d2val Out second derivatives: column i is associated to t[i]
+				 */
+				virtual void evaluate(const std::vector<double> &t,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &val,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &dval,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &d2val) const
+				{
+					evaluate(t,val,dval,d2val,2);
+				}
+
+				/**
+				 *  \brief Degree getter
+				 *
+				 *  \return degree
+				 */
+				unsigned int getDegree() const
+				{
+					return m_degree;
+				}
+
+				/**
+				 *  \brief Homogeneous control points getter
+				 *
+				 *  \return weighted coordinates of the control points, and their weight in the last row
+				 */
+				const Eigen::Matrix<double,Dim+1,Eigen::Dynamic>& getHomCtrl() const
+				{
+					return m_homctrl;
+				}
+
+				/**
+				 *  \brief Node vector getter
+				 *
+				 *  \return node vector
+				 */
+				const Eigen::Matrix<double,1,Eigen::Dynamic>& getNodeVec() const
+				{
+					return m_nodevec;
+				}
+
 				/**
 				 *  \brief Inferior boundary accessor
 				 *
@@ -0,0 +1,450 @@
+/*
+Copyright (c) 2016 Bastien Durix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/**
+ *  \file PiecewisePolynomial.h
+ *  \brief Defines piecewise polynomial curves, converted from bsplines
+ *  \author Bastien Durix
+ */
+
+#ifndef _PIECEWISEPOLYNOMIAL_H_
+#define _PIECEWISEPOLYNOMIAL_H_
+
+#include <Eigen/Dense>
+#include <memory>
+#include <stdexcept>
+#include "Application.h"
+#include "Bspline.h"
+#include "BsplineUtils.h"
+
+/**
+ *  \brief Mathematical tools
+ */
+namespace mathtools
+{
+	/**
+	 *  \brief Application tools
+	 */
+	namespace application
+	{
+		/**
+		 *  \brief Defines piecewise polynomial curve, equal to a bspline on its definition domain
+		 *
+		 *  \tparam Dim Curve dimension
+		 *
+		 *  \details On each span [a,b) of the bspline, the curve is stored in power basis, around a.
+		 *           An evaluation is a span search and a Horner scheme, derivatives being accumulated in the same scheme.
+		 *           Outside the definition domain, the first and last polynomials are extended.
+		 */
+		template<unsigned int Dim>
+		class PiecewisePolynomial : public Application<Eigen::Matrix<double,Dim,1>,double>
+		{
+			public:
+				/**
+				 *  \brief Out type of result funtion
+				 */
+				using outType = Eigen::Matrix<double,Dim,1>;
+
+				/**
+				 *  \brief In type of result funtion
+				 */
+				using inType = double;
+
+				/**
+				 *  \brief Shared pointer definition
+				 */
+				using Ptr = std::shared_ptr<PiecewisePolynomial>;
+
+			protected:
+				/**
+				 *  \brief Converted bspline
+				 */
+				typename Bspline<Dim>::Ptr m_bspline;
+
+				/**
+				 *  \brief Polynomials degree
+				 */
+				unsigned int m_degree;
+
+				/**
+				 *  \brief Span bounds (number of spans + 1)
+				 */
+				Eigen::Matrix<double,1,Eigen::Dynamic> m_breaks;
+
+				/**
+				 *  \brief Coefficients: column span*(degree+1)+k is the coefficient of (t-m_breaks(span))^k
+				 */
+				Eigen::Matrix<double,Dim,Eigen::Dynamic> m_coefs;
+
+			public:
+				/**
+				 *  \brief Constructor
+				 *
+				 *  \param bspline Bspline to convert
+				 *
+				 *  \throws std::logic_error if bspline degree is null
+				 */
+				PiecewisePolynomial(const typename Bspline<Dim>::Ptr bspline) :
+					Application<Eigen::Matrix<double,Dim,1>,double>(),
+					m_bspline(bspline), m_degree(bspline->getDegree())
+				{
+					if(m_degree == 0)
+						throw std::logic_error("PiecewisePolynomial : bspline degree has to be positive");
+
+					const Eigen::Matrix<double,1,Eigen::Dynamic> &nodevec = m_bspline->getNodeVec();
+					double infbound = m_bspline->getInfBound();
+					double supbound = m_bspline->getSupBound();
+
+					// distinct nodes of the definition domain
+					std::vector<double> breaks(1,infbound);
+					for(unsigned int i = m_degree; i < nodevec.cols(); i++)
+					{
+						if(nodevec(0,i) > breaks.back() && nodevec(0,i) <= supbound)
+							breaks.push_back(nodevec(0,i));
+					}
+					if(breaks.size() == 1)
+						breaks.push_back(supbound);
+
+					unsigned int nbspans = breaks.size()-1;
+					m_breaks = Eigen::Map<Eigen::Matrix<double,1,Eigen::Dynamic> >(breaks.data(),1,breaks.size());
+					m_coefs.resize(Dim,nbspans*(m_degree+1));
+
+					// Taylor expansion at the beginning of each span
+					Eigen::Matrix<double,Dim,Eigen::Dynamic> ders;
+					for(unsigned int s = 0; s < nbspans; s++)
+					{
+						BsplineDerivatives<Dim>(m_breaks(0,s),m_degree,nodevec,m_bspline->getCtrl(),m_degree,ders);
+
+						double fact = 1.0;
+						for(unsigned int k = 0; k <= m_degree; k++)
+						{
+							if(k > 0)
+								fact *= (double)k;
+							m_coefs.template block<Dim,1>(0,s*(m_degree+1)+k) = ders.template block<Dim,1>(0,k)/fact;
+						}
+					}
+				}
+
+				/**
+				 *  \brief Copy constructor
+				 *
+				 *  \param poly Piecewise polynomial to copy
+				 */
+				PiecewisePolynomial(const PiecewisePolynomial<Dim> &poly) :
+					Application<Eigen::Matrix<double,Dim,1>,double>(),
+					m_bspline(poly.m_bspline), m_degree(poly.m_degree),
+					m_breaks(poly.m_breaks), m_coefs(poly.m_coefs) {};
+
+			protected:
+				/**
+				 *  \brief Span search
+				 *
+				 *  \param t    Parameter
+				 *  \param hint Span of a previous parameter
+				 *
+				 *  \return span of t
+				 */
+				unsigned int span(double t, unsigned int hint = 0) const
+				{
+					// spans are separated by the interior breaks
+					return BsplineSpan(t,m_breaks.segment(1,m_breaks.cols()-2),hint);
+				}
+
+				/**
+				 *  \brief Horner scheme on a span
+				 *
+				 *  \param t     Parameter
+				 *  \param s     Span of the parameter
+				 *  \param nbder Number of derivatives to compute (0, 1 or 2)
+				 *  \param val   Out value
+				 *  \param dval  Out first derivative (if nbder >= 1)
+				 *  \param d2val Out second derivative (if nbder >= 2)
+				 */
+				inline void horner(double t, unsigned int s, unsigned int nbder,
+								   Eigen::Matrix<double,Dim,1> &val,
+								   Eigen::Matrix<double,Dim,1> &dval,
+								   Eigen::Matrix<double,Dim,1> &d2val) const
+				{
+					unsigned int beg = s*(m_degree+1);
+					double x = t - m_breaks(0,s);
+
+					val = m_coefs.template block<Dim,1>(0,beg+m_degree);
+					dval.setZero();
+					d2val.setZero();
+					for(unsigned int k = m_degree; k-- > 0;)
+					{
+						if(nbder > 1)
+							d2val = d2val*x + dval;
+						if(nbder > 0)
+							dval = dval*x + val;
+						val = val*x + m_coefs.template block<Dim,1>(0,beg+k);
+					}
+					d2val *= 2.0;
+				}
+
+			public:
+				/**
+				 *  \brief Piecewise polynomial call
+				 *
+				 *  \param t Parameter
+				 *
+				 *  \return evaluation at t
+				 */
+				Eigen::Matrix<double,Dim,1> operator()(const double &t) const
+				{
+					Eigen::Matrix<double,Dim,1> val, dval, d2val;
+					horner(t,span(t),0,val,dval,d2val);
+					return val;
+				}
+
+				/**
+				 *  \brief Function first derivative
+				 *
+				 *  \param t Input of the application
+				 *
+				 *  \returns First derivative associated to input t
+				 */
+				virtual typename derivativematrix<1,dimension<outType>::value,dimension<inType>::value>::type
+					der(const double &t) const
+				{
+					typename derivativematrix<1,dimension<outType>::value,dimension<inType>::value>::type arr;
+					Eigen::Map<Eigen::Matrix<double,Dim,1> > res((double*)arr.data());
+
+					Eigen::Matrix<double,Dim,1> val, dval, d2val;
+					horner(t,span(t),1,val,dval,d2val);
+					res = dval;
+
+					return arr;
+				}
+
+				/**
+				 *  \brief Function second derivative
+				 *
+				 *  \param t Input of the application
+				 *
+				 *  \returns Second derivative associated to input t
+				 */
+				virtual typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type
+					der2(const double &t) const
+				{
+					typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type arr;
+					Eigen::Map<Eigen::Matrix<double,Dim,1> > res((double*)arr.data());
+
+					Eigen::Matrix<double,Dim,1> val, dval, d2val;
+					horner(t,span(t),2,val,dval,d2val);
+					res = d2val;
+
+					return arr;
+				}
+
+				/**
+				 *  \brief Value, first and second derivatives of the curve
+				 *
+				 *  \param t     Input of the application
+				 *  \param val   Out value associated to input t
+				 *  \param dval  Out first derivative associated to input t
+				 *  \param d2val Out second derivative associated to input t
+				 *
+				 *  \details The three evaluations share the same Horner scheme.
+				 */
+				virtual void jet(const double &t,
+								 Eigen::Matrix<double,Dim,1> &val,
+								 typename derivativematrix<1,dimension<outType>::value,dimension<inType>::value>::type &dval,
+								 typename derivativematrix<2,dimension<outType>::value,dimension<inType>::value>::type &d2val) const
+				{
+					Eigen::Matrix<double,Dim,1> dvec, d2vec;
+					horner(t,span(t),2,val,dvec,d2vec);
+					Eigen::Map<Eigen::Matrix<double,Dim,1> >((double*)dval.data()) = dvec;
+					Eigen::Map<Eigen::Matrix<double,Dim,1> >((double*)d2val.data()) = d2vec;
+				}
+
+				/**
+				 *  \brief Values of the curve at several parameters
+				 *
+				 *  \param t   Parameters (evaluation is faster if they are sorted)
+				 *  \param val Out values: column i is associated to t[i]
+				 */
+				virtual void evaluate(const std::vector<double> &t,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &val) const
+				{
+					Eigen::Matrix<double,Dim,Eigen::Dynamic> dval, d2val;
+					evaluate(t,val,dval,d2val,0);
+				}
+
+				/**
+				 *  \brief Values and first derivatives of the curve at several parameters
+				 *
+				 *  \param t    Parameters (evaluation is faster if they are sorted)
+				 *  \param val  Out values: column i is associated to t[i]
+				 *  \param dval Out first derivatives: column i is associated to t[i]
+				 */
+				virtual void evaluate(const std::vector<double> &t,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &val,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &dval) const
+				{
+					Eigen::Matrix<double,Dim,Eigen::Dynamic> d2val;
+					evaluate(t,val,dval,d2val,1);
+				}
+
+				/**
+				 *  \brief Values, first and second derivatives of the curve at several parameters
+				 *
+				 *  \param t     Parameters (evaluation is faster if they are sorted)
+				 *  \param val   Out values: column i is associated to t[i]
+				 *  \param dval  Out first derivatives: column i is associated to t[i]
+				 *  \param d2val Out second derivatives: column i is associated to t[i]
+				 */
+				virtual void evaluate(const std::vector<double> &t,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &val,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &dval,
+									  Eigen::Matrix<double,Dim,Eigen::Dynamic> &d2val) const
+				{
+					evaluate(t,val,dval,d2val,2);
+				}
+
+			protected:
+				/**
+				 *  \brief Values and derivatives of the curve at several parameters
+				 *
+				 *  \param t     Parameters
+				 *  \param val   Out values
+				 *  \param dval  Out first derivatives (if nbder >= 1)
+				 *  \param d2val Out second derivatives (if nbder >= 2)
+				 *  \param nbder Number of derivatives to compute
+				 */
+				void evaluate(const std::vector<double> &t,
+							  Eigen::Matrix<double,Dim,Eigen::Dynamic> &val,
+							  Eigen::Matrix<double,Dim,Eigen::Dynamic> &dval,
+							  Eigen::Matrix<double,Dim,Eigen::Dynamic> &d2val,
+							  unsigned int nbder) const
+				{
+					val.resize(Dim,t.size());
+					if(nbder > 0)
+						dval.resize(Dim,t.size());
+					if(nbder > 1)
+						d2val.resize(Dim,t.size());
+
+					Eigen::Matrix<double,Dim,1> vali, dvali, d2vali;
+					unsigned int s = 0;
+					for(unsigned int i = 0; i < t.size(); i++)
+					{
+						s = span(t[i],s);
+						horner(t[i],s,nbder,vali,dvali,d2vali);
+						val.template block<Dim,1>(0,i) = vali;
+						if(nbder > 0)
+							dval.template block<Dim,1>(0,i) = dvali;
+						if(nbder > 1)
+							d2val.template block<Dim,1>(0,i) = d2vali;
+					}
+				}
+
+			public:
+				/**
+				 *  \brief Converted bspline getter
+				 *
+				 *  \return bspline the curve is equal to
+				 */
+				const typename Bspline<Dim>::Ptr getBspline() const
+				{
+					return m_bspline;
+				}
+
+				/**
+				 *  \brief Degree getter
+				 *
+				 *  \return degree
+				 */
+				unsigned int getDegree() const
+				{
+					return m_degree;
+				}
+
+				/**
+				 *  \brief Number of spans getter
+				 *
+				 *  \return number of polynomial pieces
+				 */
+				unsigned int getNbSpans() const
+				{
+					return m_breaks.cols()-1;
+				}
+
+				/**
+				 *  \brief Span bounds getter
+				 *
+				 *  \return span bounds (number of spans + 1)
+				 */
+				const Eigen::Matrix<double,1,Eigen::Dynamic>& getBreaks() const
+				{
+					return m_breaks;
+				}
+
+				/**
+				 *  \brief Bezier control points of the curve on an interval included in a span
+				 *
+				 *  \param a    Interval beginning
+				 *  \param b    Interval end
+				 *  \param ctrl Out control points (degree + 1 columns), from a to b
+				 *
+				 *  \details The curve on [a,b] is in the convex hull of these control points
+				 */
+				void getBezier(double a, double b, Eigen::Matrix<double,Dim,Eigen::Dynamic> &ctrl) const
+				{
+					unsigned int s = span(0.5*(a+b));
+					unsigned int beg = s*(m_degree+1);
+					double x = a - m_breaks(0,s);
+					double h = b - a;
+
+					// binomial coefficients
+					Eigen::MatrixXd binom = Eigen::MatrixXd::Zero(m_degree+1,m_degree+1);
+					for(unsigned int i = 0; i <= m_degree; i++)
+					{
+						binom(i,0) = 1.0;
+						for(unsigned int k = 1; k <= i; k++)
+							binom(i,k) = binom(i-1,k-1) + (k < i ? binom(i-1,k) : 0.0);
+					}
+
+					// power basis around a, on the parameter (t-a)/h
+					Eigen::Matrix<double,Dim,Eigen::Dynamic> coef(Dim,m_degree+1);
+					double hk = 1.0;
+					for(unsigned int k = 0; k <= m_degree; k++)
+					{
+						coef.template block<Dim,1>(0,k) = m_coefs.template block<Dim,1>(0,beg+m_degree)*binom(m_degree,k);
+						for(unsigned int j = m_degree; j-- > k;)
+							coef.template block<Dim,1>(0,k) = coef.template block<Dim,1>(0,k)*x + m_coefs.template block<Dim,1>(0,beg+j)*binom(j,k);
+						coef.template block<Dim,1>(0,k) *= hk;
+						hk *= h;
+					}
+
+					// power basis to Bernstein basis
+					ctrl.setZero(Dim,m_degree+1);
+					for(unsigned int i = 0; i <= m_degree; i++)
+						for(unsigned int k = 0; k <= i; k++)
+							ctrl.template block<Dim,1>(0,i) += coef.template block<Dim,1>(0,k)*(binom(i,k)/binom(m_degree,k));
+				}
+		};
+	}
+}
+
+
+#endif //_PIECEWISEPOLYNOMIAL_H_
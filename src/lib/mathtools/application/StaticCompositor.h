@@ -0,0 +1,261 @@
+/*
+Copyright (c) 2016 Bastien Durix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/**
+ *  \file StaticCompositor.h
+ *  \brief Defines statically typed application compositor
+ *  \author Bastien Durix
+ */
+
+#ifndef _STATICCOMPOSITOR_H_
+#define _STATICCOMPOSITOR_H_
+
+#include <Eigen/Dense>
+#include "Application.h"
+
+/**
+ *  \brief Mathematical tools
+ */
+namespace mathtools
+{
+	/**
+	 *  \brief Application tools
+	 */
+	namespace application
+	{
+		/**
+		 * \brief Recursive template composition of n functions, stored by value
+		 *
+		 * \tparam Fct  First function type
+		 * \tparam Args Next functions type
+		 *
+		 * \details Unlike Compositor, functions are not shared, and are called without virtual dispatch:
+		 *          the whole composition can be inlined, in inner loops. Compositor stays the
+		 *          polymorphic interface, when functions are only known at runtime.
+		 */
+		template<typename Fct, typename... Args>
+		class StaticCompositor
+		{
+			public:
+				/**
+				 *  \brief Out type of result funtion
+				 */
+				using outType = typename Fct::outType;
+
+				/**
+				 *  \brief In type of result funtion
+				 */
+				using inType = typename Fct::inType;
+
+				/**
+				 *  \brief Jacobian matrix type
+				 */
+				using jacType = Eigen::Matrix<double,dimension<outType>::value,dimension<inType>::value>;
+
+			protected:
+				/**
+				 *  \brief Current function
+				 */
+				Fct m_fct;
+
+			public:
+				/**
+				 *  \brief Constructor
+				 */
+				StaticCompositor() : m_fct() {};
+
+				/**
+				 *  \brief Constructor
+				 *
+				 *  \param fct function to compose
+				 */
+				StaticCompositor(const Fct &fct) : m_fct(fct) {};
+
+				/**
+				 *  \brief Function call
+				 *
+				 *  \param t input variable
+				 *
+				 *  \return function evaluation at t
+				 */
+				inline outType operator()(const inType &t) const
+				{
+					return m_fct.Fct::operator()(t);
+				}
+
+				/**
+				 *  \brief Jacobian matrix
+				 *
+				 *  \param t input variable
+				 *
+				 *  \return jacobian matrix at t
+				 */
+				inline jacType jac(const inType &t) const
+				{
+					return m_fct.Fct::jac(t);
+				}
+
+				/**
+				 *  \brief Function evaluation and jacobian matrix
+				 *
+				 *  \param t   input variable
+				 *  \param val out function evaluation at t
+				 *  \param jac out jacobian matrix at t
+				 */
+				inline void eval(const inType &t, outType &val, jacType &jac) const
+				{
+					val = m_fct.Fct::operator()(t);
+					jac = m_fct.Fct::jac(t);
+				}
+
+				/**
+				 *  \brief Function getter
+				 *
+				 *  \return current function
+				 */
+				inline const Fct& getFun() const
+				{
+					return m_fct;
+				}
+		};
+
+		/**
+		 * \brief Recursive template composition of n functions, stored by value
+		 *
+		 * \tparam Fct  First function type
+		 * \tparam Fct_ Second function type
+		 * \tparam Args Next functions type
+		 */
+		template<typename Fct, typename Fct_, typename... Args>
+		class StaticCompositor<Fct,Fct_,Args...>
+		{
+			public:
+				/**
+				 *  \brief Out type of result funtion
+				 */
+				using outType = typename Fct::outType;
+
+				/**
+				 *  \brief In type of result funtion
+				 */
+				using inType = typename StaticCompositor<Fct_,Args...>::inType;
+
+				/**
+				 *  \brief Jacobian matrix type
+				 */
+				using jacType = Eigen::Matrix<double,dimension<outType>::value,dimension<inType>::value>;
+
+			protected:
+				/**
+				 *  \brief Current function
+				 */
+				Fct m_fct;
+
+				/**
+				 * \brief Compositor of all the next functions
+				 */
+				StaticCompositor<Fct_,Args...> m_next;
+
+			public:
+				/**
+				 *  \brief Constructor
+				 */
+				StaticCompositor() : m_fct(), m_next() {};
+
+				/**
+				 *  \brief Constructor
+				 *
+				 *  \param fct   first function to compose
+				 *  \param fct_  second function to compose
+				 *  \param fcts  next functions
+				 */
+				StaticCompositor(const Fct &fct, const Fct_ &fct_, const Args&... fcts) : m_fct(fct), m_next(fct_, fcts...) {};
+
+				/**
+				 *  \brief Function call
+				 *
+				 *  \param t input variable
+				 *
+				 *  \return function evaluation at t
+				 */
+				inline outType operator()(const inType &t) const
+				{
+					return m_fct.Fct::operator()(m_next(t));
+				}
+
+				/**
+				 *  \brief Jacobian matrix
+				 *
+				 *  \param t input variable
+				 *
+				 *  \return jacobian matrix at t
+				 */
+				inline jacType jac(const inType &t) const
+				{
+					outType val;
+					jacType jacres;
+					eval(t,val,jacres);
+					return jacres;
+				}
+
+				/**
+				 *  \brief Function evaluation and jacobian matrix, the next functions being evaluated once
+				 *
+				 *  \param t   input variable
+				 *  \param val out function evaluation at t
+				 *  \param jac out jacobian matrix at t
+				 */
+				inline void eval(const inType &t, outType &val, jacType &jac) const
+				{
+					typename StaticCompositor<Fct_,Args...>::outType nextval;
+					typename StaticCompositor<Fct_,Args...>::jacType nextjac;
+					m_next.eval(t,nextval,nextjac);
+
+					val = m_fct.Fct::operator()(nextval);
+					jac = m_fct.Fct::jac(nextval) * nextjac;
+				}
+
+				/**
+				 *  \brief Next function getter
+				 *
+				 *  \return next functions compositor
+				 */
+				inline const StaticCompositor<Fct_,Args...>& next() const
+				{
+					return m_next;
+				}
+
+				/**
+				 *  \brief Function getter
+				 *
+				 *  \return current function
+				 */
+				inline const Fct& getFun() const
+				{
+					return m_fct;
+				}
+		};
+	}
+}
+
+#endif //_STATICCOMPOSITOR_H_
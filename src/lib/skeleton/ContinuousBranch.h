@@ -31,11 +31,18 @@ SOFTWARE.
 #define _CONTINUOUSBRANCH_H_
 
 #include <memory>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 #include <Eigen/Dense>
 #include "model/MetaModel.h"
 #include <mathtools/application/Application.h>
 #include <mathtools/application/Compositor.h>
 #include <mathtools/application/AffineFun.h>
+#include <mathtools/application/Bspline.h>
+#include <mathtools/application/PiecewisePolynomial.h>
+#include <mathtools/application/Nurbs.h>
 
 /**
  *  \brief Skeleton representations
@@ -91,6 +98,56 @@ namespace skeleton
  			 *  \brief Function giving nodes in the branch
  			 */
 			typename CompFun::Ptr m_nodefun;
+
+			/**
+			 *  \brief Parameters of the arc length table (empty if the table is not computed)
+			 */
+			std::vector<double> m_arcparam;
+
+			/**
+			 *  \brief Arc length of the branch at each parameter of the table
+			 */
+			std::vector<double> m_arclength;
+
+			/**
+			 *  \brief Speed (derivative of the arc length) at each parameter of the table
+			 */
+			std::vector<double> m_arcspeed;
+
+			/**
+			 *  \brief Number of leaves of the bounding sphere hierarchy (0 if the hierarchy is not computed)
+			 */
+			unsigned int m_nbleaves;
+
+			/**
+			 *  \brief Parameters bounding the leaves (number of leaves + 1): leaves are included in the spline spans
+			 */
+			Eigen::Matrix<double,1,Eigen::Dynamic> m_leafbound;
+
+			/**
+			 *  \brief Number of intervals between the samples of a leaf
+			 */
+			unsigned int m_nbleafsample;
+
+			/**
+			 *  \brief Centers sampled evenly on each leaf: leaf l holds samples l*m_nbleafsample to (l+1)*m_nbleafsample
+			 */
+			Eigen::Matrix<double,model::meta<Model>::stordim-1,Eigen::Dynamic> m_leafsample;
+
+			/**
+			 *  \brief Derivatives of the centers at the samples
+			 */
+			Eigen::Matrix<double,model::meta<Model>::stordim-1,Eigen::Dynamic> m_leafsampleder;
+
+			/**
+			 *  \brief Centers of the bounding spheres (heap layout: children of k are 2k+1 and 2k+2, leaves are last)
+			 */
+			Eigen::Matrix<double,model::meta<Model>::stordim-1,Eigen::Dynamic> m_spherecenter;
+
+			/**
+			 *  \brief Radii of the bounding spheres
+			 */
+			Eigen::Matrix<double,1,Eigen::Dynamic> m_sphereradius;
 			
 			/**
 			 *  \brief Constructor
@@ -100,7 +157,7 @@ namespace skeleton
 			 *  \param revfun  reverse function
 			 */
 			ContinuousBranch(const typename Model::Ptr model, const typename NodeFun::Ptr nodefun, const typename RevFun::Ptr revfun) :
-				m_model(model), m_nodefun(new mathtools::application::Compositor<NodeFun,RevFun>(nodefun,revfun)) {}
+				m_model(model), m_nodefun(new mathtools::application::Compositor<NodeFun,RevFun>(nodefun,revfun)), m_nbleaves(0) {}
 			
 		public:
 			/**
@@ -110,7 +167,7 @@ namespace skeleton
 			 *  \param nodefun node function
 			 */
 			ContinuousBranch(const typename Model::Ptr model, const typename NodeFun::Ptr nodefun) :
-				m_model(model), m_nodefun(new CompFun(nodefun,typename RevFun::Ptr(new RevFun(1,0)))) {}
+				m_model(model), m_nodefun(new CompFun(nodefun,typename RevFun::Ptr(new RevFun(1,0)))), m_nbleaves(0) {}
 			
 			/**
 			 *  \brief Constructor
@@ -127,7 +184,11 @@ namespace skeleton
 			 *  \param grcont continuous branch to copy
 			 */
 			ContinuousBranch(const ContinuousBranch<Model> &grcont) :
-				m_model(grcont.m_model), m_nodefun(grcont.m_nodefun) {}
+				m_model(grcont.m_model), m_nodefun(grcont.m_nodefun),
+				m_arcparam(grcont.m_arcparam), m_arclength(grcont.m_arclength), m_arcspeed(grcont.m_arcspeed),
+				m_nbleaves(grcont.m_nbleaves), m_leafbound(grcont.m_leafbound), m_nbleafsample(grcont.m_nbleafsample),
+				m_leafsample(grcont.m_leafsample), m_leafsampleder(grcont.m_leafsampleder),
+				m_spherecenter(grcont.m_spherecenter), m_sphereradius(grcont.m_sphereradius) {}
 			
 			/**
 			 *  \brief Model getter
@@ -166,6 +227,730 @@ namespace skeleton
 				return m_model->template toObj<TypeNode>(getNode(t));
 			}
 			
+			/**
+			 *  \brief Nodes getter, at several parameters
+			 *
+			 *  \param t     parameters of the nodes to get (evaluation is faster if they are sorted)
+			 *  \param nodes out storages: column i is associated to t[i]
+			 */
+			void evaluate(const std::vector<double> &t, Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> &nodes) const
+			{
+				Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> dnodes, d2nodes;
+				evaluate(t,nodes,dnodes,d2nodes,0);
+			}
+
+			/**
+			 *  \brief Nodes and first derivatives getter, at several parameters
+			 *
+			 *  \param t      parameters of the nodes to get (evaluation is faster if they are sorted)
+			 *  \param nodes  out storages: column i is associated to t[i]
+			 *  \param dnodes out first derivatives: column i is associated to t[i]
+			 */
+			void evaluate(const std::vector<double> &t,
+						  Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> &nodes,
+						  Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> &dnodes) const
+			{
+				Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> d2nodes;
+				evaluate(t,nodes,dnodes,d2nodes,1);
+			}
+
+			/**
+			 *  \brief Nodes, first and second derivatives getter, at several parameters
+			 *
+			 *  \param t       parameters of the nodes to get (evaluation is faster if they are sorted)
+			 *  \param nodes   out storages: column i is associated to t[i]
+			 *  \param dnodes  out first derivatives: column i is associated to t[i]
+			 *  \param d2nodes out second derivatives: column i is associated to t[i]
+			 */
+			void evaluate(const std::vector<double> &t,
+						  Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> &nodes,
+						  Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> &dnodes,
+						  Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> &d2nodes) const
+			{
+				evaluate(t,nodes,dnodes,d2nodes,2);
+			}
+
+		protected:
+			/**
+			 *  \brief Nodes and derivatives getter, at several parameters
+			 *
+			 *  \param t       parameters of the nodes to get
+			 *  \param nodes   out storages
+			 *  \param dnodes  out first derivatives (if nbder >= 1)
+			 *  \param d2nodes out second derivatives (if nbder >= 2)
+			 *  \param nbder   number of derivatives to compute
+			 *
+			 *  \details Parameters are sent through the revert function, keeping their order increasing,
+			 *           then the node function is evaluated on all of them at once.
+			 */
+			void evaluate(const std::vector<double> &t,
+						  Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> &nodes,
+						  Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> &dnodes,
+						  Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> &d2nodes,
+						  unsigned int nbder) const
+			{
+				double slope = m_nodefun->next().getFun()->getSlope();
+				double yint = m_nodefun->next().getFun()->getYIntercept();
+
+				std::vector<double> trev(t.size());
+				for(unsigned int i = 0; i < t.size(); i++)
+				{
+					// a reverted branch runs its parameters backwards: swap them to keep them sorted
+					unsigned int j = slope < 0.0 ? t.size() - 1 - i : i;
+					trev[j] = slope*t[i] + yint;
+				}
+
+				switch(nbder)
+				{
+					case 0:
+						m_nodefun->getFun()->evaluate(trev,nodes);
+						break;
+					case 1:
+						m_nodefun->getFun()->evaluate(trev,nodes,dnodes);
+						dnodes *= slope;
+						break;
+					default:
+						m_nodefun->getFun()->evaluate(trev,nodes,dnodes,d2nodes);
+						dnodes *= slope;
+						d2nodes *= slope*slope;
+						break;
+				}
+
+				if(slope < 0.0)
+				{
+					nodes = nodes.rowwise().reverse().eval();
+					if(nbder > 0)
+						dnodes = dnodes.rowwise().reverse().eval();
+					if(nbder > 1)
+						d2nodes = d2nodes.rowwise().reverse().eval();
+				}
+			}
+
+		public:
+			/**
+			 *  \brief Freezes the branch: a bspline node function is converted into a piecewise polynomial
+			 *  \return true if the node function is a piecewise polynomial
+			 *  \details The branch is evaluated faster afterwards (span search and Horner scheme),
+			 *           other branches sharing the bspline are not modified.
+			 *           Branches from Graph2Bspline (and then from the triangulation) are frozen.
+			 *           Other node functions are left unchanged: the nurbs of projected branches
+			 *           are rational, and keep their own fused evaluation.
+			 */
+			bool freeze()
+			{
+				using Spline = mathtools::application::Bspline<model::meta<Model>::stordim>;
+				using Poly = mathtools::application::PiecewisePolynomial<model::meta<Model>::stordim>;
+
+				typename Spline::Ptr bspline = std::dynamic_pointer_cast<Spline>(m_nodefun->getFun());
+				if(bspline)
+				{
+					typename NodeFun::Ptr poly(new Poly(bspline));
+					m_nodefun = typename CompFun::Ptr(new CompFun(poly,m_nodefun->next().getFun()));
+				}
+
+				return isFrozen();
+			}
+
+			/**
+			 *  \brief Tests if the branch is frozen
+			 *  \return true if the node function is a piecewise polynomial
+			 */
+			bool isFrozen() const
+			{
+				return (bool)std::dynamic_pointer_cast<mathtools::application::PiecewisePolynomial<model::meta<Model>::stordim> >(m_nodefun->getFun());
+			}
+
+		protected:
+			/**
+			 *  \brief Arc length between two parameters, by a 5 points Gauss-Legendre quadrature
+			 *
+			 *  \param a      first parameter
+			 *  \param b      last parameter
+			 *  \param speedb out speed at b
+			 *
+			 *  \return arc length of the centers between a and b
+			 */
+			double gaussArcLength(double a, double b, double &speedb) const
+			{
+				static const double abscissa[5] = {-0.9061798459386640, -0.5384693101056831, 0.0, 0.5384693101056831, 0.9061798459386640};
+				static const double weight[5] = {0.2369268850561891, 0.4786286704993665, 0.5688888888888889, 0.4786286704993665, 0.2369268850561891};
+
+				std::vector<double> t(6);
+				for(unsigned int k = 0; k < 5; k++)
+					t[k] = 0.5*(a+b) + 0.5*(b-a)*abscissa[k];
+				t[5] = b;
+
+				Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> nodes, dnodes, d2nodes;
+				evaluate(t,nodes,dnodes,d2nodes,1);
+
+				// the center is stored in all the coordinates but the last one (size)
+				double len = 0.0;
+				for(unsigned int k = 0; k < 5; k++)
+					len += weight[k]*dnodes.block(0,k,model::meta<Model>::stordim-1,1).norm();
+				speedb = dnodes.block(0,5,model::meta<Model>::stordim-1,1).norm();
+
+				return 0.5*(b-a)*len;
+			}
+
+			/**
+			 *  \brief Adds the entries of an interval to the arc length table, subdividing it until the quadrature converges
+			 *
+			 *  \param a         first parameter (already in the table)
+			 *  \param b         last parameter
+			 *  \param len       arc length between a and b
+			 *  \param tolerance relative tolerance on the arc length
+			 *  \param depth     subdivision depth
+			 */
+			void arcLengthInterval(double a, double b, double len, double tolerance, unsigned int depth)
+			{
+				double mid = 0.5*(a+b);
+				double speedmid, speedb;
+				double lenleft = gaussArcLength(a,mid,speedmid);
+				double lenright = gaussArcLength(mid,b,speedb);
+
+				if(depth < 20 && std::abs(lenleft + lenright - len) > tolerance*(lenleft + lenright))
+				{
+					arcLengthInterval(a,mid,lenleft,tolerance,depth+1);
+					arcLengthInterval(mid,b,lenright,tolerance,depth+1);
+				}
+				else
+				{
+					m_arcparam.push_back(mid);
+					m_arclength.push_back(m_arclength.back()+lenleft);
+					m_arcspeed.push_back(speedmid);
+					m_arcparam.push_back(b);
+					m_arclength.push_back(m_arclength.back()+lenright);
+					m_arcspeed.push_back(speedb);
+				}
+			}
+
+			/**
+			 *  \brief Cubic Hermite interpolation of the arc length in an interval of the table
+			 *
+			 *  \param ind  interval (between entries ind and ind+1)
+			 *  \param t    parameter
+			 *  \param dlen out derivative of the interpolated arc length
+			 *
+			 *  \return interpolated arc length at t
+			 */
+			double arcLengthHermite(unsigned int ind, double t, double &dlen) const
+			{
+				double h = m_arcparam[ind+1] - m_arcparam[ind];
+				double x = (t - m_arcparam[ind])/h;
+
+				double h00 = (1.0 + 2.0*x)*(1.0 - x)*(1.0 - x);
+				double h10 = x*(1.0 - x)*(1.0 - x);
+				double h01 = x*x*(3.0 - 2.0*x);
+				double h11 = x*x*(x - 1.0);
+
+				dlen = (6.0*x*x - 6.0*x)*(m_arclength[ind] - m_arclength[ind+1])/h +
+					   (3.0*x*x - 4.0*x + 1.0)*m_arcspeed[ind] + (3.0*x*x - 2.0*x)*m_arcspeed[ind+1];
+
+				return h00*m_arclength[ind] + h10*h*m_arcspeed[ind] + h01*m_arclength[ind+1] + h11*h*m_arcspeed[ind+1];
+			}
+
+		public:
+			/**
+			 *  \brief Computes the arc length table of the branch centers
+			 *
+			 *  \param tolerance relative tolerance on the arc length of each interval
+			 *
+			 *  \details The table is built once by adaptive Gauss-Legendre quadrature, then
+			 *           arc lengths and parameters are interpolated in it (cubic Hermite).
+			 */
+			void computeArcLength(double tolerance = 1e-8)
+			{
+				Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> nodes, dnodes, d2nodes;
+				evaluate(std::vector<double>(1,0.0),nodes,dnodes,d2nodes,1);
+
+				m_arcparam.assign(1,0.0);
+				m_arclength.assign(1,0.0);
+				m_arcspeed.assign(1,dnodes.block(0,0,model::meta<Model>::stordim-1,1).norm());
+
+				// a first uniform subdivision, so that no variation of the speed is missed
+				unsigned int nbinit = 8;
+				for(unsigned int i = 0; i < nbinit; i++)
+				{
+					double a = (double)i/(double)nbinit;
+					double b = (double)(i+1)/(double)nbinit;
+					double speedb;
+					arcLengthInterval(a,b,gaussArcLength(a,b,speedb),tolerance,0);
+				}
+			}
+
+			/**
+			 *  \brief Tests if the arc length table is computed
+			 *
+			 *  \return true if the arc length table is computed
+			 */
+			bool hasArcLength() const
+			{
+				return m_arcparam.size() != 0;
+			}
+
+			/**
+			 *  \brief Length getter
+			 *
+			 *  \return length of the branch centers
+			 *
+			 *  \throws std::logic_error if the arc length table is not computed
+			 */
+			double getLength() const
+			{
+				if(!hasArcLength())
+					throw std::logic_error("ContinuousBranch::getLength : arc length table is not computed");
+				return m_arclength.back();
+			}
+
+			/**
+			 *  \brief Arc length getter
+			 *
+			 *  \param t parameter
+			 *
+			 *  \return arc length of the branch centers between 0 and t
+			 *
+			 *  \throws std::logic_error if the arc length table is not computed
+			 */
+			double getArcLength(double t) const
+			{
+				if(!hasArcLength())
+					throw std::logic_error("ContinuousBranch::getArcLength : arc length table is not computed");
+
+				t = std::min(std::max(t,0.0),1.0);
+				unsigned int ind = std::upper_bound(m_arcparam.begin(),m_arcparam.end(),t) - m_arcparam.begin();
+				ind = std::min(std::max(ind,1u),(unsigned int)m_arcparam.size()-1) - 1;
+
+				double dlen;
+				return arcLengthHermite(ind,t,dlen);
+			}
+
+			/**
+			 *  \brief Parameter getter, by arc length
+			 *
+			 *  \param len arc length from the first node
+			 *
+			 *  \return parameter at which the arc length is len
+			 *
+			 *  \throws std::logic_error if the arc length table is not computed
+			 */
+			double getArcParam(double len) const
+			{
+				if(!hasArcLength())
+					throw std::logic_error("ContinuousBranch::getArcParam : arc length table is not computed");
+
+				len = std::min(std::max(len,0.0),m_arclength.back());
+				unsigned int ind = std::upper_bound(m_arclength.begin(),m_arclength.end(),len) - m_arclength.begin();
+				ind = std::min(std::max(ind,1u),(unsigned int)m_arclength.size()-1) - 1;
+
+				double lenbeg = m_arclength[ind], lenend = m_arclength[ind+1];
+				double tbeg = m_arcparam[ind], tend = m_arcparam[ind+1];
+				if(lenend <= lenbeg)
+					return tbeg;
+
+				// Newton iterations on the Hermite interpolation, safeguarded by bisection
+				double t = tbeg + (len - lenbeg)/(lenend - lenbeg)*(tend - tbeg);
+				for(unsigned int it = 0; it < 50; it++)
+				{
+					double dlen;
+					double diff = arcLengthHermite(ind,t,dlen) - len;
+					if(dlen > 0.0 && std::abs(diff) <= 1e-15*dlen)
+						break;
+
+					if(diff < 0.0)
+						tbeg = t;
+					else
+						tend = t;
+
+					t -= diff/dlen;
+					if(!(dlen > 0.0) || !(t > tbeg && t < tend))
+						t = 0.5*(tbeg + tend);
+				}
+				return t;
+			}
+
+			/**
+			 *  \brief Parameters evenly spaced along the branch centers
+			 *
+			 *  \param nb number of parameters
+			 *  \param t  out parameters, from 0 to 1
+			 *
+			 *  \throws std::logic_error if the arc length table is not computed
+			 */
+			void getArcSampling(unsigned int nb, std::vector<double> &t) const
+			{
+				double len = getLength();
+
+				t.resize(nb);
+				for(unsigned int i = 0; i < nb; i++)
+					t[i] = nb > 1 ? getArcParam(len*(double)i/(double)(nb-1)) : 0.0;
+			}
+
+			/**
+			 *  \brief Parameters evenly spaced along the branch centers or in the parameter
+			 *
+			 *  \param nb        number of parameters
+			 *  \param arclength true to space them along the branch centers, false in the parameter
+			 *  \param t         out parameters, from 0 to 1
+			 *
+			 *  \details If the arc length table is not computed, it is computed on a copy: the branch is left unchanged
+			 */
+			void getSampling(unsigned int nb, bool arclength, std::vector<double> &t) const
+			{
+				if(arclength)
+				{
+					if(hasArcLength())
+						getArcSampling(nb,t);
+					else
+					{
+						ContinuousBranch<Model> copy(*this);
+						copy.computeArcLength();
+						copy.getArcSampling(nb,t);
+					}
+				}
+				else
+				{
+					t.resize(nb);
+					for(unsigned int i = 0; i < nb; i++)
+						t[i] = nb > 1 ? (double)i/(double)(nb-1) : 0.0;
+				}
+			}
+
+		protected:
+			/**
+			 *  \brief Local closest center in an interval, zero of g(t) = (c(t)-pt).c'(t) found by safeguarded Newton iterations
+			 *
+			 *  \param pt point
+			 *  \param lo interval beginning
+			 *  \param hi interval end
+			 *
+			 *  \return parameter of the local closest center, or an interval bound if g does not vanish
+			 */
+			double closestInInterval(const Eigen::Matrix<double,model::meta<Model>::stordim-1,1> &pt, double lo, double hi) const
+			{
+				static constexpr unsigned int ctrdim = model::meta<Model>::stordim-1;
+
+				double t = 0.5*(lo + hi);
+				for(unsigned int it = 0; it < 50; it++)
+				{
+					Stor node;
+					typename mathtools::application::derivativematrix<1,model::meta<Model>::stordim,1>::type dnodearr;
+					typename mathtools::application::derivativematrix<2,model::meta<Model>::stordim,1>::type d2nodearr;
+					m_nodefun->jet(t,node,dnodearr,d2nodearr);
+					Eigen::Map<Stor> dnode((double*)dnodearr.data());
+					Eigen::Map<Stor> d2node((double*)d2nodearr.data());
+
+					Eigen::Matrix<double,ctrdim,1> diff = node.template block<ctrdim,1>(0,0) - pt;
+					double g = diff.dot(dnode.template block<ctrdim,1>(0,0));
+					double dg = dnode.template block<ctrdim,1>(0,0).squaredNorm() + diff.dot(d2node.template block<ctrdim,1>(0,0));
+
+					if(g < 0.0)
+						lo = t;
+					else
+						hi = t;
+
+					// bisection when the Newton step leaves the bracket
+					double tnext = t - g/dg;
+					if(!(dg > 0.0) || !(tnext > lo && tnext < hi))
+						tnext = 0.5*(lo + hi);
+					if(std::abs(tnext - t) <= 1e-15 || g == 0.0)
+						break;
+					t = tnext;
+				}
+				return t;
+			}
+
+			/**
+			 *  \brief Closest center to a point on a leaf of the hierarchy
+			 *
+			 *  \param pt   point
+			 *  \param leaf leaf of the hierarchy
+			 *  \param dist out distance between the point and the closest center of the leaf
+			 *
+			 *  \return parameter of the closest center of the leaf
+			 *
+			 *  \details The closest sample is compared to the local minima found in the intervals between samples
+			 */
+			double closestOnLeaf(const Eigen::Matrix<double,model::meta<Model>::stordim-1,1> &pt, unsigned int leaf, double &dist) const
+			{
+				static constexpr unsigned int ctrdim = model::meta<Model>::stordim-1;
+
+				unsigned int first = leaf*m_nbleafsample;
+				double tbeg = m_leafbound(0,leaf);
+				double step = (m_leafbound(0,leaf+1) - tbeg)/(double)m_nbleafsample;
+
+				double t = tbeg;
+				dist = (m_leafsample.col(first) - pt).norm();
+				double gprev = (m_leafsample.col(first) - pt).dot(m_leafsampleder.col(first));
+				for(unsigned int i = 1; i <= m_nbleafsample; i++)
+				{
+					double ti = i == m_nbleafsample ? m_leafbound(0,leaf+1) : tbeg + step*(double)i;
+					double disti = (m_leafsample.col(first+i) - pt).norm();
+					if(disti < dist)
+					{
+						dist = disti;
+						t = ti;
+					}
+
+					// g = (c-pt).c' goes from negative to positive: local minimum in the interval
+					// derivatives sampled at the leaf bounds may belong to the next span, so their sign is not trusted
+					double gi = (m_leafsample.col(first+i) - pt).dot(m_leafsampleder.col(first+i));
+					if((i == 1 || gprev < 0.0) && (i == m_nbleafsample || gi > 0.0))
+					{
+						double tloc = closestInInterval(pt,i == 1 ? tbeg : tbeg + step*(double)(i-1),ti);
+						double distloc = (getNode(tloc).template block<ctrdim,1>(0,0) - pt).norm();
+						if(distloc < dist)
+						{
+							dist = distloc;
+							t = tloc;
+						}
+					}
+					gprev = gi;
+				}
+				return t;
+			}
+
+			/**
+			 *  \brief Builds the leaves and the bounding sphere hierarchy from the polynomial pieces of the node function
+			 *
+			 *  \tparam Dim dimension of the pieces: storage dimension, or storage dimension + 1 for homogeneous coordinates
+			 *
+			 *  \param poly     pieces of the node function (in homogeneous coordinates for a nurbs)
+			 *  \param nbleaves minimal number of leaves
+			 */
+			template<unsigned int Dim>
+			void buildClosestHierarchy(const mathtools::application::PiecewisePolynomial<Dim> &poly, unsigned int nbleaves)
+			{
+				static constexpr unsigned int ctrdim = model::meta<Model>::stordim-1;
+
+				// parameters of the spline at the branch extremities
+				double slope = m_nodefun->next().getFun()->getSlope();
+				double intercept = m_nodefun->next().getFun()->getYIntercept();
+				double umin = std::min(intercept,slope + intercept);
+				double umax = std::max(intercept,slope + intercept);
+
+				// pieces of the spline covered by the branch
+				std::vector<double> cut(1,umin);
+				const Eigen::Matrix<double,1,Eigen::Dynamic> &breaks = poly.getBreaks();
+				for(unsigned int i = 1; i+1 < breaks.cols(); i++)
+					if(breaks(0,i) > umin && breaks(0,i) < umax)
+						cut.push_back(breaks(0,i));
+				cut.push_back(umax);
+				unsigned int nbpieces = cut.size()-1;
+
+				m_nbleaves = 1;
+				while(m_nbleaves < nbleaves || m_nbleaves < nbpieces)
+					m_nbleaves *= 2;
+
+				// leaves are given to the pieces whose leaves are the longest
+				std::vector<unsigned int> nbsplit(nbpieces,1);
+				for(unsigned int l = nbpieces; l < m_nbleaves; l++)
+				{
+					unsigned int longest = 0;
+					for(unsigned int i = 1; i < nbpieces; i++)
+						if((cut[i+1]-cut[i])*(double)nbsplit[longest] > (cut[longest+1]-cut[longest])*(double)nbsplit[i])
+							longest = i;
+					nbsplit[longest]++;
+				}
+
+				std::vector<double> ubound(0);
+				for(unsigned int i = 0; i < nbpieces; i++)
+					for(unsigned int j = 0; j < nbsplit[i]; j++)
+						ubound.push_back(cut[i] + (cut[i+1]-cut[i])*(double)j/(double)nbsplit[i]);
+				ubound.push_back(umax);
+
+				// leaf bounds, in the branch parameter
+				m_leafbound.resize(1,m_nbleaves+1);
+				for(unsigned int l = 0; l <= m_nbleaves; l++)
+				{
+					unsigned int ind = slope < 0.0 ? m_nbleaves-l : l;
+					m_leafbound(0,l) = slope != 0.0 ? (ubound[ind] - intercept)/slope : (double)l/(double)m_nbleaves;
+				}
+				m_leafbound(0,0) = 0.0;
+				m_leafbound(0,m_nbleaves) = 1.0;
+
+				// samples, enough to bracket the local minima of the distance to a polynomial piece
+				m_nbleafsample = std::max(2u,4*poly.getDegree());
+				std::vector<double> t(m_nbleaves*m_nbleafsample+1);
+				for(unsigned int l = 0; l < m_nbleaves; l++)
+				{
+					double step = (m_leafbound(0,l+1) - m_leafbound(0,l))/(double)m_nbleafsample;
+					for(unsigned int i = 0; i < m_nbleafsample; i++)
+						t[l*m_nbleafsample+i] = m_leafbound(0,l) + step*(double)i;
+				}
+				t.back() = 1.0;
+
+				Eigen::Matrix<double,model::meta<Model>::stordim,Eigen::Dynamic> nodes, dnodes;
+				evaluate(t,nodes,dnodes);
+				m_leafsample = nodes.block(0,0,ctrdim,t.size());
+				m_leafsampleder = dnodes.block(0,0,ctrdim,t.size());
+
+				m_spherecenter.resize(ctrdim,2*m_nbleaves-1);
+				m_sphereradius.resize(1,2*m_nbleaves-1);
+
+				// a leaf sphere contains the bezier control points of the leaf, whose convex hull contains the centers
+				Eigen::Matrix<double,Dim,Eigen::Dynamic> bezier;
+				for(unsigned int l = 0; l < m_nbleaves; l++)
+				{
+					unsigned int ind = slope < 0.0 ? m_nbleaves-1-l : l;
+					poly.getBezier(ubound[ind],ubound[ind+1],bezier);
+
+					Eigen::Matrix<double,ctrdim,Eigen::Dynamic> ctrl = bezier.block(0,0,ctrdim,bezier.cols());
+					if(Dim != model::meta<Model>::stordim)
+					{
+						for(unsigned int i = 0; i < bezier.cols(); i++)
+						{
+							if(!(bezier(Dim-1,i) > 0.0))
+								throw std::logic_error("ContinuousBranch::computeClosestHierarchy : nurbs weights have to be positive");
+							ctrl.col(i) /= bezier(Dim-1,i);
+						}
+					}
+
+					Eigen::Matrix<double,ctrdim,1> ctr = 0.5*(ctrl.rowwise().minCoeff() + ctrl.rowwise().maxCoeff());
+					double rad = 0.0;
+					for(unsigned int i = 0; i < ctrl.cols(); i++)
+						rad = std::max(rad,(ctrl.col(i) - ctr).norm());
+
+					unsigned int k = m_nbleaves-1+l;
+					m_spherecenter.col(k) = ctr;
+					m_sphereradius(0,k) = rad;
+				}
+
+				// smallest sphere containing the spheres of the children
+				for(unsigned int k = m_nbleaves-1; k-- > 0;)
+				{
+					unsigned int c1 = 2*k+1, c2 = 2*k+2;
+					double r1 = m_sphereradius(0,c1), r2 = m_sphereradius(0,c2);
+					double d = (m_spherecenter.col(c2) - m_spherecenter.col(c1)).norm();
+
+					if(d + r2 <= r1)
+					{
+						m_spherecenter.col(k) = m_spherecenter.col(c1);
+						m_sphereradius(0,k) = r1;
+					}
+					else if(d + r1 <= r2)
+					{
+						m_spherecenter.col(k) = m_spherecenter.col(c2);
+						m_sphereradius(0,k) = r2;
+					}
+					else
+					{
+						double rad = 0.5*(d + r1 + r2);
+						m_spherecenter.col(k) = m_spherecenter.col(c1) + ((rad - r1)/d)*(m_spherecenter.col(c2) - m_spherecenter.col(c1));
+						m_sphereradius(0,k) = rad;
+					}
+				}
+			}
+
+		public:
+			/**
+			 *  \brief Computes the bounding sphere hierarchy of the branch centers, used by closest center queries
+			 *
+			 *  \param nbleaves minimal number of leaves (rounded to a power of two, at least the number of spline spans)
+			 *
+			 *  \throws std::logic_error if the node function is not a bspline (frozen or not) or a nurbs with positive weights
+			 *
+			 *  \details Leaves split the spline spans. A leaf sphere contains the bezier control points of the leaf,
+			 *           so it bounds the centers of the leaf (convex hull property).
+			 */
+			void computeClosestHierarchy(unsigned int nbleaves = 64)
+			{
+				static constexpr unsigned int stordim = model::meta<Model>::stordim;
+
+				typename NodeFun::Ptr fun = m_nodefun->getFun();
+				typename mathtools::application::PiecewisePolynomial<stordim>::Ptr poly =
+					std::dynamic_pointer_cast<mathtools::application::PiecewisePolynomial<stordim> >(fun);
+				typename mathtools::application::Bspline<stordim>::Ptr bspline =
+					std::dynamic_pointer_cast<mathtools::application::Bspline<stordim> >(fun);
+				typename mathtools::application::Nurbs<stordim>::Ptr nurbs =
+					std::dynamic_pointer_cast<mathtools::application::Nurbs<stordim> >(fun);
+
+				if(poly)
+					buildClosestHierarchy(*poly,nbleaves);
+				else if(bspline)
+					buildClosestHierarchy(mathtools::application::PiecewisePolynomial<stordim>(bspline),nbleaves);
+				else if(nurbs)
+				{
+					typename mathtools::application::Bspline<stordim+1>::Ptr homspline(
+							new mathtools::application::Bspline<stordim+1>(nurbs->getHomCtrl(),nurbs->getNodeVec(),nurbs->getDegree()));
+					buildClosestHierarchy(mathtools::application::PiecewisePolynomial<stordim+1>(homspline),nbleaves);
+				}
+				else
+					throw std::logic_error("ContinuousBranch::computeClosestHierarchy : node function is not a bspline or a nurbs");
+			}
+
+			/**
+			 *  \brief Tests if the bounding sphere hierarchy is computed
+			 *
+			 *  \return true if the bounding sphere hierarchy is computed
+			 */
+			bool hasClosestHierarchy() const
+			{
+				return m_nbleaves != 0;
+			}
+
+			/**
+			 *  \brief Closest center to a point
+			 *
+			 *  \param pt   point
+			 *  \param dist out distance between the point and the closest center
+			 *  \param size out size of the node at the closest center
+			 *
+			 *  \return parameter of the closest center
+			 *
+			 *  \throws std::logic_error if the bounding sphere hierarchy is not computed
+			 *
+			 *  \details Spheres are visited nearest first and pruned when they are farther than the best center found,
+			 *           then the closest center of each visited leaf is found from its samples and refined by Newton iterations.
+			 */
+			double getClosestParam(const Eigen::Matrix<double,model::meta<Model>::stordim-1,1> &pt, double &dist, double &size) const
+			{
+				if(!hasClosestHierarchy())
+					throw std::logic_error("ContinuousBranch::getClosestParam : bounding sphere hierarchy is not computed");
+
+				// first bound: closest extremity
+				double tbest = 0.0;
+				dist = (m_leafsample.col(0) - pt).norm();
+				double distend = (m_leafsample.col(m_leafsample.cols()-1) - pt).norm();
+				if(distend < dist)
+				{
+					tbest = 1.0;
+					dist = distend;
+				}
+
+				std::vector<unsigned int> stack(1,0);
+				while(stack.size() != 0)
+				{
+					unsigned int k = stack.back();
+					stack.pop_back();
+
+					if((m_spherecenter.col(k) - pt).norm() - m_sphereradius(0,k) >= dist)
+						continue;
+
+					if(k >= m_nbleaves-1)
+					{
+						double distleaf;
+						double tleaf = closestOnLeaf(pt,k-(m_nbleaves-1),distleaf);
+						if(distleaf < dist)
+						{
+							dist = distleaf;
+							tbest = tleaf;
+						}
+					}
+					else
+					{
+						// the nearest child is visited first
+						unsigned int c1 = 2*k+1, c2 = 2*k+2;
+						if((m_spherecenter.col(c1) - pt).norm() - m_sphereradius(0,c1) < (m_spherecenter.col(c2) - pt).norm() - m_sphereradius(0,c2))
+							std::swap(c1,c2);
+						stack.push_back(c1);
+						stack.push_back(c2);
+					}
+				}
+
+				size = m_model->getSize(getNode(tbest));
+				return tbest;
+			}
+
 			/**
 			 *  \brief Composed function getter
 			 *
@@ -28,15 +28,13 @@ SOFTWARE.
  */
 
 #include "Orthographic.h"
-#include <mathtools/application/Compositor.h>
-#include <mathtools/application/LinearApp.h>
-#include <mathtools/application/Coord2Homog.h>
-
-using namespace mathtools::application;
 
 constexpr unsigned int skeleton::model::meta<skeleton::model::Orthographic>::stordim;
 
-skeleton::model::Orthographic::Orthographic(const mathtools::affine::Frame<2>::Ptr frame2, const mathtools::affine::Frame<3>::Ptr frame3) : skeleton::model::Projective(frame2,frame3)
+/*
+ *  Matrix of the R8 conversion, applied to the homogeneous coordinates of a vector
+ */
+Eigen::Matrix<double,8,4> OrthographicRetroMat(const mathtools::affine::Frame<3>::Ptr frame3)
 {
 	Eigen::Matrix3d basis3 = frame3->getBasis()->getMatrix();
 	Eigen::Vector3d ori3   = frame3->getOrigin();
@@ -50,11 +48,12 @@ skeleton::model::Orthographic::Orthographic(const mathtools::affine::Frame<2>::P
 				0.0 		 , 0.0  	    , 0.0  , basis3(2,2) ,
 				0.0			 , 0.0		    , 0.0  , 0.0         ;
 	
-	Compositor<LinearApp<8,4>,Coord2Homog<3> >::Ptr comp(new Compositor<LinearApp<8,4>,Coord2Homog<3> >(LinearApp<8,4>(retromat),Coord2Homog<3>()));
-	
-	m_r8fun = std::static_pointer_cast<Application<Eigen::Matrix<double,8,1>,Eigen::Vector3d> >(comp);
+	return retromat;
 }
 
+skeleton::model::Orthographic::Orthographic(const mathtools::affine::Frame<2>::Ptr frame2, const mathtools::affine::Frame<3>::Ptr frame3) : skeleton::model::Projective(frame2,frame3,OrthographicRetroMat(frame3))
+{}
+
 skeleton::model::Orthographic::Orthographic(const Orthographic &model) : skeleton::model::Orthographic(model.m_frame2,model.m_frame3)
 {}
 
@@ -28,12 +28,20 @@ SOFTWARE.
  */
 
 #include "Projective.h"
+#include <mathtools/application/Compositor.h>
 
 constexpr unsigned int skeleton::model::meta<skeleton::model::Projective>::stordim;
 
 skeleton::model::Projective::Projective(const mathtools::affine::Frame<2>::Ptr frame2, const mathtools::affine::Frame<3>::Ptr frame3) : m_frame2(frame2), m_frame3(frame3)
 {}
 
+skeleton::model::Projective::Projective(const mathtools::affine::Frame<2>::Ptr frame2, const mathtools::affine::Frame<3>::Ptr frame3, const Eigen::Matrix<double,8,4> &retromat) :
+	m_frame2(frame2), m_frame3(frame3),
+	m_r8fun(new mathtools::application::Compositor<mathtools::application::LinearApp<8,4>,mathtools::application::Coord2Homog<3> >(
+				mathtools::application::LinearApp<8,4>(retromat),mathtools::application::Coord2Homog<3>())),
+	m_r8static(mathtools::application::LinearApp<8,4>(retromat),mathtools::application::Coord2Homog<3>())
+{}
+
 const mathtools::affine::Frame<2>::Ptr skeleton::model::Projective::getFrame2() const
 {
 	return m_frame2;
@@ -49,6 +57,11 @@ const mathtools::application::Application<Eigen::Matrix<double,8,1>,Eigen::Vecto
 	return m_r8fun;
 }
 
+const mathtools::application::StaticCompositor<mathtools::application::LinearApp<8,4>,mathtools::application::Coord2Homog<3> >& skeleton::model::Projective::getR8StaticFun() const
+{
+	return m_r8static;
+}
+
 Eigen::Matrix<double,skeleton::model::meta<skeleton::model::Projective>::stordim,1> skeleton::model::Projective::toVec(
 		const mathtools::geometry::euclidian::HyperSphere<2> &) const
 {
@@ -38,6 +38,9 @@ SOFTWARE.
 #include <mathtools/geometry/euclidian/HyperEllipse.h>
 #include <mathtools/geometry/euclidian/Line.h>
 #include <mathtools/application/Application.h>
+#include <mathtools/application/StaticCompositor.h>
+#include <mathtools/application/LinearApp.h>
+#include <mathtools/application/Coord2Homog.h>
 
 /**
  *  \brief Skeleton representations
@@ -105,6 +108,22 @@ namespace skeleton
 				 */
 				mathtools::application::Application<Eigen::Matrix<double,8,1>,Eigen::Vector3d>::Ptr m_r8fun;
 
+				/**
+				 *  \brief Conversion function to R^4 vector, statically typed
+				 */
+				mathtools::application::StaticCompositor<mathtools::application::LinearApp<8,4>,mathtools::application::Coord2Homog<3> > m_r8static;
+
+				/**
+				 *  \brief Constructor of derived models
+				 *
+				 *  \param frame2   skeleton 2d frame
+				 *  \param frame3   skeleton 3d frame
+				 *  \param retromat matrix of the R8 conversion, applied to the homogeneous coordinates of a vector
+				 */
+				Projective(const mathtools::affine::Frame<2>::Ptr frame2,
+						   const mathtools::affine::Frame<3>::Ptr frame3,
+						   const Eigen::Matrix<double,8,4> &retromat);
+
 			public:
 				/**
 				 *  \brief Constructor
@@ -136,6 +155,13 @@ namespace skeleton
 				 */
 				const mathtools::application::Application<Eigen::Matrix<double,8,1>,Eigen::Vector3d>::Ptr getR8Fun() const;
 
+				/**
+				 *  \brief Statically typed R8 conversion function getter
+				 *
+				 *  \return R8 conversion function, evaluated without virtual calls (for inner loops)
+				 */
+				const mathtools::application::StaticCompositor<mathtools::application::LinearApp<8,4>,mathtools::application::Coord2Homog<3> >& getR8StaticFun() const;
+
 				/**
 				 *  \brief Converts an object into a vector
 				 *
@@ -49,6 +49,7 @@ SOFTWARE.
 #include <algorithm/evaluation/ReprojError.h>
 
 #include <userinput/ClickSkelNode.h>
+#include <userinput/AutoSkelNode.h>
 #include <fileio/CameraFile.h>
 #include <fileio/BoundaryFile.h>
 #include <fileio/ExtClickFile.h>
@@ -69,7 +70,10 @@ int main(int argc, char** argv)
 	std::string outbound;
 	std::string extskelfile;
 	double sat;
+	double fittol;
+	double fitsizetol;
 	unsigned int nbimg;
+	bool autoext;
 	
 	boost::program_options::options_description desc("OPTIONS");
 	
@@ -81,7 +85,10 @@ int main(int argc, char** argv)
 		("camfile", boost::program_options::value<std::string>(&camfile)->default_value("cam"), "Camera file (*.xml)")
 		("outbound", boost::program_options::value<std::string>(&outbound)->default_value("skelrec.obj"), "Boundary output file")
 		("extskelfile", boost::program_options::value<std::string>(&extskelfile)->default_value("extskel.txt"), "Extremities Skeleton file")
+		("autoext", boost::program_options::bool_switch(&autoext), "Associate extremities automatically, instead of clicking them")
 		("sat", boost::program_options::value<double>(&sat)->default_value(1.2), "Scale Axis Transform parameter")
+		("fittol", boost::program_options::value<double>(&fittol)->default_value(0.0), "Center tolerance of the adaptive bspline fitting (0: fixed proportion of control points)")
+		("fitsizetol", boost::program_options::value<double>(&fitsizetol)->default_value(0.0), "Size tolerance of the adaptive bspline fitting (0: same as fittol)")
 		;
 	
 	boost::program_options::variables_map vm;
@@ -142,6 +149,13 @@ int main(int argc, char** argv)
 	std::cout << "Creating reconstruction skeleton" << std::endl;
 	skeleton::ReconstructionSkeleton::Ptr recskel(new skeleton::ReconstructionSkeleton());
 	
+	if(assoc_ext.size() == 0 && autoext)
+	{
+		assoc_ext = userinput::AutoSkelExtremities(vecprskel,extskelfile);
+		if(assoc_ext.size() == 0)
+			return -1;
+	}
+	
 	if(assoc_ext.size() == 0)
 	{
 		std::cout << "How many extremities are visible in all images?" << std::endl;
@@ -179,7 +193,10 @@ int main(int argc, char** argv)
 	std::cout << "Fitting Bspline" << std::endl;
 	for(unsigned int i = 0; i < vec_comppr.size(); i++)
 	{
-		vec_compcontpr[i] = algorithm::fitbspline::Graph2Bspline(vec_comppr[i]);
+		if(fittol > 0.0)
+			vec_compcontpr[i] = algorithm::fitbspline::Graph2BsplineAdaptive(vec_comppr[i],fittol,fitsizetol > 0.0 ? fitsizetol : fittol);
+		else
+			vec_compcontpr[i] = algorithm::fitbspline::Graph2Bspline(vec_comppr[i]);
 	}
 	
 	std::cout << "Matching" << std::endl;
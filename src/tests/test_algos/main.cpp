@@ -29,14 +29,26 @@ SOFTWARE.
 #include <shape/DiscreteShape.h>
 #include <boundary/DiscreteBoundary.h>
 #include <skeleton/Skeletons.h>
+#include <skeleton/model/Perspective.h>
 
 #include <algorithm/extractboundary/MarchingSquares.h>
 #include <algorithm/graphoperation/ConnectedComponents.h>
 #include <algorithm/skeletonization/VoronoiSkeleton2D.h>
 #include <algorithm/graphoperation/SeparateBranches.h>
+#include <algorithm/graphoperation/TreePathIndex.h>
+#include <algorithm/graphoperation/EdgeSignature.h>
+#include <algorithm/graphoperation/AssociateExtremities.h>
 #include <algorithm/fitbspline/Graph2Bspline.h>
+#include <algorithm/fitbspline/FitBspline.h>
+#include <algorithm/fitbspline/ComputeNodeVector.h>
+#include <algorithm/matchskeletons/SkelMatching.h>
+#include <algorithm/matchskeletons/SkelMatchingOde.h>
+#include <skeleton/model/Orthographic.h>
+#include <mathtools/application/Bspline.h>
+#include <mathtools/application/Nurbs.h>
 
 #include <iostream>
+#include <algorithm>
 
 #ifdef _WIN32
 #define BOOST_TEST_STATIC_LINK
@@ -73,6 +85,68 @@ void verifybound(const boundary::DiscreteBoundary<2>::Ptr disbnd, const std::vec
 	}
 }
 
+// orthographic projections of a same 3d branch, seen from views rotated around the vertical axis
+// (nurbs with unit weights, or frozen bsplines)
+std::vector<skeleton::BranchContProjSkel::Ptr> projectbranch(unsigned int nbview, double bend, bool frozen = false)
+{
+	std::vector<skeleton::BranchContProjSkel::Ptr> projbr(0);
+	for(unsigned int k = 0; k < nbview; k++)
+	{
+		double a = 0.7*(double)k;
+		mathtools::affine::Frame<3>::Ptr frame = mathtools::affine::Frame<3>::CreateFrame(Eigen::Vector3d(0.0,0.0,0.0),
+				Eigen::Vector3d(cos(a),0.0,sin(a)),Eigen::Vector3d(0.0,1.0,0.0),Eigen::Vector3d(-sin(a),0.0,cos(a)));
+		skeleton::model::Projective::Ptr model(new skeleton::model::Orthographic(mathtools::affine::Frame<2>::CanonicFrame(),frame));
+
+		Eigen::Matrix<double,1,Eigen::Dynamic> nodevec(1,8);
+		nodevec << 0.0, 0.0, 0.0, 0.2+0.05*(double)k, 0.66, 1.0, 1.0, 1.0;
+		Eigen::Matrix<double,3,Eigen::Dynamic> ctrlpt(3,6);
+		Eigen::Matrix<double,1,Eigen::Dynamic> weight = Eigen::Matrix<double,1,Eigen::Dynamic>::Ones(1,6);
+		for(unsigned int i = 0; i < 6; i++)
+		{
+			Eigen::Vector3d pt((double)i, bend*sin((double)i), 0.05*bend*(double)(i*i));
+			ctrlpt.block<2,1>(0,i) = (frame->getBasis()->getMatrixInverse()*pt).block<2,1>(0,0);
+			ctrlpt(2,i) = 1.0 + 0.1*(double)i + 0.05*(double)k;
+		}
+		if(frozen)
+		{
+			mathtools::application::Bspline<3>::Ptr bspline(new mathtools::application::Bspline<3>(ctrlpt,nodevec,3));
+			projbr.push_back(skeleton::BranchContProjSkel::Ptr(new skeleton::BranchContProjSkel(model,bspline)));
+			projbr.back()->freeze();
+		}
+		else
+		{
+			mathtools::application::Nurbs<3>::Ptr nurbs(new mathtools::application::Nurbs<3>(ctrlpt,weight,nodevec,3));
+			projbr.push_back(skeleton::BranchContProjSkel::Ptr(new skeleton::BranchContProjSkel(model,nurbs)));
+		}
+	}
+	return projbr;
+}
+
+// checks that two matches are identical
+void verifymatch(const skeleton::ReconstructionBranch::Ptr recbr1, const skeleton::ReconstructionBranch::Ptr recbr2)
+{
+	BOOST_REQUIRE( recbr1->isMatched() && recbr2->isMatched() );
+	BOOST_REQUIRE( recbr1->getMatch().size() == recbr2->getMatch().size() );
+	for(unsigned int i = 0; i < recbr1->getMatch().size(); i++)
+		BOOST_CHECK( recbr1->getMatch()[i] == recbr2->getMatch()[i] );
+}
+
+// data of the matching ode of projected branches
+algorithm::matchskeletons::DataODE dataode(const std::vector<skeleton::BranchContProjSkel::Ptr> &projbr, double lambda, double deltat,
+		algorithm::matchskeletons::OptionsMatch::enum_integrator integrator = algorithm::matchskeletons::OptionsMatch::euler,
+		unsigned int linefield = 0)
+{
+	algorithm::matchskeletons::DataODE data;
+	for(unsigned int i = 0; i < projbr.size(); i++)
+		data.skel.push_back(algorithm::matchskeletons::TabulateLine(projbr[i],linefield));
+	data.lambda = lambda;
+	data.deltat = deltat;
+	data.nbhist = 0;
+	data.integrator = integrator;
+	data.odetol = 1e-6;
+	return data;
+}
+
 BOOST_AUTO_TEST_CASE( MarchingSquares )
 {
 	// image preparation
@@ -249,6 +323,173 @@ BOOST_AUTO_TEST_CASE( ComponentSeparation )
 	}
 }
 
+BOOST_AUTO_TEST_CASE( ComponentLabelling )
+{
+	skeleton::GraphSkel2d::Ptr grskel(new skeleton::GraphSkel2d(skeleton::model::Classic<2>{}));
+	
+	unsigned int ind0 = grskel->addNode(Eigen::Vector3d(1.0,1.0,0.5));
+	unsigned int ind1 = grskel->addNode(Eigen::Vector3d(2.0,1.0,0.5));
+	unsigned int ind2 = grskel->addNode(Eigen::Vector3d(3.0,1.0,0.5));
+	unsigned int ind3 = grskel->addNode(Eigen::Vector3d(4.0,1.0,0.5));
+	unsigned int ind4 = grskel->addNode(Eigen::Vector3d(5.0,1.0,0.5));
+	unsigned int ind5 = grskel->addNode(Eigen::Vector3d(6.0,1.0,0.5));
+	unsigned int ind6 = grskel->addNode(Eigen::Vector3d(7.0,1.0,0.5));
+	grskel->remNode(ind5);
+	unsigned int indfar = 0x10100;
+	grskel->addNode(indfar,Eigen::Vector3d(8.0,1.0,0.5));
+	
+	// 0-3 / 1 / 2-4-6 / far
+	grskel->addEdge(ind3,ind0);
+	grskel->addEdge(ind4,ind2);
+	grskel->addEdge(ind6,ind4);
+
+	algorithm::graphoperation::ComponentLabels labels = algorithm::graphoperation::LabelComponents(grskel);
+
+	BOOST_REQUIRE(labels.getNbComponents() == 4);
+	BOOST_REQUIRE(labels.nodes.size() == 7);
+	BOOST_REQUIRE(labels.keys.size() == 7 && labels.label.size() == 7);
+	BOOST_REQUIRE(labels.offset[0] == 0 && labels.offset[4] == 7);
+	BOOST_CHECK(std::is_sorted(labels.keys.begin(),labels.keys.end()));
+
+	// components are ordered by their smallest node index
+	BOOST_CHECK(labels.getLabel(ind0) == 0 && labels.getLabel(ind3) == 0);
+	BOOST_CHECK(labels.getLabel(ind1) == 1);
+	BOOST_CHECK(labels.getLabel(ind2) == 2 && labels.getLabel(ind4) == 2 && labels.getLabel(ind6) == 2);
+	BOOST_CHECK(labels.getLabel(indfar) == 3);
+	BOOST_CHECK(labels.getLabel(ind5) == algorithm::graphoperation::ComponentLabels::NoLabel);
+	BOOST_CHECK(labels.getLabel(ind6+1) == algorithm::graphoperation::ComponentLabels::NoLabel);
+
+	for(unsigned int c = 0; c < labels.getNbComponents(); c++)
+	{
+		for(unsigned int i = labels.offset[c]; i < labels.offset[c+1]; i++)
+		{
+			BOOST_CHECK(labels.getLabel(labels.nodes[i]) == c);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( TreePathQueries )
+{
+	skeleton::GraphSkel2d::Ptr grskel(new skeleton::GraphSkel2d(skeleton::model::Classic<2>{}));
+	
+	unsigned int ind0 = grskel->addNode(Eigen::Vector3d(0.0,0.0,0.5));
+	unsigned int ind1 = grskel->addNode(Eigen::Vector3d(1.0,0.0,0.5));
+	unsigned int ind2 = grskel->addNode(Eigen::Vector3d(2.0,0.0,0.5));
+	unsigned int ind3 = grskel->addNode(Eigen::Vector3d(1.0,1.0,0.5));
+	unsigned int ind4 = grskel->addNode(Eigen::Vector3d(1.0,2.0,0.5));
+	unsigned int ind5 = grskel->addNode(Eigen::Vector3d(5.0,5.0,0.5));
+	
+	// 0-1-2, 1-3-4, and 5 alone
+	grskel->addEdge(ind0,ind1);
+	grskel->addEdge(ind1,ind2);
+	grskel->addEdge(ind1,ind3);
+	grskel->addEdge(ind3,ind4);
+
+	algorithm::graphoperation::TreePathIndex pathind(grskel);
+
+	std::vector<unsigned int> path = pathind.getPath(ind4,ind2);
+	BOOST_REQUIRE(path.size() == 4);
+	BOOST_CHECK(path[0] == ind4);
+	BOOST_CHECK(path[1] == ind3);
+	BOOST_CHECK(path[2] == ind1);
+	BOOST_CHECK(path[3] == ind2);
+
+	BOOST_CHECK(pathind.getPathLength(ind0,ind4) == 3);
+	BOOST_CHECK(pathind.getPathLength(ind2,ind2) == 0);
+	BOOST_CHECK(pathind.isOnPath(ind0,ind4,ind1));
+	BOOST_CHECK(pathind.isOnPath(ind0,ind4,ind4));
+	BOOST_CHECK(!pathind.isOnPath(ind0,ind4,ind2));
+	BOOST_CHECK(!pathind.isOnPath(ind0,ind4,ind5));
+	BOOST_CHECK(!pathind.areConnected(ind0,ind5));
+	BOOST_CHECK_THROW(pathind.getPath(ind0,ind5), std::logic_error);
+
+	// closing a cycle makes the index unavailable
+	grskel->addEdge(ind2,ind4);
+	BOOST_CHECK_THROW(algorithm::graphoperation::TreePathIndex cycind(grskel), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE( EdgeSignatures )
+{
+	algorithm::graphoperation::EdgeSignature::Bitset side1(5), side2(5), side3(5);
+	// {1,3} | {0,2,4}
+	side1.set(1); side1.set(3);
+	side2 = ~side1;
+	// {0,1} | {2,3,4}
+	side3.set(0); side3.set(1);
+
+	algorithm::graphoperation::EdgeSignature sign1(side1), sign2(side2), sign3(side3);
+
+	BOOST_CHECK(sign1 == sign2);
+	BOOST_CHECK(sign1.getHash() == sign2.getHash());
+	BOOST_CHECK(sign1 != sign3);
+	BOOST_CHECK(sign1.getFirstSide() == side2);
+	BOOST_CHECK(sign1.getSecondSide() == side1);
+
+	// {0,1,...} is before {0,2,...}
+	BOOST_CHECK(sign3 < sign1);
+	BOOST_CHECK(!(sign1 < sign3));
+
+	algorithm::graphoperation::EdgeSignatureMap<unsigned int> indsign;
+	indsign[sign1] = 1;
+	indsign[sign3] = 3;
+	BOOST_REQUIRE(indsign.size() == 2);
+	BOOST_CHECK(indsign[sign2] == 1);
+}
+
+BOOST_AUTO_TEST_CASE( ExtremitiesAssociation )
+{
+	// star shaped 3d skeleton
+	std::vector<Eigen::Vector3d> tips(4);
+	tips[0] = Eigen::Vector3d( 1.0, 0.0, 0.0);
+	tips[1] = Eigen::Vector3d(-1.0, 0.2, 0.0);
+	tips[2] = Eigen::Vector3d( 0.0, 1.0, 0.3);
+	tips[3] = Eigen::Vector3d( 0.1,-1.0,-0.2);
+
+	std::vector<mathtools::affine::Frame<3>::Ptr> frames(2);
+	frames[0] = mathtools::affine::Frame<3>::CreateFrame(Eigen::Vector3d(0.0,0.0,-5.0),Eigen::Vector3d(1.0,0.0,0.0),Eigen::Vector3d(0.0,1.0,0.0),Eigen::Vector3d(0.0,0.0,1.0));
+	frames[1] = mathtools::affine::Frame<3>::CreateFrame(Eigen::Vector3d(5.0,0.0,0.0),Eigen::Vector3d(0.0,0.0,1.0),Eigen::Vector3d(0.0,1.0,0.0),Eigen::Vector3d(-1.0,0.0,0.0));
+
+	// tips are added in a different order in each view
+	std::vector<std::vector<unsigned int> > order(2);
+	order[0] = {0,1,2,3};
+	order[1] = {2,0,3,1};
+
+	std::vector<skeleton::GraphProjSkel::Ptr> vec_skel(2);
+	std::vector<std::map<unsigned int,unsigned int> > tipofnode(2);
+	for(unsigned int i = 0; i < 2; i++)
+	{
+		skeleton::model::Projective::Ptr model(new skeleton::model::Perspective(mathtools::affine::Frame<2>::CanonicFrame(),frames[i]));
+		vec_skel[i] = skeleton::GraphProjSkel::Ptr(new skeleton::GraphProjSkel(model));
+
+		Eigen::Matrix3d rot = frames[i]->getBasis()->getMatrix();
+		Eigen::Vector3d cen = rot.transpose()*(Eigen::Vector3d::Zero() - frames[i]->getOrigin());
+		unsigned int indcen = vec_skel[i]->addNode(Eigen::Vector3d(cen(0)/cen(2),cen(1)/cen(2),0.02));
+		for(unsigned int j = 0; j < 4; j++)
+		{
+			Eigen::Vector3d mid = rot.transpose()*(0.5*tips[order[i][j]] - frames[i]->getOrigin());
+			Eigen::Vector3d tip = rot.transpose()*(tips[order[i][j]] - frames[i]->getOrigin());
+			unsigned int indmid = vec_skel[i]->addNode(Eigen::Vector3d(mid(0)/mid(2),mid(1)/mid(2),0.02));
+			unsigned int indtip = vec_skel[i]->addNode(Eigen::Vector3d(tip(0)/tip(2),tip(1)/tip(2),0.02));
+			vec_skel[i]->addEdge(indcen,indmid);
+			vec_skel[i]->addEdge(indmid,indtip);
+			tipofnode[i][indtip] = order[i][j];
+		}
+	}
+
+	std::vector<std::vector<double> > confidence;
+	std::vector<std::vector<unsigned int> > assoc_ext = algorithm::graphoperation::AssociateExtremities(vec_skel,confidence);
+
+	BOOST_REQUIRE(assoc_ext.size() == 2);
+	BOOST_REQUIRE(assoc_ext[0].size() == 4);
+	BOOST_REQUIRE(assoc_ext[1].size() == 4);
+	BOOST_REQUIRE(confidence.size() == 2);
+	for(unsigned int k = 0; k < 4; k++)
+	{
+		BOOST_CHECK(tipofnode[0][assoc_ext[0][k]] == tipofnode[1][assoc_ext[1][k]]);
+		BOOST_CHECK(confidence[1][k] > 0.0 && confidence[1][k] <= 1.0);
+	}
+}
+
 void verifyskel(const skeleton::GraphSkel2d::Ptr grskel, const std::vector<Eigen::Vector3d> &wantedskl, const std::list<std::pair<unsigned int,unsigned int> > &wantededg)
 {
 	std::vector<unsigned int> index(0);
@@ -335,6 +576,145 @@ BOOST_AUTO_TEST_CASE( Skeletonization )
 	verifyskel(grskel,wantedskl,wantededg);
 }
 
+BOOST_AUTO_TEST_CASE( BandedBsplineFit )
+{
+	unsigned int degree = 3;
+	unsigned int nb_approx = 200;
+	std::vector<Eigen::Vector2d> approx_vec(0);
+	for(unsigned int i = 0; i < nb_approx; i++)
+		approx_vec.push_back(Eigen::Vector2d((double)i*0.05,sin((double)i*0.05) + 0.01*cos((double)(i*i))));
+
+	Eigen::Matrix<double,1,Eigen::Dynamic> approx_nod = algorithm::fitbspline::ComputeApproxNodeVec<2>(approx_vec);
+	Eigen::Matrix<double,1,Eigen::Dynamic> nod_vec = algorithm::fitbspline::ComputeNodeVec(approx_nod,degree,20);
+
+	mathtools::application::Bspline<2> bspline = algorithm::fitbspline::FitBspline<2>(approx_vec,approx_nod,nod_vec,degree);
+	Eigen::Matrix<double,2,Eigen::Dynamic> ctrl = bspline.getCtrl();
+
+	// dense least squares reference, with fixed extremities
+	unsigned int nb_ctrl = ctrl.cols();
+	Eigen::MatrixXd basis_mat(nb_approx,nb_ctrl-2);
+	Eigen::Matrix<double,Eigen::Dynamic,2> rhs(nb_approx,2);
+	for(unsigned int i = 0; i < nb_approx; i++)
+	{
+		rhs.row(i) = approx_vec[i].transpose()
+			- mathtools::application::BsplineBasis(approx_nod(0,i),degree,0,nod_vec)*approx_vec[0].transpose()
+			- mathtools::application::BsplineBasis(approx_nod(0,i),degree,nb_ctrl-1,nod_vec)*approx_vec[nb_approx-1].transpose();
+		for(unsigned int j = 1; j < nb_ctrl-1; j++)
+			basis_mat(i,j-1) = mathtools::application::BsplineBasis(approx_nod(0,i),degree,j,nod_vec);
+	}
+	Eigen::Matrix<double,Eigen::Dynamic,2> ref = basis_mat.householderQr().solve(rhs);
+
+	BOOST_REQUIRE(nb_ctrl == 20);
+	BOOST_CHECK(ctrl.col(0).isApprox(approx_vec[0]));
+	BOOST_CHECK(ctrl.col(nb_ctrl-1).isApprox(approx_vec[nb_approx-1]));
+	BOOST_CHECK((ctrl.block(0,1,2,nb_ctrl-2) - ref.transpose()).norm() < 1e-10);
+
+	// banded solver on rows given in any order
+	Eigen::MatrixXd band_mat(4,2);
+	band_mat << 1.0, 2.0,
+				3.0, 1.0,
+				1.0, 0.0,
+				2.0, 1.0;
+	std::vector<unsigned int> first_col = {1, 0, 2, 0};
+	Eigen::Matrix<double,Eigen::Dynamic,1> band_rhs(4,1);
+	band_rhs << 1.0, 2.0, 3.0, 4.0;
+	Eigen::MatrixXd dense_mat = Eigen::MatrixXd::Zero(4,3);
+	for(unsigned int i = 0; i < 4; i++)
+		for(unsigned int l = 0; l < 2 && first_col[i]+l < 3; l++)
+			dense_mat(i,first_col[i]+l) = band_mat(i,l);
+
+	Eigen::Matrix<double,Eigen::Dynamic,1> sol = algorithm::fitbspline::BandedLeastSquares<1>(band_mat,first_col,band_rhs,3);
+	BOOST_CHECK((sol - dense_mat.householderQr().solve(band_rhs)).norm() < 1e-12);
+
+	// no vector in the support of some control points: they stay finite, and the fit is still a least squares one
+	Eigen::Matrix<double,1,Eigen::Dynamic> gap_nod(1,nb_approx);
+	for(unsigned int i = 0; i < nb_approx; i++)
+		gap_nod(0,i) = i < nb_approx/2 ? 0.3*(double)i/(double)(nb_approx/2-1) : 0.7 + 0.3*(double)(i-nb_approx/2)/(double)(nb_approx/2-1);
+	std::vector<double> gap_knots(0);
+	for(unsigned int i = 1; i < 17; i++)
+		gap_knots.push_back((double)i/17.0);
+	Eigen::Matrix<double,1,Eigen::Dynamic> gap_nodvec = algorithm::fitbspline::ComputeNodeVec(gap_knots,0.0,1.0,degree);
+	mathtools::application::Bspline<2> gap_bspline = algorithm::fitbspline::FitBspline<2>(approx_vec,gap_nod,gap_nodvec,degree);
+	Eigen::Matrix<double,2,Eigen::Dynamic> gap_ctrl = gap_bspline.getCtrl();
+	BOOST_REQUIRE(gap_ctrl.cols() == nb_ctrl);
+	BOOST_CHECK(gap_ctrl.allFinite());
+
+	Eigen::MatrixXd gap_mat(nb_approx,nb_ctrl-2);
+	Eigen::Matrix<double,Eigen::Dynamic,2> gap_rhs(nb_approx,2);
+	for(unsigned int i = 0; i < nb_approx; i++)
+	{
+		gap_rhs.row(i) = approx_vec[i].transpose()
+			- mathtools::application::BsplineBasis(gap_nod(0,i),degree,0,gap_nodvec)*approx_vec[0].transpose()
+			- mathtools::application::BsplineBasis(gap_nod(0,i),degree,nb_ctrl-1,gap_nodvec)*approx_vec[nb_approx-1].transpose();
+		for(unsigned int j = 1; j < nb_ctrl-1; j++)
+			gap_mat(i,j-1) = mathtools::application::BsplineBasis(gap_nod(0,i),degree,j,gap_nodvec);
+	}
+	BOOST_REQUIRE(gap_mat.colPivHouseholderQr().rank() < nb_ctrl-2);
+	Eigen::Matrix<double,Eigen::Dynamic,2> gap_ref = gap_mat.colPivHouseholderQr().solve(gap_rhs);
+	BOOST_CHECK(std::abs((gap_mat*gap_ctrl.block(0,1,2,nb_ctrl-2).transpose() - gap_rhs).norm() - (gap_mat*gap_ref - gap_rhs).norm()) < 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE( AdaptiveBsplineFit )
+{
+	unsigned int degree = 3;
+	double tolerance = 1e-3;
+
+	// straight segment: no interior knot needed
+	std::vector<Eigen::Vector2d> line_vec(0);
+	for(unsigned int i = 0; i < 100; i++)
+		line_vec.push_back(Eigen::Vector2d((double)i*0.1,(double)i*0.05));
+	Eigen::Matrix<double,1,Eigen::Dynamic> line_nod = algorithm::fitbspline::ComputeApproxNodeVec<2>(line_vec);
+	mathtools::application::Bspline<2> line_bsp = algorithm::fitbspline::FitBsplineAdaptive<2>(line_vec,line_nod,degree,tolerance);
+	BOOST_CHECK(line_bsp.getCtrl().cols() == degree+1);
+
+	// straight segment followed by a tight turn: knots are inserted where the curvature is
+	std::vector<Eigen::Vector2d> approx_vec(0);
+	for(unsigned int i = 0; i < 300; i++)
+		approx_vec.push_back(Eigen::Vector2d((double)i*0.01,0.0));
+	for(unsigned int i = 1; i <= 100; i++)
+		approx_vec.push_back(Eigen::Vector2d(3.0 + 0.2*sin((double)i*M_PI/100.0),0.2 - 0.2*cos((double)i*M_PI/100.0)));
+
+	Eigen::Matrix<double,1,Eigen::Dynamic> approx_nod = algorithm::fitbspline::ComputeApproxNodeVec<2>(approx_vec);
+	mathtools::application::Bspline<2> bspline = algorithm::fitbspline::FitBsplineAdaptive<2>(approx_vec,approx_nod,degree,tolerance);
+
+	std::vector<double> residuals = algorithm::fitbspline::FitResiduals<2>(bspline,approx_vec,approx_nod);
+	BOOST_CHECK(*std::max_element(residuals.begin(),residuals.end()) <= tolerance);
+	BOOST_CHECK(bspline.getCtrl().cols() < 20);
+
+	// interior knots are denser in the turn (last quarter of the params) than on the segment
+	const Eigen::Matrix<double,1,Eigen::Dynamic> &nod_vec = bspline.getNodeVec();
+	unsigned int nb_turn = 0, nb_line = 0;
+	for(unsigned int i = degree; i < nod_vec.cols()-degree; i++)
+	{
+		if(nod_vec(0,i) > approx_nod(0,299))
+			nb_turn++;
+		else
+			nb_line++;
+	}
+	BOOST_CHECK(nb_turn > nb_line);
+
+	// adaptive conversion of a graph branch
+	std::vector<Eigen::Vector3d> br_nodes(0);
+	for(unsigned int i = 0; i < 100; i++)
+		br_nodes.push_back(Eigen::Vector3d((double)i*0.1,0.0,1.0));
+	skeleton::BranchGraphSkel2d::Ptr grbr(new skeleton::BranchGraphSkel2d(skeleton::model::Classic<2>(),br_nodes));
+	skeleton::BranchContSkel2d::Ptr contbr = algorithm::fitbspline::Graph2BsplineAdaptive(grbr,tolerance,tolerance);
+	Eigen::Vector3d center = contbr->getNode(0.5);
+	BOOST_CHECK(fabs(center(0) - 4.95) < tolerance && fabs(center(1)) < tolerance && fabs(center(2) - 1.0) < tolerance);
+
+	// the radius has its own tolerance: a small radius oscillation only needs knots under a smaller size tolerance
+	std::vector<Eigen::Vector3d> rad_nodes(0);
+	for(unsigned int i = 0; i < 200; i++)
+		rad_nodes.push_back(Eigen::Vector3d((double)i*0.05,0.0,1.0 + 0.01*sin((double)i*0.1)));
+	Eigen::Matrix<double,1,Eigen::Dynamic> rad_nod = algorithm::fitbspline::ComputeApproxNodeVec<3>(rad_nodes);
+	mathtools::application::Bspline<3> loose_bsp = algorithm::fitbspline::FitBsplineAdaptive<3>(rad_nodes,rad_nod,degree,tolerance,0.05);
+	mathtools::application::Bspline<3> tight_bsp = algorithm::fitbspline::FitBsplineAdaptive<3>(rad_nodes,rad_nod,degree,tolerance,1e-4);
+	BOOST_CHECK(loose_bsp.getCtrl().cols() == degree+1);
+	BOOST_CHECK(tight_bsp.getCtrl().cols() > degree+1);
+	std::vector<double> rad_res = algorithm::fitbspline::FitRelativeResiduals<3>(tight_bsp,rad_nodes,rad_nod,tolerance,1e-4);
+	BOOST_CHECK(*std::max_element(rad_res.begin(),rad_res.end()) <= 1.0);
+}
+
 BOOST_AUTO_TEST_CASE( ComposedSkeletonConversion )
 {
 	skeleton::GraphSkel2d::Ptr grskel(new skeleton::GraphSkel2d(skeleton::model::Classic<2>()));
@@ -412,3 +792,370 @@ BOOST_AUTO_TEST_CASE( ComposedSkeletonConversion )
 	}
 	
 }
+
+BOOST_AUTO_TEST_CASE( ParallelLambdaSearch )
+{
+	algorithm::matchskeletons::OptionsMatch optserial(algorithm::matchskeletons::OptionsMatch::ode,0.5,20.0,0.5,0.02);
+	algorithm::matchskeletons::OptionsMatch optparallel = optserial;
+	optparallel.parallel = true;
+
+	for(unsigned int nbview = 2; nbview <= 3; nbview++)
+	{
+		std::vector<skeleton::BranchContProjSkel::Ptr> projbr = projectbranch(nbview,1.0);
+		std::vector<unsigned int> indskel(nbview), ext(nbview,0);
+		for(unsigned int i = 0; i < nbview; i++)
+			indskel[i] = i;
+
+		// batches of lambdas evaluated in parallel keep the smallest successful lambda of the sequential sweep
+		skeleton::ReconstructionBranch::Ptr recserial(new skeleton::ReconstructionBranch(indskel,ext,ext));
+		skeleton::ReconstructionBranch::Ptr recparallel(new skeleton::ReconstructionBranch(indskel,ext,ext));
+		algorithm::matchskeletons::BranchMatching(recserial,projbr,optserial);
+		algorithm::matchskeletons::BranchMatching(recparallel,projbr,optparallel);
+		verifymatch(recserial,recparallel);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( BisectionLambdaSearch )
+{
+	// the smallest lambda reaching the end of these branches is inside the range
+	std::vector<skeleton::BranchContProjSkel::Ptr> projbr = projectbranch(2,2.0);
+	std::vector<unsigned int> indskel = {0,1}, ext = {0,0};
+	algorithm::matchskeletons::OptionsMatch options(algorithm::matchskeletons::OptionsMatch::ode,0.1,3.0,0.1,0.02);
+	options.lambdatol = 0.1;
+
+	// both searches find the smallest successful lambda, up to their precision
+	algorithm::matchskeletons::WarmStart wslinear, wsbisection;
+	skeleton::ReconstructionBranch::Ptr reclinear(new skeleton::ReconstructionBranch(indskel,ext,ext));
+	skeleton::ReconstructionBranch::Ptr recbisection(new skeleton::ReconstructionBranch(indskel,ext,ext));
+	algorithm::matchskeletons::BranchMatching(reclinear,projbr,wslinear,options);
+	options.lambdasearch = algorithm::matchskeletons::OptionsMatch::bisection;
+	algorithm::matchskeletons::BranchMatching(recbisection,projbr,wsbisection,options);
+
+	BOOST_REQUIRE( wslinear.lambda > options.lambdamin && wslinear.lambda < options.lambdamax );
+	BOOST_REQUIRE( wsbisection.lambda > 0.0 && wsbisection.lambda < options.lambdamax );
+	BOOST_CHECK( std::abs(wsbisection.lambda - wslinear.lambda) <= options.lambdatol + options.lambdastep );
+
+	// the match is a path to the end of the branches (within the success threshold), not the default diagonal
+	BOOST_REQUIRE( recbisection->isMatched() );
+	const std::vector<Eigen::Matrix<double,Eigen::Dynamic,1> > &match = recbisection->getMatch();
+	double offdiag = 0.0;
+	for(unsigned int i = 0; i < match.size(); i++)
+		offdiag = std::max(offdiag,std::abs(match[i](0) - match[i](1)));
+	BOOST_CHECK( match.size() != 101 || offdiag > 1e-6 );
+	BOOST_REQUIRE( match.size() >= 2 );
+	BOOST_CHECK( (match[match.size()-2] - Eigen::Vector2d::Ones()).norm() <= 2.0*options.deltat );
+
+	// a null tolerance stops at the floating point precision
+	options.lambdatol = 0.0;
+	algorithm::matchskeletons::WarmStart wsexact;
+	skeleton::ReconstructionBranch::Ptr recexact(new skeleton::ReconstructionBranch(indskel,ext,ext));
+	algorithm::matchskeletons::BranchMatching(recexact,projbr,wsexact,options);
+	BOOST_CHECK( wsexact.lambda > 0.0 && wsexact.lambda <= wsbisection.lambda );
+
+	// as in the linear search, a success on lambdamax only is not kept: the default match is the diagonal
+	for(unsigned int search = 0; search < 2; search++)
+	{
+		algorithm::matchskeletons::OptionsMatch optmax(algorithm::matchskeletons::OptionsMatch::ode,20.0,20.0,0.5,0.02);
+		optmax.lambdasearch = (algorithm::matchskeletons::OptionsMatch::enum_lambdasearch)search;
+		skeleton::ReconstructionBranch::Ptr recmax(new skeleton::ReconstructionBranch(indskel,ext,ext));
+		algorithm::matchskeletons::BranchMatching(recmax,projbr,optmax);
+		BOOST_REQUIRE( recmax->getMatch().size() == 101 );
+		for(unsigned int i = 0; i < 101; i++)
+			BOOST_CHECK( (recmax->getMatch()[i] - Eigen::Vector2d::Ones()*((double)i/100.0)).norm() < 1e-12 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( WarmStartLambdaSearch )
+{
+	// the smallest lambda reaching the end of these branches is inside the range
+	std::vector<skeleton::BranchContProjSkel::Ptr> projbr = projectbranch(2,2.0);
+	std::vector<unsigned int> indskel = {0,1}, ext = {0,0};
+	algorithm::matchskeletons::OptionsMatch options(algorithm::matchskeletons::OptionsMatch::ode,0.1,3.0,0.1,0.02);
+
+	algorithm::matchskeletons::WarmStart wscold;
+	skeleton::ReconstructionBranch::Ptr reccold(new skeleton::ReconstructionBranch(indskel,ext,ext));
+	algorithm::matchskeletons::BranchMatching(reccold,projbr,wscold,options);
+	BOOST_REQUIRE( wscold.lambda > options.lambdamin && wscold.lambda < options.lambdamax );
+	BOOST_REQUIRE( wscold.speed.size() == 1 );
+
+	// a starting lambda above the successful one goes down to the same smallest successful lambda
+	algorithm::matchskeletons::WarmStart wsabove;
+	wsabove.speed = wscold.speed;
+	wsabove.lambda = wscold.lambda + 1.0;
+	skeleton::ReconstructionBranch::Ptr recabove(new skeleton::ReconstructionBranch(indskel,ext,ext));
+	algorithm::matchskeletons::BranchMatching(recabove,projbr,wsabove,options);
+	BOOST_CHECK( std::abs(wsabove.lambda - wscold.lambda) <= options.lambdastep );
+
+	// the match is a path to the end of the branches, not the default diagonal
+	BOOST_REQUIRE( recabove->isMatched() && recabove->getMatch().size() >= 2 );
+	BOOST_CHECK( recabove->getMatch().size() != 101 || std::abs(recabove->getMatch()[50](0) - recabove->getMatch()[50](1)) > 1e-6 );
+	BOOST_CHECK( (recabove->getMatch()[recabove->getMatch().size()-2] - Eigen::Vector2d::Ones()).norm() <= 2.0*options.deltat );
+}
+
+BOOST_AUTO_TEST_CASE( WarmStartComposedMatching )
+{
+	// star skeleton with branches of different bendings, seen in two views
+	std::vector<skeleton::CompContProjSkel::Ptr> projskel(2);
+	skeleton::ReconstructionSkeleton::Ptr recskel(new skeleton::ReconstructionSkeleton());
+	for(unsigned int k = 0; k < 2; k++)
+		projskel[k] = skeleton::CompContProjSkel::Ptr(new skeleton::CompContProjSkel());
+	for(unsigned int i = 0; i < 3; i++)
+	{
+		for(unsigned int k = 0; k < 2; k++)
+			projskel[k]->addNode();
+		recskel->addNode();
+	}
+
+	std::vector<unsigned int> indskel = {0,1}, ext = {0,0};
+	for(unsigned int i = 1; i < 3; i++)
+	{
+		std::vector<skeleton::BranchContProjSkel::Ptr> projbr = projectbranch(2,1.0+(double)i);
+		for(unsigned int k = 0; k < 2; k++)
+			projskel[k]->addEdge(0,i,projbr[k]);
+		recskel->addEdge(0,i,skeleton::ReconstructionBranch(indskel,ext,ext));
+	}
+
+	// the first matching fills one warm start per edge
+	algorithm::matchskeletons::OptionsMatch options(algorithm::matchskeletons::OptionsMatch::ode,0.1,3.0,0.1,0.02);
+	std::map<unsigned int,algorithm::matchskeletons::WarmStart> warmstart;
+	algorithm::matchskeletons::ComposedMatching(recskel,projskel,warmstart,options);
+
+	std::list<unsigned int> l_edge;
+	recskel->getAllEdges(l_edge);
+	BOOST_REQUIRE( l_edge.size() == 2 && warmstart.size() == 2 );
+	std::map<unsigned int,algorithm::matchskeletons::WarmStart> firststart = warmstart;
+	std::map<unsigned int,std::vector<Eigen::Matrix<double,Eigen::Dynamic,1> > > firstmatch;
+	for(std::list<unsigned int>::iterator it = l_edge.begin(); it != l_edge.end(); it++)
+	{
+		BOOST_REQUIRE( firststart[*it].lambda > options.lambdamin && firststart[*it].lambda < options.lambdamax );
+		firstmatch[*it] = recskel->getBranch(*it)->getMatch();
+	}
+
+	// the second matching starts at the previous lambda: same match, with fewer speed optimizations
+	algorithm::matchskeletons::ComposedMatching(recskel,projskel,warmstart,options);
+	for(std::list<unsigned int>::iterator it = l_edge.begin(); it != l_edge.end(); it++)
+	{
+		BOOST_CHECK( std::abs(warmstart[*it].lambda - firststart[*it].lambda) <= options.lambdastep );
+		BOOST_CHECK( warmstart[*it].nbspeed < firststart[*it].nbspeed );
+
+		const std::vector<Eigen::Matrix<double,Eigen::Dynamic,1> > &match = recskel->getBranch(*it)->getMatch();
+		BOOST_REQUIRE( match.size() >= 2 && firstmatch[*it].size() >= 2 );
+		BOOST_CHECK( (match[match.size()-2] - Eigen::Vector2d::Ones()).norm() <= 2.0*options.deltat );
+		BOOST_CHECK( (match[match.size()/2] - firstmatch[*it][firstmatch[*it].size()/2]).norm() <= 0.1 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( ParallelBranchMatching )
+{
+	// star skeletons with branches of different bendings, seen in two views
+	std::vector<skeleton::CompContProjSkel::Ptr> projskel(2);
+	skeleton::ReconstructionSkeleton::Ptr recserial(new skeleton::ReconstructionSkeleton());
+	skeleton::ReconstructionSkeleton::Ptr recparallel(new skeleton::ReconstructionSkeleton());
+	for(unsigned int k = 0; k < 2; k++)
+		projskel[k] = skeleton::CompContProjSkel::Ptr(new skeleton::CompContProjSkel());
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		for(unsigned int k = 0; k < 2; k++)
+			projskel[k]->addNode();
+		recserial->addNode();
+		recparallel->addNode();
+	}
+
+	std::vector<unsigned int> indskel = {0,1}, ext = {0,0};
+	for(unsigned int i = 1; i < 4; i++)
+	{
+		std::vector<skeleton::BranchContProjSkel::Ptr> projbr = projectbranch(2,0.5*(double)i);
+		for(unsigned int k = 0; k < 2; k++)
+			projskel[k]->addEdge(0,i,projbr[k]);
+		recserial->addEdge(0,i,skeleton::ReconstructionBranch(indskel,ext,ext));
+		recparallel->addEdge(0,i,skeleton::ReconstructionBranch(indskel,ext,ext));
+	}
+
+	algorithm::matchskeletons::OptionsMatch options(algorithm::matchskeletons::OptionsMatch::ode,0.5,20.0,0.5,0.02);
+	algorithm::matchskeletons::ComposedMatching(recserial,projskel,options);
+	options.parallelbranches = true;
+	algorithm::matchskeletons::ComposedMatching(recparallel,projskel,options);
+
+	// each match is written on its own edge
+	std::list<unsigned int> l_edge;
+	recserial->getAllEdges(l_edge);
+	BOOST_REQUIRE( l_edge.size() == 3 );
+	for(std::list<unsigned int>::iterator it = l_edge.begin(); it != l_edge.end(); it++)
+		verifymatch(recserial->getBranch(*it),recparallel->getBranch(*it));
+}
+
+BOOST_AUTO_TEST_CASE( FrozenBranchMatching )
+{
+	// branches fitted on graph branches are frozen
+	std::vector<Eigen::Vector3d> br_nodes(0);
+	for(unsigned int i = 0; i < 50; i++)
+		br_nodes.push_back(Eigen::Vector3d((double)i*0.1,sin((double)i*0.1),1.0));
+	skeleton::BranchGraphSkel2d::Ptr grbr(new skeleton::BranchGraphSkel2d(skeleton::model::Classic<2>(),br_nodes));
+	skeleton::BranchContSkel2d::Ptr contbr = algorithm::fitbspline::Graph2Bspline(grbr);
+	BOOST_CHECK( contbr->isFrozen() );
+	BOOST_CHECK( (contbr->getNode(0.0) - br_nodes[0]).norm() < 1e-12 && (contbr->getNode(1.0) - br_nodes[49]).norm() < 1e-12 );
+
+	// the matching of frozen bspline projections is the one of the same nurbs projections
+	std::vector<skeleton::BranchContProjSkel::Ptr> nurbsbr = projectbranch(2,1.0);
+	std::vector<skeleton::BranchContProjSkel::Ptr> frozenbr = projectbranch(2,1.0,true);
+	BOOST_REQUIRE( frozenbr[0]->isFrozen() && frozenbr[1]->isFrozen() );
+
+	std::vector<unsigned int> indskel = {0,1}, ext = {0,0};
+	algorithm::matchskeletons::OptionsMatch options(algorithm::matchskeletons::OptionsMatch::ode,0.5,20.0,0.5,0.02);
+	skeleton::ReconstructionBranch::Ptr recnurbs(new skeleton::ReconstructionBranch(indskel,ext,ext));
+	skeleton::ReconstructionBranch::Ptr recfrozen(new skeleton::ReconstructionBranch(indskel,ext,ext));
+	algorithm::matchskeletons::BranchMatching(recnurbs,nurbsbr,options);
+	algorithm::matchskeletons::BranchMatching(recfrozen,frozenbr,options);
+
+	BOOST_REQUIRE( recnurbs->isMatched() && recfrozen->isMatched() );
+	BOOST_REQUIRE( recnurbs->getMatch().size() == recfrozen->getMatch().size() );
+	for(unsigned int i = 0; i < recnurbs->getMatch().size(); i++)
+		BOOST_CHECK( (recnurbs->getMatch()[i] - recfrozen->getMatch()[i]).norm() < 1e-9 );
+}
+
+BOOST_AUTO_TEST_CASE( FixedSizeOde )
+{
+	for(unsigned int nbview = 2; nbview <= 4; nbview++)
+	{
+		algorithm::matchskeletons::DataODE data = dataode(projectbranch(nbview,1.0),3.0,0.02);
+		std::vector<double> x(nbview-1,0.7), grad(0);
+
+		// two to four views are integrated by the fixed size scheme
+		double df = algorithm::matchskeletons::minFunODE(x,grad,&data);
+		BOOST_REQUIRE( data.nbhist != 0 && data.hist.rows() == 3*nbview+1 );
+
+		Eigen::Matrix<double,Eigen::Dynamic,1> v_init = Eigen::Matrix<double,Eigen::Dynamic,1>::Zero(nbview,1);
+		v_init(0) = 1.0;
+		for(unsigned int i = 0; i < x.size(); i++)
+		{
+			v_init *= cos(x[i]);
+			v_init(i+1) = sin(x[i]);
+		}
+
+		double t_tot, v_tot;
+		std::list<double> list_val;
+		std::list<Eigen::Matrix<double,Eigen::Dynamic,1> > list_pos, list_vit, list_grad;
+		double dfref = algorithm::matchskeletons::SolveODE(list_val,list_pos,list_vit,list_grad,t_tot,v_tot,data.skel,
+				Eigen::Matrix<double,Eigen::Dynamic,1>::Zero(nbview,1),v_init,data.lambda,data.deltat);
+
+		BOOST_CHECK( std::abs(df - dfref) < 1e-12 );
+		BOOST_CHECK( std::abs(data.t_tot - t_tot) < 1e-12 );
+		BOOST_CHECK( std::abs(data.v_tot - v_tot) < 1e-12 );
+		BOOST_REQUIRE( data.nbhist == list_pos.size() );
+		std::list<Eigen::Matrix<double,Eigen::Dynamic,1> >::iterator itpos = list_pos.begin(), itvit = list_vit.begin();
+		for(unsigned int i = 0; i < data.nbhist; i++, itpos++, itvit++)
+		{
+			BOOST_CHECK( (data.hist.block(0,i,nbview,1) - *itpos).norm() < 1e-12 );
+			BOOST_CHECK( (data.hist.block(nbview,i,nbview,1) - *itvit).norm() < 1e-12 );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( AdaptiveOde )
+{
+	for(unsigned int nbview = 2; nbview <= 3; nbview++)
+	{
+		std::vector<skeleton::BranchContProjSkel::Ptr> projbr = projectbranch(nbview,1.0);
+		std::vector<double> x(nbview-1,0.7), grad(0);
+
+		algorithm::matchskeletons::DataODE data = dataode(projbr,3.0,0.02,algorithm::matchskeletons::OptionsMatch::dopri);
+		double df = algorithm::matchskeletons::minFunODE(x,grad,&data);
+
+		// reference: euler integration with small steps
+		algorithm::matchskeletons::DataODE dataref = dataode(projbr,3.0,1e-4);
+		double dfref = algorithm::matchskeletons::minFunODE(x,grad,&dataref);
+
+		// exit point and cost
+		BOOST_REQUIRE( data.nbhist >= 3 );
+		BOOST_CHECK( std::abs(df - dfref) < 1e-3 );
+		BOOST_CHECK( std::abs(data.v_tot - dataref.v_tot) < 1e-3*dataref.v_tot );
+		BOOST_CHECK( (data.hist.block(0,data.nbhist-2,nbview,1) - dataref.hist.block(0,dataref.nbhist-2,nbview,1)).norm() < 1e-3 );
+
+		// the path is resampled every deltat of arc length, up to its exit point
+		for(unsigned int i = 1; i+2 < data.nbhist; i++)
+			BOOST_CHECK( std::abs((data.hist.block(0,i,nbview,1) - data.hist.block(0,i-1,nbview,1)).norm() - data.deltat) < 1e-4 );
+		BOOST_CHECK( (data.hist.block(0,data.nbhist-2,nbview,1) - data.hist.block(0,data.nbhist-3,nbview,1)).norm() < data.deltat + 1e-4 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( OdeGradient )
+{
+	for(unsigned int nbview = 2; nbview <= 5; nbview++)
+	{
+		std::vector<skeleton::BranchContProjSkel::Ptr> projbr = projectbranch(nbview,1.0);
+		for(double lambda : {0.3, 3.0})
+		{
+			algorithm::matchskeletons::DataODE data = dataode(projbr,lambda,0.01);
+			std::vector<double> x(nbview-1,0.7), grad(nbview-1), tmp(0);
+
+			// the tangent integration gives the same objective as minFunODE, and its derivatives
+			double val = algorithm::matchskeletons::minFunODEGrad(x,grad,&data);
+			BOOST_CHECK( std::abs(val - algorithm::matchskeletons::minFunODE(x,tmp,&data)) < 1e-12 );
+
+			// central differences
+			for(unsigned int i = 0; i < x.size(); i++)
+			{
+				std::vector<double> xp = x, xm = x;
+				xp[i] += 1e-5;
+				xm[i] -= 1e-5;
+				double fd = (algorithm::matchskeletons::minFunODE(xp,tmp,&data) - algorithm::matchskeletons::minFunODE(xm,tmp,&data))/2e-5;
+				BOOST_CHECK( std::abs(grad[i] - fd) < 1e-3*(1.0 + std::abs(fd)) );
+			}
+		}
+	}
+
+	// the adaptive integrator at the default tolerance has the gradient of the precisely integrated objective
+	for(unsigned int nbview = 2; nbview <= 3; nbview++)
+	{
+		std::vector<skeleton::BranchContProjSkel::Ptr> projbr = projectbranch(nbview,1.0);
+		algorithm::matchskeletons::DataODE data = dataode(projbr,3.0,0.01,algorithm::matchskeletons::OptionsMatch::dopri);
+		data.odetol = algorithm::matchskeletons::OptionsMatch().odetol;
+		std::vector<double> x(nbview-1,0.7), grad(nbview-1), tmp(0);
+
+		double val = algorithm::matchskeletons::minFunODEGrad(x,grad,&data);
+		BOOST_CHECK( std::abs(val - algorithm::matchskeletons::minFunODE(x,tmp,&data)) < 1e-12 );
+
+		// central differences of the objective integrated far below the error control
+		algorithm::matchskeletons::DataODE dataref = dataode(projbr,3.0,0.01,algorithm::matchskeletons::OptionsMatch::dopri);
+		dataref.odetol = 1e-10;
+		for(unsigned int i = 0; i < x.size(); i++)
+		{
+			std::vector<double> xp = x, xm = x;
+			xp[i] += 1e-3;
+			xm[i] -= 1e-3;
+			double fd = (algorithm::matchskeletons::minFunODE(xp,tmp,&dataref) - algorithm::matchskeletons::minFunODE(xm,tmp,&dataref))/2e-3;
+			BOOST_CHECK( std::abs(grad[i] - fd) < 1e-2*(1.0 + std::abs(fd)) );
+		}
+
+		// on the bounds of the angles, the differences are one sided
+		std::vector<double> xb(nbview-1,0.0), gradb(nbview-1);
+		xb[0] = M_PI/2.0;
+		algorithm::matchskeletons::minFunODEGrad(xb,gradb,&data);
+		for(unsigned int i = 0; i < xb.size(); i++)
+			BOOST_CHECK( std::isfinite(gradb[i]) );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( TabulatedLineField )
+{
+	for(unsigned int nbview = 2; nbview <= 3; nbview++)
+	{
+		std::vector<skeleton::BranchContProjSkel::Ptr> projbr = projectbranch(nbview,1.0);
+		std::vector<double> x(nbview-1,0.7), grad(0);
+
+		algorithm::matchskeletons::DataODE data = dataode(projbr,3.0,0.02,algorithm::matchskeletons::OptionsMatch::euler,257);
+		double df = algorithm::matchskeletons::minFunODE(x,grad,&data);
+		BOOST_REQUIRE( data.skel[0].table && data.skel[0].table->cols() == 257 );
+
+		// reference: lines evaluated on the branches
+		algorithm::matchskeletons::DataODE dataref = dataode(projbr,3.0,0.02);
+		double dfref = algorithm::matchskeletons::minFunODE(x,grad,&dataref);
+		BOOST_REQUIRE( !dataref.skel[0].table );
+
+		// the interpolated lines give the same path
+		BOOST_CHECK( std::abs(df - dfref) < 1e-6 );
+		BOOST_CHECK( std::abs(data.v_tot - dataref.v_tot) < 1e-6*(1.0 + dataref.v_tot) );
+		for(unsigned int i = 0; i < std::min(data.nbhist,dataref.nbhist); i++)
+			BOOST_CHECK( (data.hist.block(0,i,nbview,1) - dataref.hist.block(0,i,nbview,1)).norm() < 1e-6 );
+	}
+}
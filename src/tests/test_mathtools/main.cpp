@@ -27,8 +27,13 @@ SOFTWARE.
  */
 
 #include <mathtools/application/Bspline.h>
+#include <mathtools/application/Nurbs.h>
+#include <mathtools/application/PiecewisePolynomial.h>
 #include <mathtools/application/Compositor.h>
+#include <mathtools/application/AffineFun.h>
 #include <mathtools/application/LinearApp.h>
+#include <mathtools/application/Coord2Homog.h>
+#include <mathtools/application/StaticCompositor.h>
 
 #include <mathtools/vectorial/Basis.h>
 
@@ -85,6 +90,256 @@ BOOST_AUTO_TEST_CASE( BsplineTest )
 	}
 }
 
+// classical recursive definition of the bspline basis, as a reference of the span evaluation
+double RecursiveBasis(double t, unsigned int degree, unsigned int indice, const Eigen::Matrix<double,1,Eigen::Dynamic> &node)
+{
+	if(degree == 0)
+	{
+		bool after  = indice == 0 || node(0,indice-1) <= t;
+		bool before = indice == node.cols() || t < node(0,indice);
+		return after && before ? 1.0 : 0.0;
+	}
+
+	double res = 0.0;
+	if(indice == 0)
+	{
+		if(t < node(0,degree-1))
+			res += RecursiveBasis(t,degree-1,indice,node);
+	}
+	else if(node(0,indice-1) <= t && t < node(0,indice+degree-1) && node(0,indice+degree-1) != node(0,indice-1))
+		res += (t - node(0,indice-1))/(node(0,indice+degree-1) - node(0,indice-1))*RecursiveBasis(t,degree-1,indice,node);
+
+	if(indice + degree == node.cols())
+	{
+		if(node(0,indice) <= t)
+			res += RecursiveBasis(t,degree-1,indice+1,node);
+	}
+	else if(node(0,indice) <= t && t < node(0,indice+degree) && node(0,indice+degree) != node(0,indice))
+		res += (node(0,indice+degree) - t)/(node(0,indice+degree) - node(0,indice))*RecursiveBasis(t,degree-1,indice+1,node);
+
+	return res;
+}
+
+// node vector with nbspan spans, quadratically spaced, clamped at 0 and 1
+Eigen::Matrix<double,1,Eigen::Dynamic> QuadraticNodeVector(unsigned int degree, unsigned int nbspan)
+{
+	Eigen::Matrix<double,1,Eigen::Dynamic> nodevec(1,nbspan + 2*degree - 1);
+	for(unsigned int i = 0; i < nodevec.cols(); i++)
+	{
+		int k = (int)i - (int)degree + 1;
+		nodevec(0,i) = k < 0 ? 0.0 : (k > (int)nbspan ? 1.0 : (double)(k*k)/(double)(nbspan*nbspan));
+	}
+	return nodevec;
+}
+
+// control points (cos(i), sin(2i), ..., i/2), the last coordinate being i/2
+template<unsigned int Dim>
+Eigen::Matrix<double,Dim,Eigen::Dynamic> TestControlPoints(unsigned int nbctrlpt)
+{
+	Eigen::Matrix<double,Dim,Eigen::Dynamic> ctrlpt(Dim,nbctrlpt);
+	for(unsigned int i = 0; i < nbctrlpt; i++)
+		for(unsigned int d = 0; d < Dim; d++)
+			ctrlpt(d,i) = d == Dim-1 ? (double)i*0.5 : (d == 0 ? cos((double)i) : sin(2.0*i));
+	return ctrlpt;
+}
+
+// positive weights 1 + sin(3i)/2
+Eigen::Matrix<double,1,Eigen::Dynamic> TestWeights(unsigned int nbctrlpt)
+{
+	Eigen::Matrix<double,1,Eigen::Dynamic> weight(1,nbctrlpt);
+	for(unsigned int i = 0; i < nbctrlpt; i++)
+		weight(0,i) = 1.0 + 0.5*sin(3.0*i);
+	return weight;
+}
+
+BOOST_AUTO_TEST_CASE( BsplineSpanEvaluation )
+{
+	unsigned int degree = 3;
+	unsigned int nbctrlpt = 7;
+	Eigen::Matrix<double,1,Eigen::Dynamic> nodevec(1,nbctrlpt + degree - 1);
+	nodevec << 0.0, 0.0, 0.0, 0.25, 0.5, 0.5, 1.0, 1.0, 1.0;
+	Eigen::Matrix<double,3,Eigen::Dynamic> ctrlpt(3,nbctrlpt);
+	ctrlpt << 0.0, 1.0, 1.0, 0.0, -1.0, 2.0, 0.5,
+			  0.0, 0.0, 1.0, 1.0,  3.0, 1.0, 0.0,
+			  0.0, 0.5, 0.0, 2.0,  0.0, 1.0, 1.0;
+	Bspline<3> bsp(ctrlpt,nodevec,degree);
+	
+	for(unsigned int i = 0; i < 101; i++)
+	{
+		double t = (double)i*0.01;
+
+		// non null basis functions are the ones of the span, equal to the recursive definition
+		Eigen::Matrix<double,1,Eigen::Dynamic> basis;
+		int first = (int)BsplineBasisSpan(t,degree,nodevec,basis) - (int)degree;
+		BOOST_CHECK(fabs(basis.sum() - 1.0) < 1e-12);
+		Eigen::Vector3d vecrec = Eigen::Vector3d::Zero();
+		for(unsigned int ind = 0; ind < nbctrlpt; ind++)
+		{
+			double ref = RecursiveBasis(t,degree,ind,nodevec);
+			double span = (int)ind >= first && (int)ind <= first + (int)degree ? basis(0,ind-first) : 0.0;
+			BOOST_CHECK(fabs(span - ref) < 1e-14);
+			BOOST_CHECK(fabs(BsplineBasis(t,degree,ind,nodevec) - ref) < 1e-14);
+			vecrec += ctrlpt.col(ind)*ref;
+		}
+
+		// all derivatives at once
+		Eigen::Matrix<double,3,Eigen::Dynamic> ders;
+		BsplineDerivatives<3>(t,degree,nodevec,ctrlpt,3,ders);
+
+		Eigen::Vector3d vecref = bsp(t);
+		Eigen::Vector3d dvecref = Eigen::Map<Eigen::Vector3d>((double*)bsp.der(t).data());
+		Eigen::Vector3d ddvecref = Eigen::Map<Eigen::Vector3d>((double*)bsp.der2(t).data());
+
+		BOOST_REQUIRE(ders.cols() == 4);
+		BOOST_CHECK( (ders.col(0)-vecrec).norm() < 1e-12 );
+		BOOST_CHECK( (ders.col(0)-vecref).norm() < 1e-12 );
+		BOOST_CHECK( (ders.col(1)-dvecref).norm() < 1e-12*(1.0+dvecref.norm()) );
+		BOOST_CHECK( (ders.col(2)-ddvecref).norm() < 1e-12*(1.0+ddvecref.norm()) );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( BatchEvaluation )
+{
+	unsigned int degree = 3;
+	unsigned int nbctrlpt = 6;
+	Eigen::Matrix<double,1,Eigen::Dynamic> nodevec(1,nbctrlpt + degree - 1);
+	nodevec << 0.0, 0.0, 0.0, 0.3, 0.6, 1.0, 1.0, 1.0;
+	Eigen::Matrix<double,2,Eigen::Dynamic> ctrlpt(2,nbctrlpt);
+	ctrlpt << 0.0, 1.0, 1.0, 0.0, 2.0, 3.0,
+			  0.0, 0.0, 1.0, 1.0, 2.0, 0.0;
+	Eigen::Matrix<double,1,Eigen::Dynamic> weight(1,nbctrlpt);
+	weight << 1.0, 0.5, 2.0, 1.0, 1.5, 1.0;
+	Bspline<2> bsp(ctrlpt,nodevec,degree);
+	Nurbs<2> nurbs(ctrlpt,weight,nodevec,degree);
+
+	// sorted parameters, then a shuffled one
+	std::vector<double> vec_t(0);
+	for(unsigned int i = 0; i <= 50; i++)
+		vec_t.push_back((double)i*0.02);
+	vec_t.push_back(0.45);
+	vec_t.push_back(0.0);
+
+	Eigen::Matrix<double,2,Eigen::Dynamic> val, dval, d2val, nval, ndval, nd2val;
+	bsp.evaluate(vec_t,val,dval,d2val);
+	nurbs.evaluate(vec_t,nval,ndval,nd2val);
+
+	BOOST_REQUIRE(val.cols() == (Eigen::Index)vec_t.size() && nval.cols() == (Eigen::Index)vec_t.size());
+	for(unsigned int i = 0; i < vec_t.size(); i++)
+	{
+		double t = vec_t[i];
+		BOOST_CHECK( (val.col(i) - bsp(t)).norm() < 1e-12 );
+		BOOST_CHECK( (dval.col(i) - Eigen::Map<Eigen::Vector2d>((double*)bsp.der(t).data())).norm() < 1e-12 );
+		BOOST_CHECK( (d2val.col(i) - Eigen::Map<Eigen::Vector2d>((double*)bsp.der2(t).data())).norm() < 1e-12 );
+		BOOST_CHECK( (nval.col(i) - nurbs(t)).norm() < 1e-12 );
+		BOOST_CHECK( (ndval.col(i) - Eigen::Map<Eigen::Vector2d>((double*)nurbs.der(t).data())).norm() < 1e-12 );
+		BOOST_CHECK( (nd2val.col(i) - Eigen::Map<Eigen::Vector2d>((double*)nurbs.der2(t).data())).norm() < 1e-12 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( DegreeKernels )
+{
+	// fixed size kernels (degrees 1 to 5) and generic one (degrees 6 and 7) against the basis functions
+	for(unsigned int degree = 1; degree <= 7; degree++)
+	{
+		unsigned int nbctrlpt = degree + 6;
+		Eigen::Matrix<double,1,Eigen::Dynamic> nodevec = QuadraticNodeVector(degree,6);
+		Eigen::Matrix<double,3,Eigen::Dynamic> ctrlpt = TestControlPoints<3>(nbctrlpt);
+		Eigen::Matrix<double,1,Eigen::Dynamic> weight = Eigen::Matrix<double,1,Eigen::Dynamic>::Ones(1,nbctrlpt);
+		Bspline<3> bsp(ctrlpt,nodevec,degree);
+		Nurbs<3> nurbs(ctrlpt,weight,nodevec,degree);
+
+		std::vector<double> vec_t(0);
+		for(unsigned int i = 0; i <= 100; i++)
+			vec_t.push_back((double)i*0.01);
+
+		Eigen::Matrix<double,3,Eigen::Dynamic> val;
+		BsplineEvalBatch<3>(vec_t,degree,nodevec,ctrlpt,val);
+		Eigen::Matrix<double,3,Eigen::Dynamic> valnurbs;
+		nurbs.evaluate(vec_t,valnurbs);
+
+		for(unsigned int i = 0; i < vec_t.size(); i++)
+		{
+			Eigen::Vector3d ref = Eigen::Vector3d::Zero();
+			for(unsigned int ind = 0; ind < nbctrlpt; ind++)
+				ref += ctrlpt.col(ind)*BsplineBasis(vec_t[i],degree,ind,nodevec);
+
+			BOOST_CHECK( (BsplineEval<3>(vec_t[i],degree,nodevec,ctrlpt)-ref).norm() < 1e-12 );
+			BOOST_CHECK( (val.col(i)-ref).norm() < 1e-12 );
+			BOOST_CHECK( (valnurbs.col(i)-ref).norm() < 1e-12 );
+			BOOST_CHECK( (bsp(vec_t[i])-ref).norm() < 1e-12 );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( NurbsFusedEvaluation )
+{
+	// fused evaluation against the quotient rule on the homogeneous bspline
+	for(unsigned int degree = 1; degree <= 6; degree++)
+	{
+		unsigned int nbctrlpt = degree + 5;
+		Eigen::Matrix<double,1,Eigen::Dynamic> nodevec = QuadraticNodeVector(degree,5);
+		Eigen::Matrix<double,2,Eigen::Dynamic> ctrlpt = TestControlPoints<2>(nbctrlpt);
+		Eigen::Matrix<double,1,Eigen::Dynamic> weight = TestWeights(nbctrlpt);
+		Eigen::Matrix<double,3,Eigen::Dynamic> homctrl(3,nbctrlpt);
+		for(unsigned int i = 0; i < nbctrlpt; i++)
+			homctrl.col(i) << ctrlpt.col(i)*weight(0,i), weight(0,i);
+		Nurbs<2> nurbs(ctrlpt,weight,nodevec,degree);
+		Bspline<3> hom(homctrl,nodevec,degree);
+
+		for(unsigned int i = 0; i <= 100; i++)
+		{
+			double t = (double)i*0.01;
+			Eigen::Vector3d h = hom(t);
+			Eigen::Vector3d dh = Eigen::Map<Eigen::Vector3d>((double*)hom.der(t).data());
+			Eigen::Vector3d d2h = Eigen::Map<Eigen::Vector3d>((double*)hom.der2(t).data());
+
+			Eigen::Vector2d ref = h.block<2,1>(0,0)/h(2);
+			Eigen::Vector2d dref = (dh.block<2,1>(0,0) - ref*dh(2))/h(2);
+			Eigen::Vector2d d2ref = (d2h.block<2,1>(0,0) - 2.0*dref*dh(2) - ref*d2h(2))/h(2);
+
+			Eigen::Vector2d val, dval, d2val;
+			nurbs.evaluate(t,val,dval,d2val);
+			BOOST_CHECK( (val - ref).norm() < 1e-12 );
+			BOOST_CHECK( (dval - dref).norm() < 1e-10*(1.0+dref.norm()) );
+			BOOST_CHECK( (d2val - d2ref).norm() < 1e-9*(1.0+d2ref.norm()) );
+			BOOST_CHECK( (nurbs(t) - ref).norm() < 1e-12 );
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( PiecewisePolynomialConversion )
+{
+	for(unsigned int degree = 1; degree <= 5; degree++)
+	{
+		unsigned int nbctrlpt = degree + 5;
+		Eigen::Matrix<double,1,Eigen::Dynamic> nodevec = QuadraticNodeVector(degree,5);
+		Eigen::Matrix<double,2,Eigen::Dynamic> ctrlpt = TestControlPoints<2>(nbctrlpt);
+		Bspline<2>::Ptr bsp(new Bspline<2>(ctrlpt,nodevec,degree));
+		PiecewisePolynomial<2> poly(bsp);
+		BOOST_CHECK(poly.getNbSpans() == 5);
+
+		std::vector<double> vec_t(0);
+		for(unsigned int i = 0; i <= 100; i++)
+			vec_t.push_back((double)i*0.01);
+
+		Eigen::Matrix<double,2,Eigen::Dynamic> val, dval, d2val;
+		poly.evaluate(vec_t,val,dval,d2val);
+
+		for(unsigned int i = 0; i < vec_t.size(); i++)
+		{
+			Eigen::Vector2d ref = (*bsp)(vec_t[i]);
+			Eigen::Vector2d dref = Eigen::Map<Eigen::Vector2d>((double*)bsp->der(vec_t[i]).data());
+			Eigen::Vector2d d2ref = Eigen::Map<Eigen::Vector2d>((double*)bsp->der2(vec_t[i]).data());
+
+			BOOST_CHECK( (poly(vec_t[i]) - ref).norm() < 1e-12 );
+			BOOST_CHECK( (val.col(i) - ref).norm() < 1e-12 );
+			BOOST_CHECK( (dval.col(i) - dref).norm() < 1e-10*(1.0+dref.norm()) );
+			BOOST_CHECK( (d2val.col(i) - d2ref).norm() < 1e-9*(1.0+d2ref.norm()) );
+			BOOST_CHECK( (Eigen::Map<Eigen::Vector2d>((double*)poly.der(vec_t[i]).data()) - dref).norm() < 1e-10*(1.0+dref.norm()) );
+		}
+	}
+}
+
 BOOST_AUTO_TEST_CASE( CompositorTest )
 {
 	Eigen::Matrix3d mat_lin;
@@ -120,6 +375,98 @@ BOOST_AUTO_TEST_CASE( CompositorTest )
 	}
 }
 
+BOOST_AUTO_TEST_CASE( StaticCompositorTest )
+{
+	Eigen::Matrix<double,8,4> mat;
+	for(unsigned int i = 0; i < 8; i++)
+		for(unsigned int j = 0; j < 4; j++)
+			mat(i,j) = cos((double)(4*i+j));
+
+	LinearApp<8,4> linapp(mat);
+	Coord2Homog<3> homog;
+	Compositor<LinearApp<8,4>,Coord2Homog<3> > comp(linapp,homog);
+	StaticCompositor<LinearApp<8,4>,Coord2Homog<3> > statcomp(linapp,homog);
+
+	for(unsigned int i = 0; i < 10; i++)
+	{
+		Eigen::Vector3d vec((double)i, sin((double)i), -0.5*(double)i);
+
+		Eigen::Matrix<double,8,1> val;
+		Eigen::Matrix<double,8,3> jac;
+		statcomp.eval(vec,val,jac);
+
+		BOOST_CHECK( (statcomp(vec) - comp(vec)).norm() < 1e-12 );
+		BOOST_CHECK( (val - comp(vec)).norm() < 1e-12 );
+		BOOST_CHECK( (jac - comp.jac(vec)).norm() < 1e-12 );
+		BOOST_CHECK( (statcomp.jac(vec) - comp.jac(vec)).norm() < 1e-12 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( JetTest )
+{
+	Eigen::Matrix3d mat_lin;
+	mat_lin <<  0.0, 2.0, 0.5,
+			   -1.0, 0.0, 0.0,
+			    0.0, 1.0, 3.0;
+	unsigned int degree = 3;
+	unsigned int nbctrlpt = degree + 5;
+	Eigen::Matrix<double,1,Eigen::Dynamic> nodevec = QuadraticNodeVector(degree,5);
+	Eigen::Matrix<double,3,Eigen::Dynamic> ctrlpt = TestControlPoints<3>(nbctrlpt);
+	Eigen::Matrix<double,1,Eigen::Dynamic> weight = TestWeights(nbctrlpt);
+	Bspline<3> bsp(ctrlpt,nodevec,degree);
+	Nurbs<3> nurbs(ctrlpt,weight,nodevec,degree);
+	LinearApp<3,3> linapp(mat_lin);
+	AffineFun rev(-1.0,1.0);
+	Compositor<LinearApp<3,3>,Bspline<3>,AffineFun> compbsp(linapp,bsp,rev);
+	Compositor<LinearApp<3,3>,Nurbs<3>,AffineFun> compnurbs(linapp,nurbs,rev);
+
+	std::vector<double> vec_t(0);
+	for(unsigned int i = 0; i <= 100; i++)
+		vec_t.push_back((double)i*0.01);
+
+	Eigen::Matrix<double,3,Eigen::Dynamic> val, dval, d2val, val1, dval1;
+	compnurbs.evaluate(vec_t,val,dval,d2val);
+	compnurbs.evaluate(vec_t,val1,dval1);
+
+	for(unsigned int i = 0; i < vec_t.size(); i++)
+	{
+		double t = vec_t[i];
+		Eigen::Vector3d vec, dvec, d2vec;
+		derivativematrix<1,3,1>::type dvecarr;
+		derivativematrix<2,3,1>::type d2vecarr;
+
+		// reference: derivatives of each function, by the chain rule
+		Eigen::Vector3d vecref = mat_lin * bsp(1.0-t);
+		Eigen::Vector3d dvecref = -mat_lin * Eigen::Map<Eigen::Vector3d>((double*)bsp.der(1.0-t).data());
+		Eigen::Vector3d d2vecref = mat_lin * Eigen::Map<Eigen::Vector3d>((double*)bsp.der2(1.0-t).data());
+
+		compbsp.jet(t,vec,dvecarr,d2vecarr);
+		dvec = Eigen::Map<Eigen::Vector3d>((double*)dvecarr.data());
+		d2vec = Eigen::Map<Eigen::Vector3d>((double*)d2vecarr.data());
+		BOOST_CHECK( (vec - vecref).norm() < 1e-12 );
+		BOOST_CHECK( (dvec - dvecref).norm() < 1e-10*(1.0+dvecref.norm()) );
+		BOOST_CHECK( (d2vec - d2vecref).norm() < 1e-9*(1.0+d2vecref.norm()) );
+
+		vecref = mat_lin * nurbs(1.0-t);
+		dvecref = -mat_lin * Eigen::Map<Eigen::Vector3d>((double*)nurbs.der(1.0-t).data());
+		d2vecref = mat_lin * Eigen::Map<Eigen::Vector3d>((double*)nurbs.der2(1.0-t).data());
+
+		compnurbs.jet(t,vec,dvecarr,d2vecarr);
+		dvec = Eigen::Map<Eigen::Vector3d>((double*)dvecarr.data());
+		d2vec = Eigen::Map<Eigen::Vector3d>((double*)d2vecarr.data());
+		BOOST_CHECK( (vec - vecref).norm() < 1e-12 );
+		BOOST_CHECK( (dvec - dvecref).norm() < 1e-10*(1.0+dvecref.norm()) );
+		BOOST_CHECK( (d2vec - d2vecref).norm() < 1e-9*(1.0+d2vecref.norm()) );
+
+		// batch evaluation
+		BOOST_CHECK( (val.col(i) - vecref).norm() < 1e-12 );
+		BOOST_CHECK( (dval.col(i) - dvecref).norm() < 1e-10*(1.0+dvecref.norm()) );
+		BOOST_CHECK( (d2val.col(i) - d2vecref).norm() < 1e-9*(1.0+d2vecref.norm()) );
+		BOOST_CHECK( (val1.col(i) - vecref).norm() < 1e-12 );
+		BOOST_CHECK( (dval1.col(i) - dvecref).norm() < 1e-10*(1.0+dvecref.norm()) );
+	}
+}
+
 BOOST_AUTO_TEST_CASE( BasisTest )
 {
 	// matrix inversion test
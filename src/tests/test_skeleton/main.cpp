@@ -28,6 +28,9 @@ SOFTWARE.
 
 #include <skeleton/GraphCurveSkeleton.h>
 #include <skeleton/model/Classic.h>
+#include <skeleton/ContinuousBranch.h>
+#include <mathtools/application/Bspline.h>
+#include <mathtools/application/Nurbs.h>
 #include <mathtools/geometry/euclidian/HyperSphere.h>
 
 using namespace mathtools::affine;
@@ -40,6 +43,7 @@ using namespace mathtools::geometry::euclidian;
 #endif
 #define BOOST_TEST_MODULE TestMathtools
 #include <boost/test/unit_test.hpp>
+#include <random>
 
 skeleton::GraphCurveSkeleton<skeleton::model::Classic<2> >::Ptr skel = skeleton::GraphCurveSkeleton<skeleton::model::Classic<2> >::Ptr();
 Frame<2>::Ptr frame = Frame<2>::Ptr();
@@ -47,6 +51,19 @@ skeleton::model::Classic<2>::Ptr modclass = skeleton::model::Classic<2>::Ptr();
 unsigned int ind1 = 0;
 unsigned int ind2 = 0;
 
+// cubic bspline with a double inner node (only C1 at 0.3)
+mathtools::application::Bspline<3>::Ptr TestBspline()
+{
+	unsigned int degree = 3;
+	Eigen::Matrix<double,1,Eigen::Dynamic> nodevec(1,8);
+	nodevec << 0.0, 0.0, 0.0, 0.3, 0.3, 1.0, 1.0, 1.0;
+	Eigen::Matrix<double,3,Eigen::Dynamic> ctrlpt(3,6);
+	ctrlpt << 0.0, 1.0, 2.0, 3.0, 3.0, 2.0,
+			  0.0, 1.0, 0.0, 1.0, 2.0, 4.0,
+			  1.0, 0.5, 0.5, 1.0, 1.5, 1.0;
+	return mathtools::application::Bspline<3>::Ptr(new mathtools::application::Bspline<3>(ctrlpt,nodevec,degree));
+}
+
 BOOST_AUTO_TEST_CASE( SkeletonCreation )
 {
 	// frame creation
@@ -149,3 +166,245 @@ BOOST_AUTO_TEST_CASE( remNode )
 	catch(...)
 	{}
 }
+
+BOOST_AUTO_TEST_CASE( ContinuousBranchEvaluation )
+{
+	unsigned int degree = 3;
+	Eigen::Matrix<double,1,Eigen::Dynamic> nodevec(1,7);
+	nodevec << 0.0, 0.0, 0.0, 0.5, 1.0, 1.0, 1.0;
+	Eigen::Matrix<double,3,Eigen::Dynamic> ctrlpt(3,5);
+	ctrlpt << 0.0, 1.0, 2.0, 3.0, 3.0,
+			  0.0, 1.0, 0.0, 1.0, 2.0,
+			  1.0, 0.5, 0.5, 1.0, 1.5;
+	mathtools::application::Bspline<3>::Ptr bspline(new mathtools::application::Bspline<3>(ctrlpt,nodevec,degree));
+	skeleton::ContinuousBranch<skeleton::model::Classic<2> > contbr(modclass,bspline);
+	skeleton::ContinuousBranch<skeleton::model::Classic<2> >::Ptr revbr = contbr.reverted();
+
+	std::vector<double> vec_t(21);
+	for(unsigned int i = 0; i < vec_t.size(); i++)
+		vec_t[i] = (double)i/20.0;
+
+	Eigen::Matrix<double,3,Eigen::Dynamic> nodes, dnodes, d2nodes, revnodes, revdnodes;
+	contbr.evaluate(vec_t,nodes,dnodes,d2nodes);
+	revbr->evaluate(vec_t,revnodes,revdnodes);
+
+	BOOST_REQUIRE(nodes.cols() == (Eigen::Index)vec_t.size() && revnodes.cols() == (Eigen::Index)vec_t.size());
+	for(unsigned int i = 0; i < vec_t.size(); i++)
+	{
+		BOOST_CHECK( (nodes.col(i) - contbr.getNode(vec_t[i])).norm() < 1e-12 );
+		BOOST_CHECK( (dnodes.col(i) - Eigen::Map<Eigen::Vector3d>((double*)bspline->der(vec_t[i]).data())).norm() < 1e-12 );
+		BOOST_CHECK( (d2nodes.col(i) - Eigen::Map<Eigen::Vector3d>((double*)bspline->der2(vec_t[i]).data())).norm() < 1e-12 );
+		BOOST_CHECK( (revnodes.col(i) - revbr->getNode(vec_t[i])).norm() < 1e-12 );
+		BOOST_CHECK( (revdnodes.col(i) + dnodes.col(vec_t.size()-1-i)).norm() < 1e-12 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( FrozenBranch )
+{
+	mathtools::application::Bspline<3>::Ptr bspline = TestBspline();
+	skeleton::ContinuousBranch<skeleton::model::Classic<2> > contbr(modclass,bspline);
+	skeleton::ContinuousBranch<skeleton::model::Classic<2> > frozenbr(contbr);
+	skeleton::ContinuousBranch<skeleton::model::Classic<2> >::Ptr revbr = contbr.reverted();
+
+	BOOST_CHECK(!frozenbr.isFrozen());
+	BOOST_REQUIRE(frozenbr.freeze());
+	BOOST_CHECK(!contbr.isFrozen());
+	BOOST_REQUIRE(revbr->freeze());
+
+	std::vector<double> vec_t(41);
+	for(unsigned int i = 0; i < vec_t.size(); i++)
+		vec_t[i] = (double)i/40.0;
+
+	Eigen::Matrix<double,3,Eigen::Dynamic> nodes, dnodes, d2nodes, frnodes, frdnodes, frd2nodes, revnodes;
+	contbr.evaluate(vec_t,nodes,dnodes,d2nodes);
+	frozenbr.evaluate(vec_t,frnodes,frdnodes,frd2nodes);
+	revbr->evaluate(vec_t,revnodes);
+
+	for(unsigned int i = 0; i < vec_t.size(); i++)
+	{
+		BOOST_CHECK( (frnodes.col(i) - nodes.col(i)).norm() < 1e-12 );
+		BOOST_CHECK( (frdnodes.col(i) - dnodes.col(i)).norm() < 1e-10 );
+		BOOST_CHECK( (frd2nodes.col(i) - d2nodes.col(i)).norm() < 1e-9 );
+		BOOST_CHECK( (frozenbr.getNode(vec_t[i]) - nodes.col(i)).norm() < 1e-12 );
+		BOOST_CHECK( (revnodes.col(i) - nodes.col(vec_t.size()-1-i)).norm() < 1e-12 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( ArcLengthTable )
+{
+	// straight centers, with a non uniform speed: the arc length is the abscissa
+	unsigned int degree = 3;
+	Eigen::Matrix<double,1,Eigen::Dynamic> nodevec(1,6);
+	nodevec << 0.0, 0.0, 0.0, 1.0, 1.0, 1.0;
+	Eigen::Matrix<double,3,Eigen::Dynamic> ctrlpt(3,4);
+	ctrlpt << 0.0, 0.1, 0.2, 3.0,
+			  1.0, 1.0, 1.0, 1.0,
+			  1.0, 0.5, 2.0, 1.0;
+	mathtools::application::Bspline<3>::Ptr bspline(new mathtools::application::Bspline<3>(ctrlpt,nodevec,degree));
+	skeleton::ContinuousBranch<skeleton::model::Classic<2> > contbr(modclass,bspline);
+
+	BOOST_CHECK(!contbr.hasArcLength());
+	BOOST_CHECK_THROW(contbr.getLength(),std::logic_error);
+
+	// sampling along the branch without table leaves the branch unchanged
+	std::vector<double> vec_s(0);
+	contbr.getSampling(31,true,vec_s);
+	BOOST_CHECK(!contbr.hasArcLength());
+	BOOST_REQUIRE(vec_s.size() == 31);
+	for(unsigned int i = 0; i < vec_s.size(); i++)
+		BOOST_CHECK(std::abs(contbr.getNode(vec_s[i])(0) - 0.1*(double)i) < 1e-8);
+
+	contbr.computeArcLength();
+	BOOST_REQUIRE(contbr.hasArcLength());
+	BOOST_CHECK(std::abs(contbr.getLength() - 3.0) < 1e-10);
+
+	for(unsigned int i = 0; i <= 40; i++)
+	{
+		double t = (double)i/40.0;
+		BOOST_CHECK(std::abs(contbr.getArcLength(t) - contbr.getNode(t)(0)) < 1e-8);
+		BOOST_CHECK(std::abs(contbr.getArcParam(contbr.getArcLength(t)) - t) < 1e-8);
+	}
+
+	std::vector<double> vec_t(0);
+	contbr.getArcSampling(31,vec_t);
+	BOOST_REQUIRE(vec_t.size() == 31);
+	for(unsigned int i = 0; i < vec_t.size(); i++)
+		BOOST_CHECK(std::abs(contbr.getNode(vec_t[i])(0) - 0.1*(double)i) < 1e-8);
+
+	// the reverted branch runs the same centers backwards
+	skeleton::ContinuousBranch<skeleton::model::Classic<2> >::Ptr revbr = contbr.reverted();
+	revbr->computeArcLength();
+	BOOST_CHECK(std::abs(revbr->getLength() - 3.0) < 1e-10);
+	BOOST_CHECK(std::abs(revbr->getArcLength(0.25) - (3.0 - contbr.getArcLength(0.75))) < 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE( ClosestCenter )
+{
+	mathtools::application::Bspline<3>::Ptr bspline = TestBspline();
+	skeleton::ContinuousBranch<skeleton::model::Classic<2> > contbr(modclass,bspline);
+
+	Eigen::Vector2d pt(0.0,0.0);
+	double dist, size;
+	BOOST_CHECK_THROW(contbr.getClosestParam(pt,dist,size),std::logic_error);
+	contbr.computeClosestHierarchy(16);
+	BOOST_REQUIRE(contbr.hasClosestHierarchy());
+
+	// brute force reference
+	std::vector<double> vec_t(20001);
+	for(unsigned int i = 0; i < vec_t.size(); i++)
+		vec_t[i] = (double)i/20000.0;
+	Eigen::Matrix<double,3,Eigen::Dynamic> nodes;
+	contbr.evaluate(vec_t,nodes);
+
+	for(int x = -2; x <= 10; x++)
+	{
+		for(int y = -2; y <= 10; y++)
+		{
+			pt << 0.5*(double)x, 0.5*(double)y;
+			double t = contbr.getClosestParam(pt,dist,size);
+
+			double distref = (nodes.block<2,1>(0,0) - pt).norm();
+			for(unsigned int i = 1; i < vec_t.size(); i++)
+				distref = std::min(distref,(nodes.block<2,1>(0,i) - pt).norm());
+
+			Eigen::Vector3d node = contbr.getNode(t);
+			BOOST_CHECK( t >= 0.0 && t <= 1.0 );
+			BOOST_CHECK( std::abs((node.block<2,1>(0,0) - pt).norm() - dist) < 1e-12 );
+			BOOST_CHECK( std::abs(node(2) - size) < 1e-12 );
+			BOOST_CHECK( dist <= distref + 1e-12 );
+			BOOST_CHECK( distref - dist < 1e-6 );
+		}
+	}
+}
+
+// checks closest center queries against a brute force search
+void CheckClosest(skeleton::ContinuousBranch<skeleton::model::Classic<2> > &contbr, std::mt19937 &gen)
+{
+	contbr.computeClosestHierarchy(4);
+
+	std::vector<double> vec_t(40001);
+	for(unsigned int i = 0; i < vec_t.size(); i++)
+		vec_t[i] = (double)i/40000.0;
+	Eigen::Matrix<double,3,Eigen::Dynamic> nodes;
+	contbr.evaluate(vec_t,nodes);
+
+	std::uniform_real_distribution<double> coord(-1.0,5.0);
+	for(unsigned int p = 0; p < 30; p++)
+	{
+		Eigen::Vector2d pt(coord(gen),coord(gen));
+		double dist, size;
+		double t = contbr.getClosestParam(pt,dist,size);
+
+		unsigned int best = 0;
+		for(unsigned int i = 1; i < vec_t.size(); i++)
+			if((nodes.block<2,1>(0,i) - pt).norm() < (nodes.block<2,1>(0,best) - pt).norm())
+				best = i;
+
+		// ternary search around the closest sample
+		double tinf = vec_t[best == 0 ? 0 : best-1];
+		double tsup = vec_t[best+1 == vec_t.size() ? best : best+1];
+		for(unsigned int it = 0; it < 100; it++)
+		{
+			double t1 = (2.0*tinf + tsup)/3.0, t2 = (tinf + 2.0*tsup)/3.0;
+			if((contbr.getNode(t1).block<2,1>(0,0) - pt).norm() < (contbr.getNode(t2).block<2,1>(0,0) - pt).norm())
+				tsup = t2;
+			else
+				tinf = t1;
+		}
+		double distref = std::min((nodes.block<2,1>(0,best) - pt).norm(),(contbr.getNode(tinf).block<2,1>(0,0) - pt).norm());
+
+		BOOST_CHECK( t >= 0.0 && t <= 1.0 );
+		BOOST_CHECK( std::abs((contbr.getNode(t).block<2,1>(0,0) - pt).norm() - dist) < 1e-12 );
+		BOOST_CHECK( dist <= distref + 1e-12 );
+		BOOST_CHECK( distref - dist < 1e-6 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( ClosestCenterRandom )
+{
+	std::mt19937 gen(42);
+	std::uniform_real_distribution<double> coord(0.0,4.0);
+	std::uniform_real_distribution<double> unif(0.0,1.0);
+
+	for(unsigned int degree = 1; degree <= 5; degree++)
+	{
+		for(unsigned int s = 0; s < 6; s++)
+		{
+			// random clamped node vector, with a repeated node for some continuous splines
+			unsigned int nbctrl = degree + 1 + s;
+			Eigen::Matrix<double,1,Eigen::Dynamic> nodevec(1,nbctrl+degree-1);
+			std::vector<double> inner(nbctrl-degree-1);
+			for(unsigned int i = 0; i < inner.size(); i++)
+				inner[i] = unif(gen);
+			if(degree > 1 && inner.size() > 1 && s%2 == 0)
+				inner[1] = inner[0];
+			std::sort(inner.begin(),inner.end());
+			for(unsigned int i = 0; i < degree; i++)
+			{
+				nodevec(0,i) = 0.0;
+				nodevec(0,nodevec.cols()-1-i) = 1.0;
+			}
+			for(unsigned int i = 0; i < inner.size(); i++)
+				nodevec(0,degree+i) = inner[i];
+
+			Eigen::Matrix<double,3,Eigen::Dynamic> ctrlpt(3,nbctrl);
+			Eigen::Matrix<double,1,Eigen::Dynamic> weight(1,nbctrl);
+			for(unsigned int i = 0; i < nbctrl; i++)
+			{
+				ctrlpt.col(i) << coord(gen), coord(gen), 0.1 + unif(gen);
+				weight(0,i) = 0.5 + unif(gen);
+			}
+
+			mathtools::application::Bspline<3>::Ptr bspline(new mathtools::application::Bspline<3>(ctrlpt,nodevec,degree));
+			skeleton::ContinuousBranch<skeleton::model::Classic<2> > contbr(modclass,bspline);
+			CheckClosest(contbr,gen);
+
+			// the reverted branch uses the spans backwards
+			CheckClosest(*contbr.reverted(),gen);
+
+			mathtools::application::Nurbs<3>::Ptr nurbs(new mathtools::application::Nurbs<3>(ctrlpt,weight,nodevec,degree));
+			skeleton::ContinuousBranch<skeleton::model::Classic<2> > contnurbs(modclass,nurbs);
+			CheckClosest(contnurbs,gen);
+		}
+	}
+}
@@ -0,0 +1,67 @@
+/*
+Copyright (c) 2016 Bastien Durix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/**
+ *  \file AutoSkelNode.cpp
+ *  \brief Associates skeleton nodes without user input
+ *  \author Bastien Durix
+ */
+
+#include "AutoSkelNode.h"
+
+#include <algorithm/graphoperation/AssociateExtremities.h>
+#include <fileio/ExtClickFile.h>
+#include <iostream>
+#include <stdexcept>
+
+std::vector<std::vector<unsigned int> > userinput::AutoSkelExtremities(const std::vector<skeleton::GraphProjSkel::Ptr> &vecprskel, const std::string &extskelfile)
+{
+	std::cout << "Associating extremities" << std::endl;
+	std::vector<std::vector<unsigned int> > assoc_ext(0);
+	std::vector<std::vector<double> > confidence;
+	try
+	{
+		assoc_ext = algorithm::graphoperation::AssociateExtremities(vecprskel,confidence);
+	}
+	catch(const std::logic_error &err)
+	{
+		std::cerr << err.what() << std::endl;
+	}
+	if(assoc_ext.size() == 0 || confidence.size() == 0)
+	{
+		std::cerr << "Extremities could not be associated" << std::endl;
+		return std::vector<std::vector<unsigned int> >(0);
+	}
+	
+	for(unsigned int k = 0; k < confidence[0].size(); k++)
+	{
+		double conf = 1.0;
+		for(unsigned int i = 0; i < confidence.size(); i++)
+			conf = std::min(conf,confidence[i][k]);
+		std::cout << "Extremity " << k+1 << " : confidence " << conf << std::endl;
+	}
+	
+	fileio::WriteExtSkel(assoc_ext,extskelfile);
+	
+	return assoc_ext;
+}
@@ -0,0 +1,53 @@
+/*
+Copyright (c) 2016 Bastien Durix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/**
+ *  \file AutoSkelNode.h
+ *  \brief Associates skeleton nodes without user input
+ *  \author Bastien Durix
+ */
+
+#ifndef _AUTOSKELNODE_H_
+#define _AUTOSKELNODE_H_
+
+#include <skeleton/Skeletons.h>
+
+/**
+ *  \brief User input functions
+ */
+namespace userinput
+{
+	/**
+	 *  \brief Associates the extremities of projective graph skeletons automatically, in place of clicking them
+	 *
+	 *  \details The confidence of each association is displayed, and the associated extremities are written in extskelfile
+	 *
+	 *  \param vecprskel    projective graph skeletons
+	 *  \param extskelfile  skeleton extremities filename
+	 *
+	 *  \return id of associated extremities in each skeleton (empty if the extremities could not be associated)
+	 */
+	std::vector<std::vector<unsigned int> > AutoSkelExtremities(const std::vector<skeleton::GraphProjSkel::Ptr> &vecprskel, const std::string &extskelfile);
+}
+
+#endif //_AUTOSKELNODE_H_